@@ -4,6 +4,11 @@
 #include "tastylib/internal/base.h"
 #include <vector>
 #include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <cstdint>
 
 TASTYLIB_NS_BEGIN
 
@@ -27,14 +32,26 @@ public:
     BinaryHeap(const PredCmp& cmp = PredCmp())
     : size(0), predCmp(cmp), tree(1) {}
 
-    // Build heap with a given array of values
-    explicit BinaryHeap(const Container& vals, const PredCmp& cmp = PredCmp())
+    /*
+    Build heap with a given array of values.
+
+    @param vals    The values
+    @param cmp     The comparator
+    @param threads The amount of threads that build independent subtrees
+                   of a large heap. The comparator must be safe to call
+                   from several threads at a time.
+    */
+    explicit BinaryHeap(const Container& vals, const PredCmp& cmp = PredCmp(),
+                        const SizeType threads = 1)
     : size(vals.size()), predCmp(cmp), tree(vals) {
-        tree.push_back(tree[0]);  // tree[0] has no use, index begins at 1
-        for (SizeType i = (size >> 1); i > 0; --i) {
-            Value val = tree[i];  // Make a copy
-            percolateDown(i, val);
-        }
+        build(threads);
+    }
+
+    // Build heap with a given array of values, taking over its storage
+    explicit BinaryHeap(Container&& vals, const PredCmp& cmp = PredCmp(),
+                        const SizeType threads = 1)
+    : size(vals.size()), predCmp(cmp), tree(std::move(vals)) {
+        build(threads);
     }
 
     // Return the amount of elements in the heap
@@ -52,20 +69,68 @@ public:
         size = 0;
     }
 
+    // Return the amount of elements the heap can hold without growing
+    SizeType getCapacity() const noexcept {
+        return tree.capacity() - 1;
+    }
+
+    // Make room for at least 'n' elements
+    void reserve(const SizeType n) {
+        if (tree.size() < n + 1) {
+            tree.resize(n + 1);
+        }
+    }
+
+    // Release the memory that the current elements don't use
+    void shrinkToFit() {
+        tree.resize(size + 1);
+        tree.shrink_to_fit();
+    }
+
     // Insert a new element to the heap
     void push(const Value& val) {
+        Value copy(val);
+        push(std::move(copy));
+    }
+
+    void push(Value&& val) {
         if (size + 1 == tree.size()) {  // The tree array is full
             tree.resize(tree.size() << 1);  // Expand space
         }
         // The new element percolates up in the heap
-        percolateUp(++size, val);
+        percolateUp(++size, std::move(val));
+    }
+
+    /*
+    Construct a new element and insert it to the heap.
+
+    @param args The arguments to construct the element
+    */
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        push(Value(std::forward<Args>(args)...));
+    }
+
+    /*
+    Insert a batch of elements to the heap. A large batch is appended to
+    the array, and only the ancestors of the new elements are sifted down,
+    level by level from the bottom.
+
+    @param vals The elements
+    */
+    void pushBatch(const Container& vals) {
+        insertBatch(vals.begin(), vals.size());
+    }
+
+    void pushBatch(Container&& vals) {
+        insertBatch(std::make_move_iterator(vals.begin()), vals.size());
     }
 
     /*
     Return the root element of the heap.
     Precondition: The heap is non-empty.
     */
-    Value top() const {
+    const Value& top() const noexcept {
         return tree[1];
     }
 
@@ -75,19 +140,162 @@ public:
     */
     void pop() {
         // The empty hole (root node) percolates down
-        percolateDown(1, tree[size--]);
+        Value last = std::move(tree[size--]);
+        if (size > 0) {
+            percolateDown(1, std::move(last));
+        }
+    }
+
+    /*
+    Remove the root element of the heap and return it.
+    Precondition: The heap is non-empty.
+    */
+    Value popValue() {
+        Value root = std::move(tree[1]);
+        pop();
+        return root;
+    }
+
+    /*
+    Replace the root element with a new one. It costs one percolation
+    instead of the two of pop() and push().
+    Precondition: The heap is non-empty.
+    */
+    void replaceTop(Value&& val) {
+        percolateDown(1, std::move(val));
+    }
+
+    void replaceTop(const Value& val) {
+        Value copy(val);
+        percolateDown(1, std::move(copy));
+    }
+
+    /*
+    Traverse the elements in the order of the array.
+
+    @param f The function to traverse each element. Its param is the element.
+    */
+    template<typename Func>
+    void traverse(const Func& f) const {
+        for (SizeType i = 1; i <= size; ++i) {
+            f(tree[i]);
+        }
     }
 
 private:
-    void percolateUp(const SizeType start, const Value& val) {
+    // Arrange the values stored in tree[0 .. size - 1] into a heap
+    void build(const SizeType threads) {
+        if (tree.empty()) {
+            tree.resize(1);
+            return;
+        }
+        // tree[0] has no use, index begins at 1
+        Value first = std::move(tree[0]);
+        tree.push_back(std::move(first));
+        if (threads > 1 && size >= PARALLEL_THRESHOLD) {
+            buildParallel(threads);
+        } else {
+            for (SizeType i = (size >> 1); i > 0; --i) {
+                siftDown(i);
+            }
+        }
+    }
+
+    /*
+    Build the subtrees rooted at the first level with at least 4 nodes per
+    thread on several threads, then the levels above them. The subtrees
+    share no nodes, so the threads need no locking.
+    */
+    void buildParallel(const SizeType threads) {
+        SizeType level = 1;  // The first node of the level of the subtree roots
+        while (level < threads * 4) {
+            level <<= 1;
+        }
+        const SizeType perThread = (level + threads - 1) / threads;
+        std::vector<std::thread> pool;
+        for (SizeType lo = level; lo < (level << 1); lo += perThread) {
+            const SizeType hi = lo + perThread < (level << 1) ? lo + perThread : (level << 1);
+            pool.push_back(std::thread([this, lo, hi]() {
+                buildSubtrees(lo, hi);
+            }));
+        }
+        for (auto &t : pool) {
+            t.join();
+        }
+        for (SizeType i = (level - 1 < (size >> 1) ? level - 1 : (size >> 1)); i > 0; --i) {
+            siftDown(i);
+        }
+    }
+
+    /*
+    Build the subtrees rooted at nodes lo to hi - 1 of one level. The nodes
+    of the subtrees at each level are contiguous in the array, so the
+    levels are processed from the bottom, each in one sweep.
+    */
+    void buildSubtrees(const SizeType lo, const SizeType hi) {
+        const SizeType last = size >> 1;  // The last node that has a child
+        SizeType shift = 0;
+        while ((lo << (shift + 1)) <= last) {
+            ++shift;
+        }
+        for (SizeType s = shift + 1; s > 0; --s) {
+            const SizeType begin = lo << (s - 1);
+            const SizeType end = (hi << (s - 1)) - 1 < last ? (hi << (s - 1)) - 1 : last;
+            for (SizeType i = end; i >= begin && i > 0; --i) {
+                siftDown(i);
+            }
+        }
+    }
+
+    /*
+    Append elements to the array and restore the heap order.
+
+    @param first The iterator to the first element
+    @param n     The amount of elements
+    */
+    template<typename Iter>
+    void insertBatch(Iter first, const SizeType n) {
+        SizeType depth = 0;
+        for (SizeType s = size + n; s > 1; s >>= 1) {
+            ++depth;
+        }
+        if (n < depth) {  // Sifting the ancestors costs more than pushing
+            for (SizeType i = 0; i < n; ++i, ++first) {
+                push(*first);
+            }
+            return;
+        }
+        if (tree.size() < size + n + 1) {
+            tree.resize(size + n + 1 > (tree.size() << 1) ? size + n + 1 : (tree.size() << 1));
+        }
+        for (SizeType i = 1; i <= n; ++i, ++first) {
+            tree[size + i] = *first;
+        }
+        SizeType lo = (size + 1) >> 1, hi = (size + n) >> 1;
+        size += n;
+        // The ancestors of the new nodes are contiguous at each level
+        for (; hi > 0; lo >>= 1, hi >>= 1) {
+            for (SizeType i = hi; i >= lo && i > 0; --i) {
+                siftDown(i);
+            }
+        }
+    }
+
+    // Sift a node down to its place in its subtree
+    void siftDown(const SizeType i) {
+        Value val = std::move(tree[i]);
+        percolateDown(i, std::move(val));
+    }
+
+    void percolateUp(const SizeType start, Value&& val) {
         auto i = start;
         for (; i != 1 && predCmp(val, tree[i >> 1]); i >>= 1) {
-            tree[i] = tree[i >> 1];
+            tree[i] = std::move(tree[i >> 1]);
         }
-        tree[i] = val;
+        tree[i] = std::move(val);
     }
 
-    void percolateDown(const SizeType start, const Value& val) {
+    void percolateDown(const SizeType start, Value&& val) {
         SizeType i = start, child;
         for (; (i << 1) <= size; i = child) {
             child = i << 1;
@@ -97,13 +305,16 @@ private:
             if (predCmp(val, tree[child])) {
                 break;
             } else {
-                tree[i] = tree[child];
+                tree[i] = std::move(tree[child]);
             }
         }
-        tree[i] = val;
+        tree[i] = std::move(val);
     }
 
 private:
+    // Amount of elements below which the heap is built on one thread
+    static const SizeType PARALLEL_THRESHOLD = 1 << 16;
+
     SizeType size;
     PredCmp predCmp;
 
@@ -120,6 +331,194 @@ private:
     Container tree;
 };
 
+/*
+A binary heap whose elements can be changed or removed after they are pushed.
+
+push() returns a handle of the new element, which stays valid until the
+element leaves the heap. After that the handle may be given to another
+element. A compact array maps each handle to the position of its element
+in the tree, so that decreaseKey() and erase() need no search.
+
+@param Value    The type of the value stored in the heap
+@param PredCmp  The type of the binary predicate to arrange the nodes.
+                It has the same meaning as in BinaryHeap.
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+class IndexedBinaryHeap {
+public:
+    using Handle = std::uint32_t;
+    using SizeType = std::size_t;
+
+    // Default ctor
+    IndexedBinaryHeap(const PredCmp& cmp = PredCmp())
+    : size(0), predCmp(cmp), tree(1) {}
+
+    // Return the amount of elements in the heap
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return true if the heap has no elements
+    bool isEmpty() const noexcept {
+        return size == 0;
+    }
+
+    // Clear the elements in the heap. All handles become invalid.
+    void clear() noexcept {
+        size = 0;
+        pos.clear();
+        freeHandles.clear();
+    }
+
+    /*
+    Insert a new element to the heap.
+
+    @param val The value of the element
+    @return    The handle of the element
+    */
+    Handle push(const Value& val) {
+        Handle h;
+        if (freeHandles.empty()) {
+            if (pos.size() == (SizeType)UINT32_MAX) {
+                throw std::length_error("IndexedBinaryHeap: too many elements");
+            }
+            h = (Handle)pos.size();
+            pos.push_back(0);
+        } else {
+            h = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        if (++size == tree.size()) {  // The tree array is full
+            tree.push_back(Entry());
+        }
+        percolateUp(size, Entry(val, h));
+        return h;
+    }
+
+    // Return true if a handle refers to an element in the heap
+    bool contains(const Handle h) const noexcept {
+        return h < pos.size() && pos[h] != 0;
+    }
+
+    /*
+    Return the value of an element.
+    Precondition: contains(h) == true.
+    */
+    const Value& get(const Handle h) const noexcept {
+        return tree[pos[h]].val;
+    }
+
+    /*
+    Return the root element of the heap.
+    Precondition: The heap is non-empty.
+    */
+    const Value& top() const noexcept {
+        return tree[1].val;
+    }
+
+    /*
+    Return the handle of the root element.
+    Precondition: The heap is non-empty.
+    */
+    Handle topHandle() const noexcept {
+        return tree[1].handle;
+    }
+
+    /*
+    Remove the root element of the heap and maintain the nodes order.
+    Precondition: The heap is non-empty.
+    */
+    void pop() {
+        erase(tree[1].handle);
+    }
+
+    /*
+    Move an element towards the root after its value becomes better.
+    Precondition: contains(h) == true, and 'val' is not worse than
+                  the current value of the element under PredCmp.
+
+    @param h   The handle of the element
+    @param val The new value
+    */
+    void decreaseKey(const Handle h, const Value& val) {
+        percolateUp(pos[h], Entry(val, h));
+    }
+
+    /*
+    Remove an element from the heap.
+    Precondition: contains(h) == true.
+
+    @param h The handle of the element
+    */
+    void erase(const Handle h) {
+        const SizeType i = pos[h];
+        pos[h] = 0;
+        freeHandles.push_back(h);
+        Entry last = std::move(tree[size--]);
+        if (i <= size) {
+            // The last element fills the hole from either direction
+            if (i != 1 && predCmp(last.val, tree[i >> 1].val)) {
+                percolateUp(i, std::move(last));
+            } else {
+                percolateDown(i, std::move(last));
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        Value val;
+        Handle handle;
+
+        Entry() : val(), handle(0) {}
+        Entry(const Value& v, const Handle h) : val(v), handle(h) {}
+    };
+
+    // Store an element at a given position of the tree
+    void place(const SizeType i, Entry&& e) {
+        pos[e.handle] = (std::uint32_t)i;
+        tree[i] = std::move(e);
+    }
+
+    void percolateUp(const SizeType start, Entry&& e) {
+        auto i = start;
+        for (; i != 1 && predCmp(e.val, tree[i >> 1].val); i >>= 1) {
+            place(i, std::move(tree[i >> 1]));
+        }
+        place(i, std::move(e));
+    }
+
+    void percolateDown(const SizeType start, Entry&& e) {
+        SizeType i = start, child;
+        for (; (i << 1) <= size; i = child) {
+            child = i << 1;
+            if (child != size && predCmp(tree[child + 1].val, tree[child].val)) {
+                ++child;
+            }
+            if (predCmp(e.val, tree[child].val)) {
+                break;
+            } else {
+                place(i, std::move(tree[child]));
+            }
+        }
+        place(i, std::move(e));
+    }
+
+private:
+    SizeType size;
+    PredCmp predCmp;
+
+    // The complete binary tree stored as in BinaryHeap, beginning at tree[1]
+    std::vector<Entry> tree;
+
+    // pos[h] is the position of the element whose handle is 'h' in the tree,
+    // or 0 if there is no such element. 32 bits keep the array small.
+    std::vector<std::uint32_t> pos;
+
+    // Handles of removed elements, ready for reuse
+    std::vector<Handle> freeHandles;
+};
+
 TASTYLIB_NS_END
 
 #endif
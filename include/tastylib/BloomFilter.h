@@ -0,0 +1,274 @@
+#ifndef TASTYLIB_BLOOMFILTER_H_
+#define TASTYLIB_BLOOMFILTER_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/hash.h"
+#include "tastylib/internal/AlignedAllocator.h"
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A blocked Bloom filter. It answers whether a value may have been inserted,
+with no false negatives and a small rate of false positives.
+
+The bits are split into blocks of 256 bits (eight 32-bit words), and all
+bits of a value lie in one block, so a query touches one cache line. Each
+word of the block holds one bit of the value, chosen by multiplying the
+hash value with a per-word odd constant. The eight words are processed the
+same way without branches, which compilers turn into SIMD instructions.
+
+@param Value The type of the values.
+@param Hash  A unary functor that computes the hash value of a value.
+*/
+template<typename Value, typename Hash = std::hash<Value>>
+class BloomFilter {
+public:
+    using SizeType = std::size_t;
+
+    static const SizeType DEFAULT_BITS_PER_KEY = 10;
+
+    /*
+    Initialize the filter.
+
+    @param n          Expected amount of values
+    @param bitsPerKey Bits of the filter per expected value. More bits give
+                      fewer false positives. About 10 bits give 1%.
+    @param h          The hash function
+    */
+    explicit BloomFilter(const SizeType n = 0,
+                         const SizeType bitsPerKey = DEFAULT_BITS_PER_KEY,
+                         const Hash& h = Hash())
+    : blockNum((n * bitsPerKey + BLOCK_BITS - 1) / BLOCK_BITS), hasher(h) {
+        if (blockNum == 0) {
+            blockNum = 1;
+        }
+        words = alloc.allocate(blockNum * WORDS);
+        clear();
+    }
+
+    // Forbid copy
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    // Move ctor. The moved-from filter has no blocks and may only be assigned or destroyed.
+    BloomFilter(BloomFilter&& other) noexcept
+    : blockNum(other.blockNum), hasher(std::move(other.hasher)), words(other.words) {
+        other.blockNum = 0;
+        other.words = nullptr;
+    }
+
+    // Move assignment
+    BloomFilter& operator=(BloomFilter&& other) noexcept {
+        if (this != &other) {
+            alloc.deallocate(words, blockNum * WORDS);
+            blockNum = other.blockNum;
+            hasher = std::move(other.hasher);
+            words = other.words;
+            other.blockNum = 0;
+            other.words = nullptr;
+        }
+        return *this;
+    }
+
+    // Dtor
+    ~BloomFilter() noexcept {
+        alloc.deallocate(words, blockNum * WORDS);
+    }
+
+    // Add a value to the filter
+    void insert(const Value& val) noexcept {
+        const std::uint64_t h = mixHash((std::uint64_t)hasher(val));
+        std::uint32_t *block = blockOf(h);
+        std::uint32_t mask[WORDS];
+        makeMask((std::uint32_t)h, mask);
+        for (SizeType i = 0; i < WORDS; ++i) {
+            block[i] |= mask[i];
+        }
+    }
+
+    /*
+    Check whether a value may be in the filter.
+
+    @param val The value
+    @return    False if the value was surely never inserted
+    */
+    bool mayHave(const Value& val) const noexcept {
+        const std::uint64_t h = mixHash((std::uint64_t)hasher(val));
+        const std::uint32_t *block = blockOf(h);
+        std::uint32_t mask[WORDS];
+        makeMask((std::uint32_t)h, mask);
+        std::uint32_t missing = 0;
+        for (SizeType i = 0; i < WORDS; ++i) {
+            missing |= mask[i] & ~block[i];
+        }
+        return missing == 0;
+    }
+
+    // Remove all values from the filter
+    void clear() noexcept {
+        if (words) {
+            std::memset(words, 0, blockNum * WORDS * sizeof(std::uint32_t));
+        }
+    }
+
+    // Return the amount of 256-bit blocks
+    SizeType getBlockCount() const noexcept {
+        return blockNum;
+    }
+
+    // Return the amount of bits
+    SizeType getBitCount() const noexcept {
+        return blockNum * BLOCK_BITS;
+    }
+
+private:
+    // Return the block of a hash value
+    std::uint32_t* blockOf(const std::uint64_t h) const noexcept {
+        return words + (SizeType)(((h >> 32) * blockNum) >> 32) * WORDS;
+    }
+
+    // Compute the bit of each word from the low 32 bits of a hash value
+    static void makeMask(const std::uint32_t key, std::uint32_t *const mask) noexcept {
+        for (SizeType i = 0; i < WORDS; ++i) {
+            mask[i] = (std::uint32_t)1 << ((key * SALT[i]) >> 27);
+        }
+    }
+
+private:
+    static const SizeType WORDS = 8;
+    static const SizeType BLOCK_BITS = WORDS * 32;
+    static const SizeType CACHE_LINE = 64;
+    static const std::uint32_t SALT[WORDS];
+
+    SizeType blockNum;
+    Hash hasher;
+    AlignedAllocator<std::uint32_t, CACHE_LINE> alloc;
+    std::uint32_t *words;  // The blocks, aligned to cache lines
+};
+
+template<typename Value, typename Hash>
+const std::uint32_t BloomFilter<Value, Hash>::SALT[BloomFilter<Value, Hash>::WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/*
+A table with a Bloom filter in front of it. has() asks the filter first,
+so most lookups of absent values return without touching the table.
+
+Removed values keep their bits in the filter. It is still correct, but
+the rate of false positives grows with the amount of removed values.
+The counters are updated by has(), so a filtered table must not be read
+by several threads at once.
+
+@param Table The table, e.g. HashTable or AVLTree. It needs has(),
+             insert(), remove(), getSize() and clear().
+@param Value The type of the values stored in the table.
+@param Hash  A unary functor that computes the hash value of a value.
+*/
+template<typename Table, typename Value, typename Hash = std::hash<Value>>
+class BloomFilteredTable {
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Initialize the table.
+
+    @param n          Expected amount of values
+    @param bitsPerKey Bits of the filter per expected value
+    @param h          The hash function of the filter
+    */
+    explicit BloomFilteredTable(
+        const SizeType n,
+        const SizeType bitsPerKey = BloomFilter<Value, Hash>::DEFAULT_BITS_PER_KEY,
+        const Hash& h = Hash())
+    : filter(n, bitsPerKey, h), rejected(0), falsePositives(0) {}
+
+    // Return the amount of values in the table
+    SizeType getSize() const noexcept {
+        return table.getSize();
+    }
+
+    // Return true if the table has no values
+    bool isEmpty() const noexcept {
+        return table.getSize() == 0;
+    }
+
+    // Remove all values from the table and the filter
+    void clear() {
+        table.clear();
+        filter.clear();
+    }
+
+    // Return true if a given value is in the table
+    bool has(const Value& val) const {
+        if (!filter.mayHave(val)) {
+            ++rejected;
+            return false;
+        }
+        const bool res = table.has(val);
+        if (!res) {
+            ++falsePositives;
+        }
+        return res;
+    }
+
+    // Insert a value to the table
+    void insert(const Value& val) {
+        filter.insert(val);
+        table.insert(val);
+    }
+
+    // Remove a value from the table
+    void remove(const Value& val) {
+        table.remove(val);
+    }
+
+    // Return the table behind the filter
+    const Table& getTable() const noexcept {
+        return table;
+    }
+
+    // Return the filter
+    const BloomFilter<Value, Hash>& getFilter() const noexcept {
+        return filter;
+    }
+
+    // Return the amount of lookups of absent values rejected by the filter
+    SizeType getRejectedCount() const noexcept {
+        return rejected;
+    }
+
+    // Return the amount of lookups of absent values passed by the filter
+    SizeType getFalsePositiveCount() const noexcept {
+        return falsePositives;
+    }
+
+    // Return the observed rate of false positives among the lookups of absent values
+    double getFalsePositiveRate() const noexcept {
+        const SizeType misses = rejected + falsePositives;
+        return misses ? (double)falsePositives / misses : 0;
+    }
+
+    // Reset the counters of the filter
+    void resetCounters() noexcept {
+        rejected = 0;
+        falsePositives = 0;
+    }
+
+private:
+    Table table;
+    BloomFilter<Value, Hash> filter;
+
+    mutable SizeType rejected;
+    mutable SizeType falsePositives;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,496 @@
+#ifndef TASTYLIB_CONCURRENTHASHTABLE_H_
+#define TASTYLIB_CONCURRENTHASHTABLE_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/hash.h"
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A hash table that can be shared by many threads. It stores unique elements
+in no particular order and has the same interface as HashTable.
+
+The elements are split into shards by their hash values. Each shard is an
+open addressing table (see FlatHashTable) guarded by its own mutex, so
+writers to different shards never wait for each other.
+
+If 'Value' is trivially copyable, has() never locks. Each shard also keeps
+a sequence lock: a writer makes the sequence number odd while it modifies
+the shard, and a reader copies the candidate slots, then checks that the
+sequence number has not changed and retries otherwise. Readers only load
+from the shard, so they do not bounce cache lines between cores. Tombstones
+are purged in place, and the arrays replaced when a shard grows are kept
+until the table is destroyed because a concurrent reader may still be
+scanning them. Every shard grows by doubling, so the kept arrays of a shard
+have fewer buckets than its current one. For other types, has() locks the
+mutex of one shard.
+
+@param Value    The type of the values stored in the hash table.
+@param PredCmp  A binary predicate that checks if two values are equal.
+                If PredCmp(a, b) == true, then value 'a' and value 'b' are
+                considered equal.
+@param Hash  A unary functor that computes the hash value of an element.
+*/
+template<typename Value, typename PredCmp = std::equal_to<Value>,
+         typename Hash = std::hash<Value>>
+class ConcurrentHashTable {
+private:
+    using Alloc = std::allocator<Value>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    // True if has() uses the sequence locks instead of the mutexes
+    using LockFreeRead = std::integral_constant<
+        bool, std::is_trivially_copyable<Value>::value>;
+
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Initialize the hash table.
+
+    @param n      Expected buckets amount of the whole table. In
+                  practice, the amount of buckets may be greater than 'n'
+    @param shards Expected shards amount. It is rounded up to a power of 2
+    @param cmp    The comparator
+    @param h      The hash function
+    */
+    explicit ConcurrentHashTable(const SizeType n = 0,
+                                 const SizeType shards = DEFAULT_SHARD,
+                                 const PredCmp& cmp = PredCmp(),
+                                 const Hash& h = Hash())
+    : shardNum(1), predCmp(cmp), hasher(h) {
+        while (shardNum < shards) {
+            shardNum <<= 1;
+        }
+        shardArr.reset(new Shard[shardNum]);
+        for (SizeType i = 0; i < shardNum; ++i) {
+            shardArr[i].table = newTable(n / shardNum);
+        }
+    }
+
+    // Forbid copy
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    // Dtor
+    ~ConcurrentHashTable() noexcept {
+        for (SizeType i = 0; i < shardNum; ++i) {
+            Shard &shard = shardArr[i];
+            Table *t = shard.table.load(std::memory_order_relaxed);
+            destroyAll(*t);
+            freeTable(t);
+            for (const auto &old : shard.retired) {
+                freeTable(old);
+            }
+        }
+    }
+
+    // Return the amount of shards
+    SizeType getShardCount() const noexcept {
+        return shardNum;
+    }
+
+    // Return the amount of buckets in the current arrays of all shards
+    SizeType getBucketCount() const {
+        SizeType res = 0;
+        for (SizeType i = 0; i < shardNum; ++i) {
+            std::lock_guard<std::mutex> guard(shardArr[i].lock);
+            res += shardArr[i].table.load(std::memory_order_relaxed)->bucketNum;
+        }
+        return res;
+    }
+
+    /*
+    Return the amount of buckets in the arrays replaced by growing,
+    which are kept for concurrent readers until the table is destroyed.
+    */
+    SizeType getRetiredBucketCount() const {
+        SizeType res = 0;
+        for (SizeType i = 0; i < shardNum; ++i) {
+            std::lock_guard<std::mutex> guard(shardArr[i].lock);
+            for (const auto &old : shardArr[i].retired) {
+                res += old->bucketNum;
+            }
+        }
+        return res;
+    }
+
+    /*
+    Return the amount of elements in the hash table. If other threads
+    are modifying the table, the result is only a snapshot.
+    */
+    SizeType getSize() const noexcept {
+        SizeType res = 0;
+        for (SizeType i = 0; i < shardNum; ++i) {
+            res += shardArr[i].size.load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    // Return true if the hash table has no elements
+    bool isEmpty() const noexcept {
+        return getSize() == 0;
+    }
+
+    // Remove all elements from the hash table
+    void clear() {
+        for (SizeType i = 0; i < shardNum; ++i) {
+            Shard &shard = shardArr[i];
+            std::lock_guard<std::mutex> guard(shard.lock);
+            writeBegin(shard);
+            Table &t = *shard.table.load(std::memory_order_relaxed);
+            destroyAll(t);
+            for (SizeType j = 0; j < t.bucketNum; ++j) {
+                t.ctrl[j].store(EMPTY, std::memory_order_relaxed);
+            }
+            shard.size.store(0, std::memory_order_relaxed);
+            shard.deleted = 0;
+            writeEnd(shard);
+        }
+    }
+
+    // Return true if a given value is in the hash table
+    bool has(const Value& val) const {
+        const std::uint64_t h = hashOf(val);
+        return has(shardOf(h), val, h, LockFreeRead());
+    }
+
+    /*
+    Insert a value to the hash table. If the
+    value exists, this function does nothing.
+
+    @param val The value to be inserted
+    */
+    void insert(const Value& val) {
+        const std::uint64_t h = hashOf(val);
+        Shard &shard = shardOf(h);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (find(*shard.table.load(std::memory_order_relaxed), val, h) != NPOS) {
+            return;
+        }
+        writeBegin(shard);
+        SizeType size = shard.size.load(std::memory_order_relaxed);
+        Table *t = shard.table.load(std::memory_order_relaxed);
+        if (size + shard.deleted + 1 > maxLoad(t->bucketNum)) {
+            // Drop tombstones if there are many of them, otherwise grow
+            if (size + 1 > (maxLoad(t->bucketNum) >> 1)) {
+                t = rebuild(shard, t->bucketNum << 1);
+            } else {
+                purge(shard);
+            }
+        }
+        const SizeType pos = findFree(*t, h);
+        AllocTraits::construct(alloc, t->slots + pos, val);
+        if (t->ctrl[pos].load(std::memory_order_relaxed) == DELETED) {
+            --shard.deleted;
+        }
+        t->ctrl[pos].store(tagOf(h), std::memory_order_relaxed);
+        shard.size.store(size + 1, std::memory_order_relaxed);
+        writeEnd(shard);
+    }
+
+    /*
+    Remove a value from the hash table. If the
+    value doesn't exist, this function does nothing.
+
+    @param val The value to be removed
+    */
+    void remove(const Value& val) {
+        const std::uint64_t h = hashOf(val);
+        Shard &shard = shardOf(h);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        Table &t = *shard.table.load(std::memory_order_relaxed);
+        const SizeType pos = find(t, val, h);
+        if (pos == NPOS) {
+            return;
+        }
+        writeBegin(shard);
+        AllocTraits::destroy(alloc, t.slots + pos);
+        const SizeType next = (pos + 1) & (t.bucketNum - 1);
+        if (t.ctrl[next].load(std::memory_order_relaxed) == EMPTY) {
+            t.ctrl[pos].store(EMPTY, std::memory_order_relaxed);
+        } else {
+            t.ctrl[pos].store(DELETED, std::memory_order_relaxed);
+            ++shard.deleted;
+        }
+        shard.size.store(shard.size.load(std::memory_order_relaxed) - 1,
+                         std::memory_order_relaxed);
+        writeEnd(shard);
+    }
+
+private:
+    static const SizeType CACHE_LINE = 64;
+    static const SizeType DEFAULT_SHARD = 64;
+    static const SizeType MIN_BUCKET = 8;
+    static const SizeType NPOS = (SizeType)-1;
+
+    static const std::uint8_t EMPTY = 0x80;
+    static const std::uint8_t DELETED = 0xfe;
+
+    /*
+    The open addressing array of one shard. Control
+    bytes have the same meaning as in FlatHashTable.
+    */
+    struct Table {
+        SizeType bucketNum;
+        std::unique_ptr<std::atomic<std::uint8_t>[]> ctrl;
+        Value *slots;
+    };
+
+    struct Shard {
+        mutable std::mutex lock;            // Held by writers
+        std::atomic<std::uint64_t> seq{0};  // Odd while a writer modifies the shard
+        std::atomic<Table*> table{nullptr};
+        std::atomic<SizeType> size{0};
+        SizeType deleted = 0;               // Amount of tombstones
+        std::vector<Table*> retired;        // Arrays replaced by growing
+
+        // Keep the shards on different cache lines
+        char padding[CACHE_LINE];
+    };
+
+    // has() implementation for trivially copyable values (no locking)
+    bool has(const Shard& shard, const Value& val,
+             const std::uint64_t h, std::true_type) const {
+        const std::uint8_t tag = tagOf(h);
+        typename std::aligned_storage<sizeof(Value), alignof(Value)>::type buf;
+        const Value &copy = *reinterpret_cast<const Value*>(&buf);
+        while (true) {
+            const std::uint64_t seq = shard.seq.load(std::memory_order_acquire);
+            if (seq & 1) {
+                std::this_thread::yield();  // A writer is working
+                continue;
+            }
+            const Table *t = shard.table.load(std::memory_order_acquire);
+            for (SizeType i = indexOf(*t, h); ; i = (i + 1) & (t->bucketNum - 1)) {
+                const std::uint8_t c = t->ctrl[i].load(std::memory_order_relaxed);
+                if (c == tag) {
+                    // Compare the copy only after validating that it is not torn
+                    std::memcpy(&buf, t->slots + i, sizeof(Value));
+                    if (!validate(shard, seq)) {
+                        break;
+                    } else if (predCmp(copy, val)) {
+                        return true;
+                    }
+                } else if (c == EMPTY) {
+                    if (validate(shard, seq)) {
+                        return false;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // has() implementation for other values (locking)
+    bool has(const Shard& shard, const Value& val,
+             const std::uint64_t h, std::false_type) const {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return find(*shard.table.load(std::memory_order_relaxed), val, h) != NPOS;
+    }
+
+    /*
+    Return true if no writer has modified a shard since
+    a reader loaded its sequence number.
+
+    @param shard The shard
+    @param seq   The even sequence number loaded before reading
+    */
+    static bool validate(const Shard& shard, const std::uint64_t seq) noexcept {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return shard.seq.load(std::memory_order_relaxed) == seq;
+    }
+
+    // Make the sequence number odd before modifying a shard
+    static void writeBegin(Shard& shard) noexcept {
+        shard.seq.store(shard.seq.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    // Make the sequence number even after modifying a shard
+    static void writeEnd(Shard& shard) noexcept {
+        shard.seq.store(shard.seq.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+    }
+
+    // Return the hash value of an element after mixing its bits
+    std::uint64_t hashOf(const Value& val) const {
+        return mixHash((std::uint64_t)hasher(val));
+    }
+
+    // Return the shard of a hash value. It uses other bits than indexOf() and tagOf().
+    Shard& shardOf(const std::uint64_t h) const noexcept {
+        return shardArr[(SizeType)(h >> 32) & (shardNum - 1)];
+    }
+
+    // Return the bucket where the probing of a hash value begins
+    static SizeType indexOf(const Table& t, const std::uint64_t h) noexcept {
+        return (SizeType)h & (t.bucketNum - 1);
+    }
+
+    // Return the 7-bit tag of a hash value stored in the control bytes
+    static std::uint8_t tagOf(const std::uint64_t h) noexcept {
+        return (std::uint8_t)(h >> 57);
+    }
+
+    // Return true if a control byte marks a slot holding an element
+    static bool isFull(const std::uint8_t c) noexcept {
+        return (c & EMPTY) == 0;
+    }
+
+    // Return the maximum amount of occupied slots (7/8 of the buckets)
+    static SizeType maxLoad(const SizeType num) noexcept {
+        return (num >> 3) * 7;
+    }
+
+    /*
+    Find the slot of a value. The caller must hold the mutex of the shard.
+
+    @param t   The array of the shard
+    @param val The value to be found
+    @param h   The hash value of 'val'
+    @return    The index of the slot. If the value doesn't exist, return NPOS.
+    */
+    SizeType find(const Table& t, const Value& val, const std::uint64_t h) const {
+        const std::uint8_t tag = tagOf(h);
+        for (SizeType i = indexOf(t, h); ; i = (i + 1) & (t.bucketNum - 1)) {
+            const std::uint8_t c = t.ctrl[i].load(std::memory_order_relaxed);
+            if (c == tag && predCmp(t.slots[i], val)) {
+                return i;
+            } else if (c == EMPTY) {
+                return NPOS;
+            }
+        }
+    }
+
+    // Return the first empty or deleted slot on the probing sequence of a hash value
+    static SizeType findFree(const Table& t, const std::uint64_t h) noexcept {
+        SizeType i = indexOf(t, h);
+        while (isFull(t.ctrl[i].load(std::memory_order_relaxed))) {
+            i = (i + 1) & (t.bucketNum - 1);
+        }
+        return i;
+    }
+
+    // Allocate an empty array with at least 'n' buckets
+    Table* newTable(const SizeType n) {
+        SizeType num = MIN_BUCKET;
+        while (num < n) {
+            num <<= 1;
+        }
+        Table *t = new Table();
+        t->bucketNum = num;
+        t->ctrl.reset(new std::atomic<std::uint8_t>[num]);
+        for (SizeType i = 0; i < num; ++i) {
+            t->ctrl[i].store(EMPTY, std::memory_order_relaxed);
+        }
+        t->slots = alloc.allocate(num);
+        return t;
+    }
+
+    // Free an array without destroying its elements
+    void freeTable(Table *const t) noexcept {
+        alloc.deallocate(t->slots, t->bucketNum);
+        delete t;
+    }
+
+    // Destroy all elements of an array without touching the control bytes
+    void destroyAll(Table& t) noexcept {
+        for (SizeType i = 0; i < t.bucketNum; ++i) {
+            if (isFull(t.ctrl[i].load(std::memory_order_relaxed))) {
+                AllocTraits::destroy(alloc, t.slots + i);
+            }
+        }
+    }
+
+    /*
+    Move the elements of a shard to a new array. The caller must hold
+    the mutex of the shard and have made its sequence number odd.
+
+    @param shard The shard
+    @param n     Buckets amount of the new array
+    @return      The new array
+    */
+    Table* rebuild(Shard& shard, const SizeType n) {
+        Table *old = shard.table.load(std::memory_order_relaxed);
+        Table *t = newTable(n);
+        for (SizeType i = 0; i < old->bucketNum; ++i) {
+            const std::uint8_t c = old->ctrl[i].load(std::memory_order_relaxed);
+            if (isFull(c)) {
+                const std::uint64_t h = hashOf(old->slots[i]);
+                const SizeType pos = findFree(*t, h);
+                AllocTraits::construct(alloc, t->slots + pos, std::move(old->slots[i]));
+                AllocTraits::destroy(alloc, old->slots + i);
+                t->ctrl[pos].store(c, std::memory_order_relaxed);
+            }
+        }
+        shard.table.store(t, std::memory_order_release);
+        shard.deleted = 0;
+        if (LockFreeRead::value) {
+            shard.retired.push_back(old);  // Readers may still scan it
+        } else {
+            freeTable(old);
+        }
+        return t;
+    }
+
+    /*
+    Drop the tombstones of a shard by rehashing its elements in place. The
+    caller must hold the mutex of the shard and have made its sequence
+    number odd, so readers scanning the array meanwhile retry. The amount
+    of empty slots never drops, so their probing still terminates.
+
+    @param shard The shard
+    */
+    void purge(Shard& shard) {
+        Table &t = *shard.table.load(std::memory_order_relaxed);
+        // Mark the elements to be placed with DELETED and drop the tombstones
+        for (SizeType i = 0; i < t.bucketNum; ++i) {
+            const std::uint8_t c = t.ctrl[i].load(std::memory_order_relaxed);
+            t.ctrl[i].store(isFull(c) ? DELETED : EMPTY, std::memory_order_relaxed);
+        }
+        for (SizeType i = 0; i < t.bucketNum; ++i) {
+            while (t.ctrl[i].load(std::memory_order_relaxed) == DELETED) {
+                const std::uint64_t h = hashOf(t.slots[i]);
+                const SizeType pos = findFree(t, h);
+                if (pos == i) {
+                    t.ctrl[i].store(tagOf(h), std::memory_order_relaxed);
+                } else if (t.ctrl[pos].load(std::memory_order_relaxed) == EMPTY) {
+                    AllocTraits::construct(alloc, t.slots + pos, std::move(t.slots[i]));
+                    AllocTraits::destroy(alloc, t.slots + i);
+                    t.ctrl[pos].store(tagOf(h), std::memory_order_relaxed);
+                    t.ctrl[i].store(EMPTY, std::memory_order_relaxed);
+                } else {
+                    // Place the element and go on with the one it displaces
+                    std::swap(t.slots[i], t.slots[pos]);
+                    t.ctrl[pos].store(tagOf(h), std::memory_order_relaxed);
+                }
+            }
+        }
+        shard.deleted = 0;
+    }
+
+private:
+    SizeType shardNum;
+    std::unique_ptr<Shard[]> shardArr;
+
+    PredCmp predCmp;
+    Hash hasher;
+    Alloc alloc;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef TASTYLIB_DARYHEAP_H_
+#define TASTYLIB_DARYHEAP_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/AlignedAllocator.h"
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A heap data structure taking the form of a complete D-ary tree.
+
+A wider tree is shallower, so pop() moves fewer elements but compares more
+children at each level. The tree is stored in a cache-aligned array with
+D - 1 unused slots at the front, which puts the D children of every node
+at an index that is a multiple of D. If D * sizeof(Value) divides the size
+of a cache line, all children of a node share one cache line.
+
+@param Value    The type of the value stored in the heap
+@param PredCmp  The type of the binary predicate to arrange the nodes.
+                It has the same meaning as in BinaryHeap.
+@param D        The amount of children of each node
+*/
+template<typename Value, typename PredCmp = std::less<Value>, std::size_t D = 4>
+class DaryHeap {
+    static_assert(D >= 2, "A heap node needs at least 2 children");
+
+public:
+    using Container = std::vector<Value, AlignedAllocator<Value>>;
+    using SizeType = std::size_t;
+
+    // Default ctor
+    DaryHeap(const PredCmp& cmp = PredCmp())
+    : predCmp(cmp), tree(D - 1) {}
+
+    // Build heap with a given array of values
+    explicit DaryHeap(const std::vector<Value>& vals, const PredCmp& cmp = PredCmp())
+    : predCmp(cmp), tree(D - 1) {
+        tree.insert(tree.end(), vals.begin(), vals.end());
+        const SizeType size = getSize();
+        if (size > 1) {
+            for (SizeType i = (size - 2) / D + 1; i > 0; --i) {
+                Value val = std::move(heap()[i - 1]);
+                percolateDown(i - 1, std::move(val));
+            }
+        }
+    }
+
+    // Return the amount of elements in the heap
+    SizeType getSize() const noexcept {
+        return tree.size() - (D - 1);
+    }
+
+    // Return true if the heap has no elements
+    bool isEmpty() const noexcept {
+        return getSize() == 0;
+    }
+
+    // Clear the elements in the heap
+    void clear() {
+        tree.resize(D - 1);
+    }
+
+    // Insert a new element to the heap
+    void push(const Value& val) {
+        tree.push_back(val);
+        Value last = std::move(tree.back());
+        percolateUp(getSize() - 1, std::move(last));
+    }
+
+    /*
+    Return the root element of the heap.
+    Precondition: The heap is non-empty.
+    */
+    Value top() const {
+        return heap()[0];
+    }
+
+    /*
+    Remove the root element of the heap and maintain the nodes order.
+    Precondition: The heap is non-empty.
+    */
+    void pop() {
+        Value last = std::move(tree.back());
+        tree.pop_back();
+        if (!isEmpty()) {
+            // The empty hole (root node) percolates down
+            percolateDown(0, std::move(last));
+        }
+    }
+
+private:
+    // Return the root of the tree. Node i has children D * i + 1 to D * i + D.
+    Value* heap() noexcept {
+        return tree.data() + (D - 1);
+    }
+
+    const Value* heap() const noexcept {
+        return tree.data() + (D - 1);
+    }
+
+    void percolateUp(const SizeType start, Value&& val) {
+        Value *h = heap();
+        SizeType i = start;
+        for (; i != 0 && predCmp(val, h[(i - 1) / D]); i = (i - 1) / D) {
+            h[i] = std::move(h[(i - 1) / D]);
+        }
+        h[i] = std::move(val);
+    }
+
+    void percolateDown(const SizeType start, Value&& val) {
+        Value *h = heap();
+        const SizeType size = getSize();
+        SizeType i = start, child;
+        for (; D * i + 1 < size; i = child) {
+            child = D * i + 1;
+            if (child + D <= size) {
+                // The trip count is known at compile time, so the loop is
+                // unrolled. The comparisons stay branches: a branch-free
+                // select makes each level wait for the load of the previous
+                // one, which is slower once the heap outgrows the cache.
+                const Value *c = h + child;
+                SizeType best = 0;
+                for (SizeType k = 1; k < D; ++k) {
+                    if (predCmp(c[k], c[best])) {
+                        best = k;
+                    }
+                }
+                child += best;
+            } else {
+                // The last node with less than D children
+                for (SizeType k = child + 1; k < size; ++k) {
+                    if (predCmp(h[k], h[child])) {
+                        child = k;
+                    }
+                }
+            }
+            if (predCmp(val, h[child])) {
+                break;
+            } else {
+                h[i] = std::move(h[child]);
+            }
+        }
+        h[i] = std::move(val);
+    }
+
+private:
+    PredCmp predCmp;
+
+    /*
+    Store the complete D-ary tree in a cache-aligned array. The first D - 1
+    elements have no use, and the root is stored at tree[D - 1].
+    */
+    Container tree;
+};
+
+TASTYLIB_NS_END
+
+#endif
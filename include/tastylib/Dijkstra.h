@@ -3,6 +3,10 @@
 
 #include "tastylib/internal/base.h"
 #include "tastylib/Graph.h"
+#include "tastylib/BinaryHeap.h"
+#include "tastylib/RadixHeap.h"
+#include <vector>
+#include <utility>
 
 TASTYLIB_NS_BEGIN
 
@@ -25,6 +29,85 @@ Graph object used for Dijkstra's algorithm.
 template<typename Value>
 using DijkGraph = Graph<DijkValue<Value>>;
 
+// The priority queue used by dijkstra()
+enum DijkQueue {
+    DIJK_BINARY_HEAP,  // IndexedBinaryHeap with decreaseKey()
+    DIJK_RADIX_HEAP    // RadixHeap, which needs non-negative weights
+};
+
+/*
+Run Dijkstra's algorithm with an IndexedBinaryHeap. Each unvisited vertex
+is queued once, and its key decreases in place.
+*/
+template<typename Value>
+void dijkstraWithBinaryHeap(DijkGraph<Value>& graph,
+                            const typename DijkGraph<Value>::NumType src) {
+    using NumType    = typename DijkGraph<Value>::NumType;
+    using WeightType = typename DijkGraph<Value>::WeightType;
+
+    // The unvisited vertices with a known distance, keyed by (dist, vertex)
+    using Heap = IndexedBinaryHeap<std::pair<WeightType, NumType>>;
+    NumType size = graph.getSize();
+    Heap heap;
+    std::vector<typename Heap::Handle> handles(size);
+    std::vector<bool> queued(size, false);
+    handles[src] = heap.push(std::make_pair((WeightType)0, src));
+    queued[src] = true;
+
+    while (!heap.isEmpty()) {
+        NumType cur = heap.top().second;
+        heap.pop();
+        graph[cur].visit = true;
+        std::vector<NumType> neighbors = graph.getNeighbors(cur);
+        for (const auto &adj : neighbors) {
+            WeightType w = graph.getWeight(cur, adj);
+            if (!graph[adj].visit && graph[cur].dist + w < graph[adj].dist) {
+                graph[adj].dist = graph[cur].dist + w;
+                graph[adj].prev = cur;
+                auto key = std::make_pair(graph[adj].dist, adj);
+                if (queued[adj]) {
+                    heap.decreaseKey(handles[adj], key);
+                } else {
+                    handles[adj] = heap.push(key);
+                    queued[adj] = true;
+                }
+            }
+        }
+    }
+}
+
+/*
+Run Dijkstra's algorithm with a RadixHeap. A vertex is queued again
+whenever its distance decreases, and the stale entries are skipped.
+*/
+template<typename Value>
+void dijkstraWithRadixHeap(DijkGraph<Value>& graph,
+                           const typename DijkGraph<Value>::NumType src) {
+    using NumType    = typename DijkGraph<Value>::NumType;
+    using WeightType = typename DijkGraph<Value>::WeightType;
+
+    RadixHeap<WeightType, NumType> heap;
+    heap.push(0, src);
+
+    while (!heap.isEmpty()) {
+        NumType cur = heap.top().second;
+        heap.pop();
+        if (graph[cur].visit) {
+            continue;  // A stale entry
+        }
+        graph[cur].visit = true;
+        std::vector<NumType> neighbors = graph.getNeighbors(cur);
+        for (const auto &adj : neighbors) {
+            WeightType w = graph.getWeight(cur, adj);
+            if (!graph[adj].visit && graph[cur].dist + w < graph[adj].dist) {
+                graph[adj].dist = graph[cur].dist + w;
+                graph[adj].prev = cur;
+                heap.push(graph[adj].dist, adj);
+            }
+        }
+    }
+}
+
 /*
 The Dijkstra's algorithm to find the shortest
 paths from a starting vertex to other vertices.
@@ -36,13 +119,14 @@ If 'i' is the starting vertex, then graph[i].prev == graph.getSize() + 1.
 
 @param graph The graph object
 @param src   The starting vertex number
+@param queue The priority queue of the vertices to visit
 */
 template<typename Value>
 void dijkstra(DijkGraph<Value>& graph,
-              const typename DijkGraph<Value>::NumType src) {
-    using G          = DijkGraph<Value>;
-    using NumType    = typename DijkGraph<Value>::NumType;
-    using WeightType = typename DijkGraph<Value>::WeightType;
+              const typename DijkGraph<Value>::NumType src,
+              const DijkQueue queue = DIJK_BINARY_HEAP) {
+    using G       = DijkGraph<Value>;
+    using NumType = typename DijkGraph<Value>::NumType;
 
     // Init
     NumType size = graph.getSize();
@@ -52,27 +136,14 @@ void dijkstra(DijkGraph<Value>& graph,
         graph[i].prev = size + 1;  // No previous vertex
     }
 
-    while (true) {
-        WeightType minDist = G::MAX_WEIGHT;
-        NumType cur = 0;
-        for (NumType i = 0; i < size; ++i) {
-            if (!graph[i].visit && graph[i].dist < minDist) {
-                minDist = graph[i].dist;
-                cur = i;
-            }
-        }
-        if (minDist == G::MAX_WEIGHT) {
-            break;  // All vertices are visited
-        }
-        graph[cur].visit = true;
-        std::vector<NumType> neighbors = graph.getNeighbors(cur);
-        for (const auto &adj : neighbors) {
-            WeightType w = graph.getWeight(cur, adj);
-            if (!graph[adj].visit && graph[cur].dist + w < graph[adj].dist) {
-                graph[adj].dist = graph[cur].dist + w;
-                graph[adj].prev = cur;
-            }
-        }
+    switch (queue) {
+        case DIJK_RADIX_HEAP:
+            dijkstraWithRadixHeap(graph, src);
+            break;
+        case DIJK_BINARY_HEAP:
+        default:
+            dijkstraWithBinaryHeap(graph, src);
+            break;
     }
 }
 
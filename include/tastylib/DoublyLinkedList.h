@@ -2,7 +2,10 @@
 #define TASTYLIB_DOUBLYLINKEDLIST_H_
 
 #include "tastylib/internal/base.h"
+#include "tastylib/internal/merge.h"
 #include <functional>
+#include <iterator>
+#include <utility>
 #include <cstddef>
 
 TASTYLIB_NS_BEGIN
@@ -22,6 +25,62 @@ private:
 
         Node(const Value& v, Node *p = nullptr, Node *n = nullptr) noexcept
         : val(v), prev(p), next(n) {}
+
+        Node(Value&& v, Node *p = nullptr, Node *n = nullptr) noexcept
+        : val(std::move(v)), prev(p), next(n) {}
+    };
+
+    // Forward iterator over the node values, for gallopMerge()
+    class NodeIter {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        explicit NodeIter(Node *n = nullptr) noexcept : node(n) {}
+
+        Value& operator*() const noexcept { return node->val; }
+        Value* operator->() const noexcept { return &node->val; }
+
+        NodeIter& operator++() noexcept {
+            node = node->next;
+            return *this;
+        }
+
+        NodeIter operator++(int) noexcept {
+            NodeIter old(*this);
+            node = node->next;
+            return old;
+        }
+
+        bool operator==(const NodeIter& other) const noexcept { return node == other.node; }
+        bool operator!=(const NodeIter& other) const noexcept { return node != other.node; }
+
+        Node *node;
+    };
+
+    // Link the nodes emitted by gallopMerge() after the merged list. The
+    // nodes emitted at once come from one sorted list and are linked to
+    // each other already, and links that stay the same are not written.
+    struct NodeAppender {
+        Node *head = nullptr;
+        Node *tail = nullptr;
+
+        void operator()(const NodeIter first, const std::size_t count) noexcept {
+            Node *p = first.node;
+            if (!tail) {
+                head = p;
+            } else if (tail->next != p) {
+                tail->next = p;
+                p->prev = tail;
+            }
+            for (std::size_t i = 1; i < count; ++i) {
+                p = p->next;
+            }
+            tail = p;
+        }
     };
 
 public:
@@ -98,6 +157,18 @@ public:
         }
     }
 
+    // Return the value of the first node. The list must not be empty.
+    const Value& front() const noexcept {
+        return head->val;
+    }
+
+    // Hint the processor to fetch the first node into cache
+    void prefetchFront() const noexcept {
+        if (head) {
+            TASTYLIB_PREFETCH(head);
+        }
+    }
+
     /*
     Find a node in the list.
 
@@ -117,6 +188,24 @@ public:
         return -1;
     }
 
+    /*
+    Find a node satisfying a predicate.
+
+    @param pred A unary predicate called with the node values
+    @return     The first position of a node that satisfies 'pred'.
+                If no node satisfies it, return -1.
+    */
+    template<typename Pred>
+    int findIf(const Pred& pred) const {
+        SizeType pos = 0;
+        for (Node *tmp = head; tmp; tmp = tmp->next, ++pos) {
+            if (pred(tmp->val)) {
+                return (int)pos;
+            }
+        }
+        return -1;
+    }
+
     /*
     Insert a node at a given position. If the position is greater than
     the list's size, the node will be inserted to the back of the list.
@@ -167,14 +256,11 @@ public:
 
     // Insert a node at the back of the list
     void insertBack(const Value& val) {
-        Node *newNode = new Node(val, tail, nullptr);
-        if (tail) {
-            tail->next = newNode;
-        }
-        tail = newNode;
-        if (++size == 1) {
-            head = tail;
-        }
+        linkBack(new Node(val, tail, nullptr));
+    }
+
+    void insertBack(Value&& val) {
+        linkBack(new Node(std::move(val), tail, nullptr));
     }
 
     /*
@@ -213,6 +299,28 @@ public:
         }
     }
 
+    /*
+    Move the first node to the back of another list without
+    copying its value. If the list is empty, nothing happens.
+
+    @param other The list that receives the node
+    */
+    void spliceFrontTo(DoublyLinkedList& other) noexcept {
+        if (isEmpty()) {
+            return;
+        }
+        Node *node = head;
+        head = head->next;
+        if (--size == 0) {
+            tail = head;
+        } else {
+            head->prev = nullptr;
+        }
+        node->prev = other.tail;
+        node->next = nullptr;
+        other.linkBack(node);
+    }
+
     // Remove the first node of the list
     void removeFront() noexcept {
         if (isEmpty()) {
@@ -253,10 +361,21 @@ public:
     */
     template<typename PredCmp = std::less<Value>>
     void sort(const PredCmp& cmp = PredCmp()) {
-        head = mergeSort(head, size, cmp);
+        head = mergeSort(head, size, cmp, tail);
     }
 
 private:
+    // Append a new node whose prev pointer is the tail
+    void linkBack(Node *const newNode) noexcept {
+        if (tail) {
+            tail->next = newNode;
+        }
+        tail = newNode;
+        if (++size == 1) {
+            head = tail;
+        }
+    }
+
     /*
     Get a best node to perform inserting operation at a given position.
     The function is available only when the list is not empty.
@@ -287,63 +406,44 @@ private:
     }
 
     /*
-    Running a merge sort procedure of the list.
+    Running a merge sort procedure of the list. The halves are merged by
+    gallopMerge(), the kernel shared with timSort(), so merging two lists
+    with long sorted stretches takes few comparisons.
 
-    @param h     The head of the list
+    @param h     The head of the list, whose last node has no next node
     @param size_ The size of the list
     @param cmp   A binary predicate to compare two node values
+    @param last  Set to the tail of the sorted list
     @return      The head pointer of the sorted list
     */
     template<typename PredCmp>
-    Node* mergeSort(Node* h, const SizeType size_, const PredCmp& cmp) {
+    Node* mergeSort(Node* h, const SizeType size_, const PredCmp& cmp, Node*& last) {
         if (size_ < 2) {
+            last = h;
             return h;
         }
 
-        // Find middle position
+        // Find middle position and split the list
         Node *mid = h;
         SizeType size1 = size_ >> 1, size2 = size_ - size1;
         for (SizeType i = 0; i < size1 - 1; ++i) {
             mid = mid->next;
         }
+        Node *h2 = mid->next;
+        mid->next = nullptr;
 
         // Sort each half of the list
-        Node *h2 = mergeSort(mid->next, size2, cmp);
-        Node *h1 = mergeSort(h, size1, cmp);
+        h2 = mergeSort(h2, size2, cmp, last);
+        Node *h1 = mergeSort(h, size1, cmp, last);
 
         // Merge h1 and h2(they are both sorted and non-empty)
-        SizeType cnt = 0;
-        Node *newHead = h1;
-        for (bool initLoop = true; ; initLoop = false) {
-            if (cmp(h2->val, h1->val)) {
-                if (initLoop) {
-                    newHead = h2;
-                }
-                Node *h2Prev = h2->prev, *h2Next = h2->next, *h1Prev = h1->prev;
-                h2Prev->next = h2Next;
-                if (h2Next) {
-                    h2Next->prev = h2->prev;
-                } else {  // New tail
-                    tail = h2Prev;
-                }
-                if (h1Prev) {
-                    h1Prev->next = h2;
-                }
-                h2->prev = h1Prev;
-                h2->next = h1;
-                h1->prev = h2;
-                h2 = h2Next;
-                if (++cnt == size2) {
-                    break;
-                }
-            } else {
-                h1 = h1->next;
-                if (h1 == h2) {
-                    break;
-                }
-            }
-        }
-        return newHead;
+        NodeAppender out;
+        SizeType minGallop = 7;
+        gallopMerge(NodeIter(h1), size1, NodeIter(h2), size2, out, cmp, minGallop);
+        out.head->prev = nullptr;
+        out.tail->next = nullptr;
+        last = out.tail;
+        return out.head;
     }
 
 private:
@@ -0,0 +1,501 @@
+#ifndef TASTYLIB_EXTERNALSORT_H_
+#define TASTYLIB_EXTERNALSORT_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/IOThread.h"
+#include "tastylib/BinaryHeap.h"
+#include "tastylib/Sort.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+TASTYLIB_NS_BEGIN
+
+/*
+Statistics of an external sort, returned by externalSort() and
+externalRadixSort().
+*/
+struct ExternalSortStats {
+    std::size_t records = 0;
+    std::size_t runs = 0;          // Sorted runs written by the first pass
+    std::size_t merges = 0;        // K-way merges, including the final one
+    std::uint64_t bytesRead = 0;
+    std::uint64_t bytesWritten = 0;
+    double passes = 0;             // Bytes read divided by the size of the input
+    double runTime = 0;            // Milliseconds spent writing the sorted runs
+    double mergeTime = 0;          // Milliseconds spent merging them
+};
+
+/*
+Read a file of records sequentially in blocks. The next block is read by
+an IOThread while the current one is consumed.
+
+@param Value The type of the records
+*/
+template<typename Value>
+class RunReader {
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Open a file and start reading it.
+
+    @param path  The path of the file
+    @param count The amount of records to read
+    @param block The amount of records in a block
+    @param io    The thread that reads the blocks
+    */
+    RunReader(const std::string& path, const SizeType count, const SizeType block, IOThread& io)
+    : in(path, std::ios::binary), path(path), left(count), block(block), io(io),
+      cur(0), size(0), pos(0), nextSize(0) {
+        if (!in) {
+            throw std::runtime_error("externalSort: cannot open " + path);
+        }
+        buffers[0].resize(std::min(block, count));
+        buffers[1].resize(std::min(block, count));
+        fetch();
+        load();
+    }
+
+    // Forbid copy
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    // Return true if all records have been consumed
+    bool isEmpty() const noexcept {
+        return pos == size;
+    }
+
+    // Return the current record
+    const Value& front() const noexcept {
+        return buffers[cur][pos];
+    }
+
+    // Move to the next record
+    void next() {
+        if (++pos == size) {
+            load();
+        }
+    }
+
+private:
+    // Start reading the next block into the buffer not in use
+    void fetch() {
+        nextSize = std::min(block, left);
+        left -= nextSize;
+        if (nextSize > 0) {
+            Value *const dest = buffers[cur ^ 1].data();
+            const SizeType n = nextSize;
+            pending = io.submit([this, dest, n]() {
+                if (!in.read((char*)dest, n * sizeof(Value))) {
+                    throw std::runtime_error("externalSort: cannot read " + path);
+                }
+            });
+        }
+    }
+
+    // Wait for the next block and make it current
+    void load() {
+        size = pos = 0;
+        if (nextSize == 0) {
+            return;
+        }
+        pending.get();
+        cur ^= 1;
+        size = nextSize;
+        fetch();
+    }
+
+private:
+    std::ifstream in;
+    std::string path;
+    SizeType left;
+    SizeType block;
+    IOThread &io;
+    std::vector<Value> buffers[2];
+    SizeType cur;
+    SizeType size;
+    SizeType pos;
+    SizeType nextSize;
+    std::future<void> pending;
+};
+
+/*
+Write records to a file in blocks. A full block is written by an IOThread
+while the other one is filled.
+
+@param Value The type of the records
+*/
+template<typename Value>
+class RunWriter {
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Create a file.
+
+    @param path  The path of the file
+    @param block The amount of records in a block
+    @param io    The thread that writes the blocks
+    */
+    RunWriter(const std::string& path, const SizeType block, IOThread& io)
+    : out(path, std::ios::binary | std::ios::trunc), path(path), block(block), io(io),
+      cur(0), size(0) {
+        if (!out) {
+            throw std::runtime_error("externalSort: cannot create " + path);
+        }
+        buffers[0].resize(block);
+        buffers[1].resize(block);
+    }
+
+    // Forbid copy
+    RunWriter(const RunWriter&) = delete;
+    RunWriter& operator=(const RunWriter&) = delete;
+
+    // Append a record
+    void push(const Value& val) {
+        buffers[cur][size] = val;
+        if (++size == block) {
+            flush();
+        }
+    }
+
+    /*
+    Write the records left and close the file. Throw std::runtime_error
+    if a block could not be written.
+    */
+    void close() {
+        flush();
+        if (pending.valid()) {
+            pending.get();
+        }
+        out.close();
+        if (!out) {
+            throw std::runtime_error("externalSort: cannot write " + path);
+        }
+    }
+
+private:
+    // Write the current block, and wait until the other one can be filled
+    void flush() {
+        if (size == 0) {
+            return;
+        }
+        const Value *const src = buffers[cur].data();
+        const SizeType n = size;
+        std::future<void> written = io.submit([this, src, n]() {
+            if (!out.write((const char*)src, n * sizeof(Value))) {
+                throw std::runtime_error("externalSort: cannot write " + path);
+            }
+        });
+        if (pending.valid()) {
+            pending.get();
+        }
+        pending = std::move(written);
+        cur ^= 1;
+        size = 0;
+    }
+
+private:
+    std::ofstream out;
+    std::string path;
+    SizeType block;
+    IOThread &io;
+    std::vector<Value> buffers[2];
+    SizeType cur;
+    SizeType size;
+    std::future<void> pending;
+};
+
+/*
+Merge sorted run files into one file with a BinaryHeap of cursors, each
+pointing to the current record of a run.
+
+@param runs  The paths of the runs and the amounts of records in them
+@param path  The path of the merged file
+@param block The amount of records in each of the two buffers of a run,
+             and of the output
+@param cmp   The comparator
+*/
+template<typename Value, typename PredCmp>
+void mergeRunFiles(const std::vector<std::pair<std::string, std::size_t>>& runs,
+                   const std::string& path,
+                   const std::size_t block,
+                   const PredCmp& cmp) {
+    struct Cursor {
+        const Value *val;
+        RunReader<Value> *reader;
+    };
+    struct CursorCmp {
+        const PredCmp *cmp;
+
+        bool operator()(const Cursor& a, const Cursor& b) const {
+            return (*cmp)(*a.val, *b.val);
+        }
+    };
+
+    std::vector<std::unique_ptr<RunReader<Value>>> readers;
+    std::unique_ptr<RunWriter<Value>> writer;
+    IOThread io;  // Stopped first, while the buffers are alive
+    BinaryHeap<Cursor, CursorCmp> heap(CursorCmp{&cmp});
+    heap.reserve(runs.size());
+    for (const auto &run : runs) {
+        readers.push_back(std::unique_ptr<RunReader<Value>>(
+            new RunReader<Value>(run.first, run.second, block, io)));
+        RunReader<Value> *const reader = readers.back().get();
+        if (!reader->isEmpty()) {
+            heap.push(Cursor{&reader->front(), reader});
+        }
+    }
+    writer.reset(new RunWriter<Value>(path, block, io));
+    while (!heap.isEmpty()) {
+        RunReader<Value> *const reader = heap.top().reader;
+        writer->push(reader->front());
+        reader->next();
+        if (reader->isEmpty()) {
+            heap.pop();
+        } else {
+            heap.replaceTop(Cursor{&reader->front(), reader});
+        }
+    }
+    writer->close();
+}
+
+// Remove the temporary files that are still listed when it is destroyed
+struct TempFiles {
+    std::vector<std::string> paths;
+
+    ~TempFiles() noexcept {
+        for (const auto &path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+};
+
+/*
+The external merge sort shared by externalSort() and externalRadixSort().
+
+@param input     The path of the input file
+@param output    The path of the output file
+@param memory    The budget of the record buffers in bytes
+@param fanIn     The maximum amount of runs merged at once
+@param cmp       The comparator
+@param sortRun   The function sorting a run in memory, called as
+                 sortRun(arr, n)
+@param runCopies The amount of arrays of the run size that sortRun()
+                 allocates, besides the two run buffers
+@return          The statistics of the sort
+*/
+template<typename Value, typename PredCmp, typename SortRun>
+ExternalSortStats externalSortImpl(const std::string& input,
+                                   const std::string& output,
+                                   const std::size_t memory,
+                                   const std::size_t fanIn,
+                                   const PredCmp& cmp,
+                                   const SortRun& sortRun,
+                                   const std::size_t runCopies) {
+    static_assert(std::is_trivially_copyable<Value>::value,
+                  "externalSort() sorts records that are trivially copyable");
+    using Run = std::pair<std::string, std::size_t>;
+    using Clock = std::chrono::steady_clock;
+    const std::size_t RECORD = sizeof(Value);
+    const std::size_t maxIn = std::max(fanIn, (std::size_t)2);
+
+    std::ifstream in(input, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("externalSort: cannot open " + input);
+    }
+    const std::uint64_t bytes = (std::uint64_t)in.tellg();
+    if (bytes % RECORD != 0) {
+        throw std::runtime_error("externalSort: the size of " + input +
+                                 " is not a multiple of the record size");
+    }
+    in.seekg(0);
+    ExternalSortStats stats;
+    stats.records = (std::size_t)(bytes / RECORD);
+    const std::size_t n = stats.records;
+
+    // Pass 1: sort chunks of the input in memory and write them as runs.
+    // Chunk i + 1 is read while chunk i is sorted, and chunk i is written
+    // while chunk i + 1 is sorted.
+    const Clock::time_point runStart = Clock::now();
+    const std::size_t chunk = std::min(std::max(memory / (RECORD * (2 + runCopies)), (std::size_t)1),
+                                       std::max(n, (std::size_t)1));
+    const std::size_t chunks = (n + chunk - 1) / chunk;
+    TempFiles temps;
+    std::deque<Run> runs;
+    {
+        std::vector<Value> buffers[2];
+        buffers[0].resize(chunks > 0 ? chunk : 0);
+        buffers[1].resize(chunks > 1 ? chunk : 0);
+        std::vector<std::future<void>> reads(chunks), writes;
+        IOThread io;
+        auto read = [&](const std::size_t i) {
+            Value *const dest = buffers[i & 1].data();
+            const std::size_t len = std::min(chunk, n - i * chunk);
+            reads[i] = io.submit([&in, &input, dest, len]() {
+                if (!in.read((char*)dest, len * sizeof(Value))) {
+                    throw std::runtime_error("externalSort: cannot read " + input);
+                }
+            });
+        };
+        if (chunks > 0) {
+            read(0);
+        }
+        for (std::size_t i = 0; i < chunks; ++i) {
+            reads[i].get();
+            if (i + 1 < chunks) {
+                // Queued after the write of chunk i - 1 from the same buffer
+                read(i + 1);
+            }
+            Value *const arr = buffers[i & 1].data();
+            const std::size_t len = std::min(chunk, n - i * chunk);
+            sortRun(arr, len);
+            std::string path = output;
+            if (chunks > 1) {
+                path += ".run" + std::to_string(i);
+                temps.paths.push_back(path);
+            }
+            runs.push_back(Run(path, len));
+            writes.push_back(io.submit([path, arr, len]() {
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                if (!out.write((const char*)arr, len * sizeof(Value))) {
+                    throw std::runtime_error("externalSort: cannot write " + path);
+                }
+            }));
+        }
+        for (auto &w : writes) {
+            w.get();
+        }
+    }
+    if (n == 0) {
+        std::ofstream out(output, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("externalSort: cannot create " + output);
+        }
+    }
+    stats.runs = runs.size();
+    stats.bytesRead = stats.bytesWritten = bytes;
+    stats.runTime = std::chrono::duration<double, std::milli>(Clock::now() - runStart).count();
+
+    // Then merge up to 'fanIn' runs at a time. The first merge takes just
+    // enough runs for the others to take 'fanIn' each, and the newest runs
+    // are merged last, so the fewest records are read more than twice.
+    const Clock::time_point mergeStart = Clock::now();
+    const std::size_t block = std::max(memory / (RECORD * 2 * (maxIn + 1)), (std::size_t)1);
+    std::size_t merged = 0;
+    bool first = true;
+    while (runs.size() > 1) {
+        std::size_t k = maxIn;
+        if (first && runs.size() > maxIn) {
+            k = (runs.size() - 2) % (maxIn - 1) + 2;
+        }
+        first = false;
+        k = std::min(k, runs.size());
+        std::vector<Run> group(runs.begin(), runs.begin() + k);
+        runs.erase(runs.begin(), runs.begin() + k);
+        std::size_t len = 0;
+        for (const auto &run : group) {
+            len += run.second;
+        }
+        std::string path = output;
+        if (!runs.empty()) {
+            path += ".merge" + std::to_string(merged++);
+            temps.paths.push_back(path);
+        }
+        mergeRunFiles<Value, PredCmp>(group, path, block, cmp);
+        for (const auto &run : group) {
+            std::remove(run.first.c_str());
+        }
+        runs.push_back(Run(path, len));
+        ++stats.merges;
+        stats.bytesRead += (std::uint64_t)len * RECORD;
+        stats.bytesWritten += (std::uint64_t)len * RECORD;
+    }
+    stats.mergeTime = std::chrono::duration<double, std::milli>(Clock::now() - mergeStart).count();
+    stats.passes = bytes > 0 ? (double)stats.bytesRead / bytes : 0;
+    return stats;
+}
+
+/*
+Sort a file of fixed-size records that may be much larger than memory.
+The first pass reads chunks of the input that fit in half of the memory
+budget, sorts them with pdqSort(), or parallelSort() on several threads,
+and writes them as sorted runs next to the output file. Then the runs
+are merged up to 'fanIn' at a time by a BinaryHeap of cursors, until one
+is left. The reads and writes run on a background thread, and every file
+has two buffers, so the next block is read while the current one is
+merged. The sort is not stable. Throw std::runtime_error if a file can't
+be read or written.
+
+@param input   The path of the input file. Its records are copied
+               byte by byte, so 'Value' must be trivially copyable.
+@param output  The path of the output file. It may be the input file.
+@param memory  The budget of the record buffers in bytes
+@param fanIn   The maximum amount of runs merged at once, at least 2.
+               Each merge splits the budget into 2 * (fanIn + 1) blocks.
+@param cmp     The comparator
+@param threads The amount of threads that sort the runs in memory
+@return        The statistics of the sort
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+ExternalSortStats externalSort(const std::string& input,
+                               const std::string& output,
+                               const std::size_t memory,
+                               const std::size_t fanIn = 16,
+                               const PredCmp& cmp = PredCmp(),
+                               const std::size_t threads = 1) {
+    auto sortRun = [&cmp, threads](Value *const arr, const std::size_t n) {
+        if (threads > 1) {
+            parallelSort(arr, n, cmp, threads);
+        } else {
+            pdqSort(arr, 0, n - 1, cmp);
+        }
+    };
+    return externalSortImpl<Value>(input, output, memory, fanIn, cmp, sortRun, 0);
+}
+
+/*
+Sort a file of fixed-size records by a numeric key in ascending order,
+like externalSort(), but sort the runs in memory with radixSort(). The
+radix sort needs a buffer as large as a run, so the runs are a third of
+the memory budget instead of a half.
+
+@param input  The path of the input file
+@param output The path of the output file
+@param keyOf  The function to get the key of a record. It returns an
+              arithmetic value.
+@param memory The budget of the record buffers in bytes
+@param fanIn  The maximum amount of runs merged at once, at least 2
+@return       The statistics of the sort
+*/
+template<typename Value, typename KeyOf>
+ExternalSortStats externalRadixSort(const std::string& input,
+                                    const std::string& output,
+                                    const KeyOf& keyOf,
+                                    const std::size_t memory,
+                                    const std::size_t fanIn = 16) {
+    auto cmp = [&keyOf](const Value& a, const Value& b) {
+        return keyOf(a) < keyOf(b);
+    };
+    auto sortRun = [&keyOf](Value *const arr, const std::size_t n) {
+        radixSort(arr, n, keyOf);
+    };
+    return externalSortImpl<Value>(input, output, memory, fanIn, cmp, sortRun, 1);
+}
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef TASTYLIB_FLATHASHTABLE_H_
+#define TASTYLIB_FLATHASHTABLE_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/FlatTable.h"
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+TASTYLIB_NS_BEGIN
+
+/*
+An open addressing hash table that stores unique elements in no particular
+order. It has the same interface as HashTable, but keeps the values inline
+in one contiguous array instead of one linked list per bucket.
+
+Each slot owns a one-byte control word (SwissTable style) that is either
+EMPTY, DELETED or the 7 high bits of the element's hash value. A lookup
+scans the control bytes with linear probing and only calls PredCmp on the
+slots whose 7-bit tag matches, so most lookups touch one cache line of
+control bytes and one cache line of values. See FlatTable for details.
+
+@param Value    The type of the values stored in the hash table.
+@param PredCmp  A binary predicate that checks if two values are equal.
+                If PredCmp(a, b) == true, then value 'a' and value 'b' are
+                considered equal.
+@param Hash  A unary functor that computes the hash value of an element.
+*/
+template<typename Value, typename PredCmp = std::equal_to<Value>,
+         typename Hash = std::hash<Value>>
+class FlatHashTable {
+private:
+    struct Identity {
+        const Value& operator()(const Value& val) const noexcept {
+            return val;
+        }
+    };
+
+    using Table = FlatTable<Value, Identity, PredCmp, Hash>;
+
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Initialize the hash table.
+
+    @param n   Expected buckets amount. In practice, the
+               amount of buckets may be greater than 'n'
+    @param cmp The comparator
+    @param h   The hash function
+    */
+    explicit FlatHashTable(const SizeType n = Table::MIN_BUCKET,
+                           const PredCmp& cmp = PredCmp(),
+                           const Hash& h = Hash())
+    : table(n, cmp, h) {}
+
+    // Return the amount of elements in the hash table
+    SizeType getSize() const noexcept {
+        return table.getSize();
+    }
+
+    // Return true if the hash table has no elements
+    bool isEmpty() const noexcept {
+        return table.getSize() == 0;
+    }
+
+    // Return the amount of buckets
+    SizeType getBucketCount() const noexcept {
+        return table.getBucketCount();
+    }
+
+    // Remove all elements from the hash table
+    void clear() noexcept {
+        table.clear();
+    }
+
+    // Return true if a given value is in the hash table
+    bool has(const Value& val) const {
+        return table.find(val, table.hashOf(val)) != Table::NPOS;
+    }
+
+    /*
+    Check whether each value of a batch is in the hash table. The values
+    are processed in groups. The slots of a whole group are prefetched
+    before any of them is probed, so the cache misses of the group
+    overlap instead of being paid one after another.
+
+    @param vals The values to be found
+    @param n    The amount of values
+    @param res  Output array. res[i] is true if vals[i] is in the hash table.
+    */
+    void hasBatch(const Value *const vals, const SizeType n, bool *const res) const {
+        std::uint64_t h[BATCH_SIZE];
+        for (SizeType beg = 0; beg < n; beg += BATCH_SIZE) {
+            const SizeType cnt = (n - beg < BATCH_SIZE ? n - beg : BATCH_SIZE);
+            prefetchGroup(vals + beg, cnt, h);
+            for (SizeType i = 0; i < cnt; ++i) {
+                res[beg + i] = table.find(vals[beg + i], h[i]) != Table::NPOS;
+            }
+        }
+    }
+
+    /*
+    Insert a value to the hash table. If the
+    value exists, this function does nothing.
+
+    @param val The value to be inserted
+    */
+    void insert(const Value& val) {
+        const std::uint64_t h = table.hashOf(val);
+        if (table.find(val, h) == Table::NPOS) {
+            table.insertNew(h, val);
+        }
+    }
+
+    // Same as insert(const Value&), but moves the value into the table
+    void insert(Value&& val) {
+        const std::uint64_t h = table.hashOf(val);
+        if (table.find(val, h) == Table::NPOS) {
+            table.insertNew(h, std::move(val));
+        }
+    }
+
+    /*
+    Insert a batch of values to the hash table. The slots are
+    prefetched in groups as in hasBatch().
+
+    @param vals The values to be inserted
+    @param n    The amount of values
+    */
+    void insertBatch(const Value *const vals, const SizeType n) {
+        std::uint64_t h[BATCH_SIZE];
+        for (SizeType beg = 0; beg < n; beg += BATCH_SIZE) {
+            const SizeType cnt = (n - beg < BATCH_SIZE ? n - beg : BATCH_SIZE);
+            prefetchGroup(vals + beg, cnt, h);
+            for (SizeType i = 0; i < cnt; ++i) {
+                if (table.find(vals[beg + i], h[i]) == Table::NPOS) {
+                    table.insertNew(h[i], vals[beg + i]);
+                }
+            }
+        }
+    }
+
+    /*
+    Remove a value from the hash table. If the
+    value doesn't exist, this function does nothing.
+
+    @param val The value to be removed
+    */
+    void remove(const Value& val) {
+        const SizeType pos = table.find(val, table.hashOf(val));
+        if (pos != Table::NPOS) {
+            table.erase(pos);
+        }
+    }
+
+    /*
+    Rehash the hash table. All tombstones left by remove() are dropped.
+
+    @param n Expected buckets amount. In practice, the amount of buckets
+             may be greater than 'n' since the table always keeps enough
+             buckets to hold its elements under the maximum load factor.
+    */
+    void rehash(const SizeType n) {
+        table.rehash(n);
+    }
+
+    /*
+    Traverse the values in no particular order.
+
+    @param f The function to traverse each value. Its param is the value.
+    */
+    template<typename Func>
+    void traverse(const Func& f) const {
+        table.traverse(f);
+    }
+
+private:
+    /*
+    Compute the hash values of a group of values and prefetch their slots.
+
+    @param vals The values
+    @param cnt  The amount of values, at most BATCH_SIZE
+    @param h    Output array of the hash values
+    */
+    void prefetchGroup(const Value *const vals, const SizeType cnt,
+                       std::uint64_t *const h) const {
+        for (SizeType i = 0; i < cnt; ++i) {
+            h[i] = table.hashOf(vals[i]);
+            table.prefetch(h[i]);
+        }
+    }
+
+private:
+    static const SizeType BATCH_SIZE = 16;
+
+    Table table;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,586 @@
+#ifndef TASTYLIB_FROZENHASHSET_H_
+#define TASTYLIB_FROZENHASHSET_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/hash.h"
+#include "tastylib/internal/MappedFile.h"
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+TASTYLIB_NS_BEGIN
+
+/*
+Write and read the values that are not trivially copyable in a snapshot of
+FrozenHashSet. Specialize it for other types to make their sets savable.
+*/
+template<typename Value>
+struct SnapshotIO;
+
+template<>
+struct SnapshotIO<std::string> {
+    // Write the length and then the characters of a string
+    static void write(std::ostream& out, const std::string& str) {
+        const std::uint64_t len = str.size();
+        out.write((const char*)&len, sizeof(len));
+        out.write(str.data(), (std::streamsize)len);
+    }
+
+    // Read a string written by write()
+    static std::string read(std::istream& in) {
+        std::uint64_t len = 0;
+        if (!in.read((char*)&len, sizeof(len))) {
+            return std::string();
+        }
+        std::string str((std::size_t)len, '\0');
+        in.read(&str[0], (std::streamsize)len);
+        return str;
+    }
+};
+
+/*
+A read-only set of unique elements built once from a batch of values. It
+answers has() with a single probe into one flat array of values.
+
+The set uses the CHD (compress, hash and displace) perfect hashing. The
+keys are split into buckets of about LAMBDA keys, and each bucket stores a
+16-bit displacement that sends its keys to distinct slots:
+
+    slot(key) = (f1(key) + disp[bucket(key)] * f2(key)) % slotNum
+
+The buckets are placed from the largest to the smallest, each one with the
+first displacement whose slots are all free. About 2% of the slots are left
+empty to keep the search short. Empty slots hold a copy of a stored value,
+so a lookup landing on one of them fails unless it looks for that value.
+
+A set can be saved to a snapshot file and loaded again without rebuilding
+the perfect hash. The file holds a versioned header, the displacements and
+the slot array. If 'Value' is trivially copyable, load() maps the file into
+memory and has() reads the mapping directly. Otherwise the values are
+written with SnapshotIO<Value> and copied in by load(). A snapshot can only
+be loaded with the same Hash, on a machine with the same byte order.
+
+@param Value    The type of the values stored in the set.
+@param PredCmp  A binary predicate that checks if two values are equal.
+@param Hash  A unary functor that computes the hash value of an element.
+             The hash values of distinct elements should rarely collide.
+*/
+template<typename Value, typename PredCmp = std::equal_to<Value>,
+         typename Hash = std::hash<Value>>
+class FrozenHashSet {
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Build the set from an array of values. Duplicated values are stored once.
+    Throw std::runtime_error if no perfect hash is found, which only happens
+    when the hash function maps many distinct values to the same hash value.
+
+    @param vals The values
+    @param n    The amount of values
+    @param cmp  The comparator
+    @param h    The hash function
+    */
+    FrozenHashSet(const Value *const vals, const SizeType n,
+                  const PredCmp& cmp = PredCmp(), const Hash& h = Hash())
+    : size(0), slotNum(0), bucketNum(0), seed(0), predCmp(cmp), hasher(h),
+      dispData(nullptr), slotData(nullptr) {
+        build(std::vector<Value>(vals, vals + n));
+    }
+
+    /*
+    Build the set from the values of a table, e.g. a HashTable
+    or a FlatHashTable that will only be read from now on.
+
+    @param table The table. It must provide traverse().
+    @param cmp   The comparator
+    @param h     The hash function
+    */
+    template<typename Table>
+    explicit FrozenHashSet(const Table& table,
+                           const PredCmp& cmp = PredCmp(), const Hash& h = Hash())
+    : size(0), slotNum(0), bucketNum(0), seed(0), predCmp(cmp), hasher(h),
+      dispData(nullptr), slotData(nullptr) {
+        std::vector<Value> vals;
+        vals.reserve(table.getSize());
+        table.traverse([&vals](const Value& val) {
+            vals.push_back(val);
+        });
+        build(std::move(vals));
+    }
+
+    // Forbid copy
+    FrozenHashSet(const FrozenHashSet&) = delete;
+    FrozenHashSet& operator=(const FrozenHashSet&) = delete;
+
+    // Move ctor
+    FrozenHashSet(FrozenHashSet&& other) noexcept
+    : size(other.size), slotNum(other.slotNum), bucketNum(other.bucketNum),
+      seed(other.seed), predCmp(std::move(other.predCmp)), hasher(std::move(other.hasher)),
+      disp(std::move(other.disp)), slots(std::move(other.slots)), file(std::move(other.file)),
+      dispData(other.dispData), slotData(other.slotData) {
+        other.reset();
+    }
+
+    // Move assignment
+    FrozenHashSet& operator=(FrozenHashSet&& other) noexcept {
+        if (this != &other) {
+            size = other.size;
+            slotNum = other.slotNum;
+            bucketNum = other.bucketNum;
+            seed = other.seed;
+            predCmp = std::move(other.predCmp);
+            hasher = std::move(other.hasher);
+            disp = std::move(other.disp);
+            slots = std::move(other.slots);
+            file = std::move(other.file);
+            dispData = other.dispData;
+            slotData = other.slotData;
+            other.reset();
+        }
+        return *this;
+    }
+
+    /*
+    Load a set from a snapshot file written by save(). Throw
+    std::runtime_error if the file can't be read or isn't a
+    snapshot of the same value type.
+
+    @param path The path of the snapshot
+    @param cmp  The comparator
+    @param h    The hash function. It must compute the same
+                hash values as the one used to build the set.
+    @return     The set
+    */
+    static FrozenHashSet load(const std::string& path,
+                              const PredCmp& cmp = PredCmp(), const Hash& h = Hash()) {
+        FrozenHashSet set(nullptr, 0, cmp, h);
+        set.loadSlots(path, IsTrivial());
+        return set;
+    }
+
+    /*
+    Save the set to a snapshot file. Throw
+    std::runtime_error if the file can't be written.
+
+    @param path The path of the snapshot
+    */
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("FrozenHashSet: cannot create " + path);
+        }
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, magic(), sizeof(header.magic));
+        header.version = VERSION;
+        header.trivial = IsTrivial::value;
+        header.valueSize = sizeof(Value);
+        header.size = size;
+        header.slotNum = slotNum;
+        header.bucketNum = bucketNum;
+        header.seed = seed;
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)dispData, (std::streamsize)(bucketNum * sizeof(std::uint16_t)));
+        const char zeros[ALIGN] = {};
+        out.write(zeros, (std::streamsize)(slotOffset() - sizeof(header) -
+                                           bucketNum * sizeof(std::uint16_t)));
+        writeSlots(out, IsTrivial());
+        if (!out) {
+            throw std::runtime_error("FrozenHashSet: cannot write " + path);
+        }
+    }
+
+    // Return true if the set is served from a memory-mapped snapshot
+    bool isMapped() const noexcept {
+        return file.isMapped();
+    }
+
+    // Return the amount of elements in the set
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return true if the set has no elements
+    bool isEmpty() const noexcept {
+        return size == 0;
+    }
+
+    // Return the amount of slots
+    SizeType getSlotCount() const noexcept {
+        return slotNum;
+    }
+
+    // Return the amount of buckets, i.e. the amount of 16-bit displacements
+    SizeType getBucketCount() const noexcept {
+        return bucketNum;
+    }
+
+    // Return true if a given value is in the set
+    bool has(const Value& val) const {
+        if (size == 0) {
+            return false;
+        }
+        const std::uint64_t h = hashOf(val);
+        return predCmp(slotData[slotOf(h, dispData[bucketOf(h)])], val);
+    }
+
+    /*
+    Traverse the values in no particular order.
+
+    @param f The function to traverse each value. Its param is the value.
+    */
+    template<typename Func>
+    void traverse(const Func& f) const {
+        for (SizeType i = 0; i < slotNum; ++i) {
+            const std::uint64_t h = hashOf(slotData[i]);
+            if (slotOf(h, dispData[bucketOf(h)]) == i) {  // Skip the empty slots
+                f(slotData[i]);
+            }
+        }
+    }
+
+private:
+    using IsTrivial = std::is_trivially_copyable<Value>;
+
+    // The header of a snapshot file
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t trivial;  // 1 if the slots are stored as raw bytes
+        std::uint64_t valueSize;
+        std::uint64_t size;
+        std::uint64_t slotNum;
+        std::uint64_t bucketNum;
+        std::uint64_t seed;
+        std::uint64_t reserved;
+    };
+
+    // Return the magic number at the beginning of a snapshot file
+    static const char* magic() noexcept {
+        return "TLFROZEN";
+    }
+
+    // Return the offset of the slot array in a snapshot file
+    SizeType slotOffset() const noexcept {
+        const SizeType end = sizeof(Header) + bucketNum * sizeof(std::uint16_t);
+        return (end + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+    // Write the slots of a trivially copyable type as raw bytes
+    void writeSlots(std::ostream& out, std::true_type) const {
+        out.write((const char*)slotData, (std::streamsize)(slotNum * sizeof(Value)));
+    }
+
+    void writeSlots(std::ostream& out, std::false_type) const {
+        for (SizeType i = 0; i < slotNum; ++i) {
+            SnapshotIO<Value>::write(out, slotData[i]);
+        }
+    }
+
+    /*
+    Check the header of a snapshot and take its fields. An empty set has
+    no slots, and any other set at least 2 since stepOf() divides by
+    slotNum - 1. The sizes are checked against the file without overflowing.
+
+    @param header   The header
+    @param fileSize Bytes of the snapshot file
+    @param path     The path of the snapshot, used in error messages
+    */
+    void readHeader(const Header& header, const SizeType fileSize, const std::string& path) {
+        if (std::memcmp(header.magic, magic(), sizeof(header.magic)) != 0 ||
+            header.version != VERSION || header.trivial != IsTrivial::value ||
+            (IsTrivial::value && header.valueSize != sizeof(Value)) ||
+            header.size > header.slotNum || (header.size > 0) != (header.bucketNum > 0) ||
+            (header.size > 0) != (header.slotNum > 0) || header.slotNum == 1 || header.bucketNum > header.slotNum) {
+            throw std::runtime_error("FrozenHashSet: invalid snapshot " + path);
+        }
+        if (header.bucketNum > (fileSize - sizeof(Header)) / sizeof(std::uint16_t)) {
+            throw std::runtime_error("FrozenHashSet: truncated snapshot " + path);
+        }
+        size = (SizeType)header.size;
+        slotNum = (SizeType)header.slotNum;
+        bucketNum = (SizeType)header.bucketNum;
+        seed = header.seed;
+        // Now slotOffset() can't overflow
+        if (slotOffset() > fileSize ||
+            (IsTrivial::value && slotNum > (fileSize - slotOffset()) / sizeof(Value))) {
+            throw std::runtime_error("FrozenHashSet: truncated snapshot " + path);
+        }
+    }
+
+    // Map a snapshot of trivially copyable values
+    void loadSlots(const std::string& path, std::true_type) {
+        MappedFile f(path);
+        Header header;
+        if (f.getSize() < sizeof(header)) {
+            throw std::runtime_error("FrozenHashSet: invalid snapshot " + path);
+        }
+        std::memcpy(&header, f.getData(), sizeof(header));
+        readHeader(header, f.getSize(), path);
+        dispData = (const std::uint16_t*)(f.getData() + sizeof(header));
+        slotData = (const Value*)(f.getData() + slotOffset());
+        file = std::move(f);
+    }
+
+    // Copy in a snapshot of values that are not trivially copyable
+    void loadSlots(const std::string& path, std::false_type) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw std::runtime_error("FrozenHashSet: cannot open " + path);
+        }
+        const SizeType fileSize = (SizeType)in.tellg();
+        in.seekg(0);
+        Header header;
+        if (!in.read((char*)&header, sizeof(header))) {
+            throw std::runtime_error("FrozenHashSet: invalid snapshot " + path);
+        }
+        readHeader(header, fileSize, path);
+        disp.resize(bucketNum);
+        in.read((char*)disp.data(), (std::streamsize)(bucketNum * sizeof(std::uint16_t)));
+        in.seekg((std::streamoff)slotOffset());
+        // A corrupt slot amount must not reserve more than the file can hold
+        slots.reserve(std::min(slotNum, fileSize - slotOffset()));
+        for (SizeType i = 0; i < slotNum && in; ++i) {
+            slots.push_back(SnapshotIO<Value>::read(in));
+        }
+        if (!in) {
+            throw std::runtime_error("FrozenHashSet: truncated snapshot " + path);
+        }
+        dispData = disp.data();
+        slotData = slots.data();
+    }
+
+    // Leave the set empty
+    void reset() noexcept {
+        size = 0;
+        slotNum = 0;
+        bucketNum = 0;
+        disp.clear();
+        slots.clear();
+        dispData = nullptr;
+        slotData = nullptr;
+    }
+
+    // Return the hash value of a value under the current seed
+    std::uint64_t hashOf(const Value& val) const {
+        return mixHash((std::uint64_t)hasher(val) ^ seed);
+    }
+
+    // Return the bucket of a hash value
+    SizeType bucketOf(const std::uint64_t h) const noexcept {
+        return (SizeType)(((h >> 32) * bucketNum) >> 32);
+    }
+
+    // Return the first slot (f1) of a hash value
+    SizeType firstSlot(const std::uint64_t h) const noexcept {
+        return (SizeType)((h & 0xffffffffULL) % slotNum);
+    }
+
+    // Return the step (f2) of a hash value, which is in [1, slotNum)
+    SizeType stepOf(const std::uint64_t h) const noexcept {
+        return (SizeType)(1 + mixHash(h) % (slotNum - 1));
+    }
+
+    // Return the slot of a hash value under a displacement
+    SizeType slotOf(const std::uint64_t h, const std::uint16_t d) const noexcept {
+        return (SizeType)((firstSlot(h) + (std::uint64_t)d * stepOf(h)) % slotNum);
+    }
+
+    /*
+    Build the perfect hash and move the values to their slots.
+
+    @param vals The values
+    */
+    void build(std::vector<Value>&& vals) {
+        if (vals.empty()) {
+            return;
+        }
+        // The slot amount is a prime so that every step visits all slots
+        slotNum = nextPrime(vals.size() + vals.size() / 50 + 3);
+        bucketNum = vals.size() / LAMBDA + 1;
+        std::vector<SizeType> pos;
+        for (SizeType attempt = 0; attempt < MAX_ATTEMPT; ++attempt) {
+            seed = mixHash(attempt + 1);
+            if (place(vals, pos)) {
+                fillSlots(vals, pos);
+                return;
+            }
+        }
+        throw std::runtime_error("FrozenHashSet: failed to build the perfect hash");
+    }
+
+    /*
+    Search a displacement for every bucket under the current seed.
+
+    @param vals The values
+    @param pos  Output param. pos[i] is the slot of vals[i],
+                or NPOS if vals[i] duplicates another value.
+    @return     True if all buckets are placed
+    */
+    bool place(const std::vector<Value>& vals, std::vector<SizeType>& pos) {
+        const SizeType n = vals.size();
+        std::vector<std::uint64_t> hashes(n);
+        std::vector<SizeType> start(bucketNum + 1, 0);
+        for (SizeType i = 0; i < n; ++i) {
+            hashes[i] = hashOf(vals[i]);
+            ++start[bucketOf(hashes[i]) + 1];
+        }
+
+        // Group the values by bucket, and the buckets by size in descending order
+        SizeType maxSize = 0;
+        for (SizeType b = 0; b < bucketNum; ++b) {
+            maxSize = start[b + 1] > maxSize ? start[b + 1] : maxSize;
+            start[b + 1] += start[b];
+        }
+        std::vector<SizeType> keys(n), fill(start.begin(), start.end() - 1);
+        for (SizeType i = 0; i < n; ++i) {
+            keys[fill[bucketOf(hashes[i])]++] = i;
+        }
+        std::vector<std::vector<SizeType>> bySize(maxSize + 1);
+        for (SizeType b = 0; b < bucketNum; ++b) {
+            bySize[start[b + 1] - start[b]].push_back(b);
+        }
+
+        disp.assign(bucketNum, 0);
+        pos.assign(n, (SizeType)NPOS);  // Copy NPOS since assign() binds a reference
+        std::vector<bool> taken(slotNum, false);
+        std::vector<SizeType> cur, step;
+        for (SizeType s = maxSize; s > 0; --s) {
+            for (const auto b : bySize[s]) {
+                // Drop duplicated values in the bucket
+                cur.clear();
+                step.clear();
+                for (SizeType j = start[b]; j < start[b + 1]; ++j) {
+                    const SizeType i = keys[j];
+                    bool dup = false;
+                    for (SizeType k = start[b]; k < j && !dup; ++k) {
+                        dup = hashes[keys[k]] == hashes[i] && predCmp(vals[keys[k]], vals[i]);
+                    }
+                    if (dup) {
+                        continue;
+                    }
+                    pos[i] = firstSlot(hashes[i]);
+                    cur.push_back(i);
+                    step.push_back(stepOf(hashes[i]));
+                }
+                if (!placeBucket(cur, step, pos, taken, disp[b])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*
+    Find the first displacement that sends all values
+    of a bucket to distinct free slots, and take the slots.
+
+    @param cur   The values of the bucket
+    @param step  The steps of the values
+    @param pos   Slots of the values. They hold the first slots
+                 on input and the chosen slots on success.
+    @param taken Flags of the occupied slots
+    @param res   Output param, the displacement
+    @return      True if a displacement is found
+    */
+    bool placeBucket(const std::vector<SizeType>& cur, const std::vector<SizeType>& step,
+                     std::vector<SizeType>& pos, std::vector<bool>& taken,
+                     std::uint16_t& res) const {
+        for (SizeType d = 0; d <= MAX_DISP; ++d) {
+            SizeType j = 0;
+            for (; j < cur.size() && !taken[pos[cur[j]]]; ++j) {
+                taken[pos[cur[j]]] = true;
+            }
+            if (j == cur.size()) {
+                res = (std::uint16_t)d;
+                return true;
+            }
+            // Release the slots taken in this round and try the next displacement
+            for (SizeType k = 0; k < j; ++k) {
+                taken[pos[cur[k]]] = false;
+            }
+            for (SizeType k = 0; k < cur.size(); ++k) {
+                pos[cur[k]] += step[k];
+                if (pos[cur[k]] >= slotNum) {
+                    pos[cur[k]] -= slotNum;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Move the values to their slots and fill the empty slots
+    void fillSlots(std::vector<Value>& vals, const std::vector<SizeType>& pos) {
+        std::vector<SizeType> owner(slotNum, (SizeType)NPOS);
+        for (SizeType i = 0; i < vals.size(); ++i) {
+            if (pos[i] != NPOS) {
+                owner[pos[i]] = i;
+                ++size;
+            }
+        }
+        const Value filler(vals[0]);  // vals[0] is never a duplicate
+        slots.reserve(slotNum);
+        for (SizeType i = 0; i < slotNum; ++i) {
+            if (owner[i] == NPOS) {
+                slots.push_back(filler);
+            } else {
+                slots.push_back(std::move(vals[owner[i]]));
+            }
+        }
+        dispData = disp.data();
+        slotData = slots.data();
+    }
+
+    // Return the smallest prime that is not less than 'n'
+    static SizeType nextPrime(SizeType n) noexcept {
+        for (;; ++n) {
+            bool prime = n > 1;
+            for (SizeType i = 2; i * i <= n && prime; ++i) {
+                prime = n % i != 0;
+            }
+            if (prime) {
+                return n;
+            }
+        }
+    }
+
+private:
+    static const SizeType LAMBDA = 4;         // Average amount of keys per bucket
+    static const SizeType MAX_DISP = 65535;   // Largest 16-bit displacement
+    static const SizeType MAX_ATTEMPT = 32;   // Amount of seeds to try
+    static const SizeType NPOS = (SizeType)-1;
+    static const SizeType ALIGN = 64;          // Alignment of the slot array in a snapshot
+    static const std::uint32_t VERSION = 1;    // Version of the snapshot format
+
+    SizeType size;
+    SizeType slotNum;
+    SizeType bucketNum;
+    std::uint64_t seed;
+
+    PredCmp predCmp;
+    Hash hasher;
+
+    // Storage of a set that is built or copied in
+    std::vector<std::uint16_t> disp;
+    std::vector<Value> slots;
+
+    // Storage of a set that is loaded from a memory-mapped snapshot
+    MappedFile file;
+
+    // The displacements and slots in use, pointing into one of the storages
+    const std::uint16_t *dispData;
+    const Value *slotData;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,321 @@
+#ifndef TASTYLIB_HASHMAP_H_
+#define TASTYLIB_HASHMAP_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/hash.h"
+#include "tastylib/internal/FlatTable.h"
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+TASTYLIB_NS_BEGIN
+
+/*
+Transparent hash function for std::string keys. Together with StringEqual,
+it lets a HashMap<std::string, T> be queried with a C string (or a
+std::string_view since C++17) without building a temporary std::string.
+It computes the 64-bit FNV-1a hash of the characters.
+*/
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(const std::string& s) const noexcept {
+        return hash(s.data(), s.size());
+    }
+
+    std::size_t operator()(const char *const s) const noexcept {
+        return hash(s, std::strlen(s));
+    }
+
+#if __cplusplus >= 201703L
+    std::size_t operator()(const std::string_view s) const noexcept {
+        return hash(s.data(), s.size());
+    }
+#endif
+
+private:
+    static std::size_t hash(const char *const s, const std::size_t n) noexcept {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= (unsigned char)s[i];
+            h *= 0x100000001b3ULL;
+        }
+        return (std::size_t)h;
+    }
+};
+
+/*
+Transparent comparator for std::string keys. See StringHash.
+*/
+struct StringEqual {
+    using is_transparent = void;
+
+    bool operator()(const std::string& a, const std::string& b) const noexcept {
+        return a == b;
+    }
+
+    bool operator()(const std::string& a, const char *const b) const noexcept {
+        return a.compare(b) == 0;
+    }
+
+#if __cplusplus >= 201703L
+    bool operator()(const std::string& a, const std::string_view b) const noexcept {
+        return a == b;
+    }
+#endif
+};
+
+/*
+A data structure that maps unique keys to values in no particular order.
+It is built on the same open addressing storage as FlatHashTable and keeps
+each key and its value together in one slot.
+
+If both PredCmp and Hash define the member type 'is_transparent', the lookup
+functions accept any key type that the two functors accept, so no temporary
+'Key' is built. Otherwise the argument is converted to 'Key' first.
+
+@param Key      The type of the keys.
+@param T        The type of the mapped values.
+@param PredCmp  A binary predicate that checks if two keys are equal.
+                It is called as PredCmp(storedKey, lookupKey).
+@param Hash  A unary functor that computes the hash value of a key. Equal
+             keys must have equal hash values, whatever their types are.
+*/
+template<typename Key, typename T, typename PredCmp = std::equal_to<Key>,
+         typename Hash = std::hash<Key>>
+class HashMap {
+public:
+    using SizeType = std::size_t;
+    using ValueType = std::pair<Key, T>;
+
+private:
+    struct KeyOf {
+        const Key& operator()(const ValueType& v) const noexcept {
+            return v.first;
+        }
+    };
+
+    using Table = FlatTable<ValueType, KeyOf, PredCmp, Hash>;
+
+    // The type used to look up a key of type 'K'
+    template<typename K>
+    using LookupKey = typename std::conditional<
+        IsTransparent<PredCmp>::value && IsTransparent<Hash>::value,
+        K, Key>::type;
+
+public:
+    /*
+    Initialize the hash map.
+
+    @param n   Expected buckets amount. In practice, the
+               amount of buckets may be greater than 'n'
+    @param cmp The comparator
+    @param h   The hash function
+    */
+    explicit HashMap(const SizeType n = Table::MIN_BUCKET,
+                     const PredCmp& cmp = PredCmp(),
+                     const Hash& h = Hash())
+    : table(n, cmp, h) {}
+
+    // Return the amount of elements in the hash map
+    SizeType getSize() const noexcept {
+        return table.getSize();
+    }
+
+    // Return true if the hash map has no elements
+    bool isEmpty() const noexcept {
+        return table.getSize() == 0;
+    }
+
+    // Return the amount of buckets
+    SizeType getBucketCount() const noexcept {
+        return table.getBucketCount();
+    }
+
+    // Remove all elements from the hash map
+    void clear() noexcept {
+        table.clear();
+    }
+
+    // Return true if a given key is in the hash map
+    template<typename K>
+    bool has(const K& key) const {
+        std::uint64_t h;
+        return findPos(key, h) != Table::NPOS;
+    }
+
+    /*
+    Find the value mapped to a key.
+
+    @param key The key
+    @return    A pointer to the value. If the key doesn't exist, return nullptr.
+    */
+    template<typename K>
+    T* find(const K& key) {
+        std::uint64_t h;
+        const SizeType pos = findPos(key, h);
+        return pos == Table::NPOS ? nullptr : &table.at(pos).second;
+    }
+
+    template<typename K>
+    const T* find(const K& key) const {
+        std::uint64_t h;
+        const SizeType pos = findPos(key, h);
+        return pos == Table::NPOS ? nullptr : &table.at(pos).second;
+    }
+
+    /*
+    Return the value mapped to a key. Throw
+    std::out_of_range if the key doesn't exist.
+
+    @param key The key
+    */
+    template<typename K>
+    T& at(const K& key) {
+        T *val = find(key);
+        if (!val) {
+            throw std::out_of_range("HashMap::at(): key not found");
+        }
+        return *val;
+    }
+
+    template<typename K>
+    const T& at(const K& key) const {
+        const T *val = find(key);
+        if (!val) {
+            throw std::out_of_range("HashMap::at(): key not found");
+        }
+        return *val;
+    }
+
+    /*
+    Return the value mapped to a key. If the key doesn't
+    exist, a value-initialized value is inserted first.
+    */
+    T& operator[](const Key& key) {
+        return *tryEmplace(key).first;
+    }
+
+    T& operator[](Key&& key) {
+        return *tryEmplace(std::move(key)).first;
+    }
+
+    /*
+    Construct an element in place. The element is always constructed to
+    find its key, and then discarded if the key already exists.
+
+    @param args The arguments to construct a std::pair<Key, T>
+    @return     A pointer to the value mapped to the key of the element,
+                and true if the element was inserted.
+    */
+    template<typename... Args>
+    std::pair<T*, bool> emplace(Args&&... args) {
+        ValueType val(std::forward<Args>(args)...);
+        const std::uint64_t h = table.hashOf(val.first);
+        SizeType pos = table.find(val.first, h);
+        if (pos != Table::NPOS) {
+            return std::make_pair(&table.at(pos).second, false);
+        }
+        pos = table.insertNew(h, std::move(val));
+        return std::make_pair(&table.at(pos).second, true);
+    }
+
+    /*
+    Insert an element if a key doesn't exist. Unlike emplace(), nothing
+    is constructed or moved from the arguments if the key exists.
+
+    @param key  The key
+    @param args The arguments to construct the value
+    @return     A pointer to the value mapped to the key,
+                and true if the element was inserted.
+    */
+    template<typename K, typename... Args>
+    std::pair<T*, bool> tryEmplace(K&& key, Args&&... args) {
+        std::uint64_t h;
+        SizeType pos = findPos(key, h);
+        if (pos != Table::NPOS) {
+            return std::make_pair(&table.at(pos).second, false);
+        }
+        pos = table.insertNew(h, std::piecewise_construct,
+                              std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(&table.at(pos).second, true);
+    }
+
+    /*
+    Remove a key and its value from the hash map. If
+    the key doesn't exist, this function does nothing.
+
+    @param key The key to be removed
+    */
+    template<typename K>
+    void remove(const K& key) {
+        std::uint64_t h;
+        const SizeType pos = findPos(key, h);
+        if (pos != Table::NPOS) {
+            table.erase(pos);
+        }
+    }
+
+    /*
+    Rehash the hash map.
+
+    @param n Expected buckets amount. In practice, the
+             amount of buckets may be greater than 'n'.
+    */
+    void rehash(const SizeType n) {
+        table.rehash(n);
+    }
+
+    /*
+    Traverse the elements in no particular order.
+
+    @param f The function to traverse each element. Params are:
+             @param key The key of the element
+             @param val The value of the element
+    */
+    template<typename Func>
+    void traverse(const Func& f) {
+        table.traverse([&f](ValueType& v) {
+            f((const Key&)v.first, v.second);
+        });
+    }
+
+    template<typename Func>
+    void traverse(const Func& f) const {
+        table.traverse([&f](const ValueType& v) {
+            f(v.first, v.second);
+        });
+    }
+
+private:
+    /*
+    Find the slot of a key.
+
+    @param key The key to be found
+    @param h   Output param, the hash value of the key
+    @return    The index of the slot. If the key doesn't exist, return NPOS.
+    */
+    template<typename K>
+    SizeType findPos(const K& key, std::uint64_t& h) const {
+        const LookupKey<K> &k = key;  // A temporary 'Key' unless transparent
+        h = table.hashOf(k);
+        return table.find(k, h);
+    }
+
+private:
+    Table table;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -5,9 +5,160 @@
 #include "tastylib/DoublyLinkedList.h"
 #include <vector>
 #include <utility>
+#include <chrono>
+#include <cstddef>
 
 TASTYLIB_NS_BEGIN
 
+/*
+Statistics of a HashTable, returned by HashTable::getStats().
+
+The histogram and the longest chain are computed from the buckets when
+the statistics are requested. The lookup and rehash counters are only
+maintained if the table enables them with its 'Stats' template argument.
+*/
+struct HashTableStats {
+    std::vector<std::size_t> histogram;  // histogram[i] is the amount of buckets holding i elements
+    std::size_t longestChain = 0;
+    std::size_t hits = 0;                // Amount of successful lookups
+    std::size_t misses = 0;              // Amount of unsuccessful lookups
+    double avgProbesHit = 0;             // Average elements compared per successful lookup
+    double avgProbesMiss = 0;            // Average elements compared per unsuccessful lookup
+    std::size_t rehashCount = 0;
+    double rehashTime = 0;               // Milliseconds spent rehashing
+};
+
+/*
+The lookup and rehash counters of a HashTable. When disabled, every
+function is an empty inline function that the compiler removes.
+*/
+template<bool Enabled>
+class HashTableCounter {
+public:
+    void countLookup(const bool found, const std::size_t probes) noexcept {
+        UNUSED(found);
+        UNUSED(probes);
+    }
+
+    void countRehash() noexcept {}
+
+    template<typename Func>
+    void timeRehash(const Func& f) {
+        f();
+    }
+
+    void fill(HashTableStats& stats) const noexcept {
+        UNUSED(stats);
+    }
+
+    void reset() noexcept {}
+};
+
+template<>
+class HashTableCounter<true> {
+public:
+    HashTableCounter() noexcept {
+        reset();
+    }
+
+    /*
+    Count a lookup.
+
+    @param found  True if the lookup is successful
+    @param probes The amount of elements compared
+    */
+    void countLookup(const bool found, const std::size_t probes) noexcept {
+        if (found) {
+            ++hits;
+            hitProbes += probes;
+        } else {
+            ++misses;
+            missProbes += probes;
+        }
+    }
+
+    // Count a rehash
+    void countRehash() noexcept {
+        ++rehashCount;
+    }
+
+    // Run a part of a rehash and add its time cost to the rehash time
+    template<typename Func>
+    void timeRehash(const Func& f) {
+        const auto beg = std::chrono::steady_clock::now();
+        f();
+        rehashTime += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - beg).count();
+    }
+
+    // Copy the counters to the statistics
+    void fill(HashTableStats& stats) const noexcept {
+        stats.hits = hits;
+        stats.misses = misses;
+        stats.avgProbesHit = hits ? (double)hitProbes / hits : 0;
+        stats.avgProbesMiss = misses ? (double)missProbes / misses : 0;
+        stats.rehashCount = rehashCount;
+        stats.rehashTime = rehashTime;
+    }
+
+    // Reset all counters
+    void reset() noexcept {
+        hits = misses = hitProbes = missProbes = rehashCount = 0;
+        rehashTime = 0;
+    }
+
+private:
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t hitProbes;
+    std::size_t missProbes;
+    std::size_t rehashCount;
+    double rehashTime;
+};
+
+/*
+An element stored in the buckets of HashTable. If 'Cached' is true,
+the element keeps the hash value of its value next to it.
+*/
+template<typename Value, bool Cached>
+struct HashEntry {
+    Value val;
+
+    HashEntry(const Value& v, const std::size_t h) : val(v) {
+        UNUSED(h);
+    }
+
+    // Return the hash value of the element
+    template<typename Hash>
+    std::size_t hashOf(const Hash& hasher) const {
+        return hasher(val);
+    }
+
+    // Return false if the element surely doesn't have a given hash value
+    bool mayHash(const std::size_t h) const noexcept {
+        UNUSED(h);
+        return true;
+    }
+};
+
+template<typename Value>
+struct HashEntry<Value, true> {
+    Value val;
+    std::size_t hash;
+
+    HashEntry(const Value& v, const std::size_t h) : val(v), hash(h) {}
+
+    template<typename Hash>
+    std::size_t hashOf(const Hash& hasher) const noexcept {
+        UNUSED(hasher);
+        return hash;
+    }
+
+    bool mayHash(const std::size_t h) const noexcept {
+        return hash == h;
+    }
+};
+
 /*
 A data structure that stores unique elements in no particular order,
 and which allows for fast retrieval of individual elements based on
@@ -18,13 +169,20 @@ their values.
                 If PredCmp(a, b) == true, then value 'a' and value 'b' are
                 considered equal.
 @param Hash  A unary functor that computes the hash value of an element.
+@param Stats If true, the table counts the probes of its lookups and the
+             time of its rehashes for getStats(). It costs nothing if false.
+@param CacheHash If true, each element stores its hash value. Rehashing
+                 reuses the stored values instead of calling Hash, and
+                 lookups only call PredCmp on elements with the same hash
+                 value. It pays off when Hash or PredCmp is expensive.
 */
 template<typename Value, typename PredCmp = std::equal_to<Value>,
-         typename Hash = std::hash<Value>>
+         typename Hash = std::hash<Value>, bool Stats = false, bool CacheHash = false>
 class HashTable {
 public:
     using SizeType = std::size_t;
-    using Container = std::vector<DoublyLinkedList<Value>>;
+    using Entry = HashEntry<Value, CacheHash>;
+    using Container = std::vector<DoublyLinkedList<Entry>>;
 
     /*
     Initialize the hash table.
@@ -37,7 +195,8 @@ public:
     explicit HashTable(const SizeType n = MIN_BUCKET,
                        const PredCmp& cmp = PredCmp(),
                        const Hash& h = Hash())
-    : size(0), bucketNum(0), predCmp(cmp), hasher(h) {
+    : size(0), bucketNum(0), oldBucketNum(0), migrated(0),
+      maxLoadFactor(1.0f), incremental(false), predCmp(cmp), hasher(h) {
         rehash(n);
     }
 
@@ -51,9 +210,57 @@ public:
         return size == 0;
     }
 
+    // Return the amount of buckets
+    SizeType getBucketCount() const noexcept {
+        return bucketNum;
+    }
+
+    // Return the average amount of elements per bucket
+    float getLoadFactor() const noexcept {
+        return (float)size / bucketNum;
+    }
+
+    // Return the maximum load factor
+    float getMaxLoadFactor() const noexcept {
+        return maxLoadFactor;
+    }
+
+    /*
+    Set the maximum load factor. When insert() makes the load factor
+    exceed it, the amount of buckets is doubled. The default value is 1.
+
+    @param f The maximum load factor. If f <= 0, the
+             table never grows automatically.
+    */
+    void setMaxLoadFactor(const float f) noexcept {
+        maxLoadFactor = f;
+    }
+
+    /*
+    Enable or disable the incremental rehash mode. In this mode, growing
+    the table only allocates the new buckets. The elements in the old
+    buckets are moved REHASH_STEP buckets at a time by each following
+    insert() and remove(), so no single operation pays for a full rehash.
+    Disabling the mode finishes any rehash in progress.
+
+    @param enable True to enable the incremental rehash mode
+    */
+    void setIncrementalRehash(const bool enable) {
+        incremental = enable;
+        if (!incremental) {
+            finishRehash();
+        }
+    }
+
+    // Return true if an incremental rehash is in progress
+    bool isRehashing() const noexcept {
+        return oldBucketNum != 0;
+    }
+
     // Remove all elements from the hash table
     void clear() {
         size = 0;
+        dropOldBuckets();
         for (SizeType i = 0; i < bucketNum; ++i) {
             buckets[i].clear();
         }
@@ -61,8 +268,28 @@ public:
 
     // Return true if a given value is in the hash table
     bool has(const Value& val) const {
-        const auto &list = buckets[hash(val)];
-        return list.find(val, predCmp) != -1;
+        return find(val, hasher(val));
+    }
+
+    /*
+    Check whether each value of a batch is in the hash table. The values
+    are processed in groups. The buckets of a whole group are prefetched
+    before any of them is searched, so the cache misses of the group
+    overlap instead of being paid one after another.
+
+    @param vals The values to be found
+    @param n    The amount of values
+    @param res  Output array. res[i] is true if vals[i] is in the hash table.
+    */
+    void hasBatch(const Value *const vals, const SizeType n, bool *const res) const {
+        SizeType h[BATCH_SIZE];
+        for (SizeType beg = 0; beg < n; beg += BATCH_SIZE) {
+            const SizeType cnt = (n - beg < BATCH_SIZE ? n - beg : BATCH_SIZE);
+            prefetchGroup(vals + beg, cnt, h);
+            for (SizeType i = 0; i < cnt; ++i) {
+                res[beg + i] = find(vals[beg + i], h[i]);
+            }
+        }
     }
 
     /*
@@ -72,10 +299,24 @@ public:
     @param val The value to be inserted
     */
     void insert(const Value& val) {
-        auto &list = buckets[hash(val)];
-        if (list.find(val) == -1) {
-            list.insertBack(val);
-            ++size;
+        insert(val, hasher(val));
+    }
+
+    /*
+    Insert a batch of values to the hash table. The buckets are
+    prefetched in groups as in hasBatch().
+
+    @param vals The values to be inserted
+    @param n    The amount of values
+    */
+    void insertBatch(const Value *const vals, const SizeType n) {
+        SizeType h[BATCH_SIZE];
+        for (SizeType beg = 0; beg < n; beg += BATCH_SIZE) {
+            const SizeType cnt = (n - beg < BATCH_SIZE ? n - beg : BATCH_SIZE);
+            prefetchGroup(vals + beg, cnt, h);
+            for (SizeType i = 0; i < cnt; ++i) {
+                insert(vals[beg + i], h[i]);
+            }
         }
     }
 
@@ -86,8 +327,10 @@ public:
     @param val The value to be removed
     */
     void remove(const Value& val) {
-        auto &list = buckets[hash(val)];
-        auto pos = list.find(val);
+        rehashStep();
+        const SizeType h = hasher(val);
+        auto &list = bucketOf(h);
+        auto pos = findIn(list, val, h);
         if (pos != -1) {
             list.remove(pos);
             --size;
@@ -95,49 +338,263 @@ public:
     }
 
     /*
-    Rehash the hash table.
+    Traverse the values in no particular order.
+
+    @param f The function to traverse each value. Its param is the value.
+    */
+    template<typename Func>
+    void traverse(const Func& f) const {
+        for (const auto &list : buckets) {
+            list.traverse([&f](const SizeType pos, const Entry& e) {
+                UNUSED(pos);
+                f(e.val);
+            });
+        }
+        for (SizeType i = migrated; i < oldBucketNum; ++i) {
+            oldBuckets[i].traverse([&f](const SizeType pos, const Entry& e) {
+                UNUSED(pos);
+                f(e.val);
+            });
+        }
+    }
+
+    /*
+    Rehash the hash table in one pass. If an incremental
+    rehash is in progress, it is finished first.
 
     @param n Expected buckets amount. In practice, the
              amount of buckets may be greater than 'n'.
     */
     void rehash(const SizeType n) {
-        size = 0;
-        SizeType oldNum = bucketNum;
-        bucketNum = MIN_BUCKET;
-        while (bucketNum < n) {
-            bucketNum <<= 1;
-        }
-        Container oldBuckets = std::move(buckets);
-        buckets.resize(bucketNum);
-        for (SizeType i = 0; i < oldNum; ++i) {
-            oldBuckets[i].traverse([&](const SizeType pos, const Value& val) {
-                UNUSED(pos);
-                insert(val);
-            });
+        finishRehash();
+        const SizeType oldNum = bucketNum;
+        if (oldNum) {  // Not the initialization
+            counter.countRehash();
+        }
+        counter.timeRehash([&]() {
+            bucketNum = MIN_BUCKET;
+            while (bucketNum < n) {
+                bucketNum <<= 1;
+            }
+            Container old = std::move(buckets);
+            buckets.clear();
+            buckets.resize(bucketNum);
+            for (SizeType i = 0; i < oldNum; ++i) {
+                moveBucket(old[i]);
+            }
+        });
+    }
+
+    /*
+    Return the statistics of the hash table. The histogram and the longest
+    chain take O(n) time to compute. The lookup and rehash counters are
+    zero unless the 'Stats' template argument is true.
+    */
+    HashTableStats getStats() const {
+        HashTableStats stats;
+        auto count = [&stats](const DoublyLinkedList<Entry>& list) {
+            const SizeType len = list.getSize();
+            if (len >= stats.histogram.size()) {
+                stats.histogram.resize(len + 1, 0);
+            }
+            ++stats.histogram[len];
+            stats.longestChain = len > stats.longestChain ? len : stats.longestChain;
+        };
+        for (const auto &list : buckets) {
+            count(list);
+        }
+        for (SizeType i = migrated; i < oldBucketNum; ++i) {
+            count(oldBuckets[i]);
         }
+        counter.fill(stats);
+        return stats;
+    }
+
+    // Reset the lookup and rehash counters
+    void resetStats() noexcept {
+        counter.reset();
     }
 
 private:
     /*
-    The function to compute the hash value of an element.
+    Find a value whose hash value has been computed.
+
+    @param val The value to be found
+    @param h   The hash value of 'val'
+    @return    True if the value is in the hash table
+    */
+    bool find(const Value& val, const SizeType h) const {
+        const auto &list = bucketOf(h);
+        const int pos = findIn(list, val, h);
+        counter.countLookup(pos != -1, pos != -1 ? (SizeType)pos + 1 : list.getSize());
+        return pos != -1;
+    }
+
+    /*
+    Find a value in a bucket.
+
+    @param list The bucket
+    @param val  The value to be found
+    @param h    The hash value of 'val'
+    @return     The position of the value in the bucket. If
+                the value doesn't exist, return -1.
+    */
+    int findIn(const DoublyLinkedList<Entry>& list, const Value& val, const SizeType h) const {
+        return list.findIf([&](const Entry& e) {
+            return e.mayHash(h) && predCmp(e.val, val);
+        });
+    }
+
+    /*
+    Insert a value whose hash value has been computed.
+
+    @param val The value to be inserted
+    @param h   The hash value of 'val'
+    */
+    void insert(const Value& val, const SizeType h) {
+        rehashStep();
+        auto &list = bucketOf(h);
+        if (findIn(list, val, h) == -1) {
+            list.insertBack(Entry(val, h));
+            ++size;
+            if (maxLoadFactor > 0 && size > bucketNum * maxLoadFactor) {
+                grow();
+            }
+        }
+    }
+
+    /*
+    The function to compute the bucket index of a hash value.
+
+    @param h   The hash value
+    @param num The amount of buckets
+    @return The bucket index
+    */
+    static SizeType indexOf(const SizeType h, const SizeType num) noexcept {
+        return h & (num - 1);
+    }
+
+    /*
+    Return the bucket that holds the values of a given hash value. During
+    an incremental rehash, a value stays in the old buckets until its old
+    bucket has been moved to the new buckets.
 
-    @param val The element
-    @return The hash value of the element
+    @param h The hash value
     */
-    SizeType hash(const Value& val) const {
-        return (SizeType)(hasher(val) & (bucketNum - 1));
+    const DoublyLinkedList<Entry>& bucketOf(const SizeType h) const {
+        if (isRehashing()) {
+            SizeType i = indexOf(h, oldBucketNum);
+            if (i >= migrated) {
+                return oldBuckets[i];
+            }
+        }
+        return buckets[indexOf(h, bucketNum)];
+    }
+
+    DoublyLinkedList<Entry>& bucketOf(const SizeType h) {
+        return const_cast<DoublyLinkedList<Entry>&>(
+            static_cast<const HashTable*>(this)->bucketOf(h));
+    }
+
+    /*
+    Compute the hash values of a group of values and prefetch their
+    buckets. The first pass fetches the list headers in the bucket array,
+    and the second pass fetches the first node of each list.
+
+    @param vals The values
+    @param cnt  The amount of values, at most BATCH_SIZE
+    @param h    Output array of the hash values
+    */
+    void prefetchGroup(const Value *const vals, const SizeType cnt, SizeType *const h) const {
+        for (SizeType i = 0; i < cnt; ++i) {
+            h[i] = hasher(vals[i]);
+            TASTYLIB_PREFETCH(&bucketOf(h[i]));
+        }
+        for (SizeType i = 0; i < cnt; ++i) {
+            bucketOf(h[i]).prefetchFront();
+        }
+    }
+
+    // Double the amount of buckets
+    void grow() {
+        if (incremental) {
+            finishRehash();
+            counter.countRehash();
+            counter.timeRehash([&]() {
+                oldBuckets = std::move(buckets);
+                oldBucketNum = bucketNum;
+                migrated = 0;
+                bucketNum <<= 1;
+                buckets.clear();
+                buckets.resize(bucketNum);
+            });
+        } else {
+            rehash(bucketNum << 1);
+        }
+    }
+
+    // Move the elements in a bucket to the current buckets
+    void moveBucket(DoublyLinkedList<Entry>& list) {
+        while (!list.isEmpty()) {
+            const SizeType h = list.front().hashOf(hasher);
+            list.spliceFrontTo(buckets[indexOf(h, bucketNum)]);
+        }
+    }
+
+    // Move a few old buckets if an incremental rehash is in progress
+    void rehashStep() {
+        if (!isRehashing()) {
+            return;
+        }
+        counter.timeRehash([&]() {
+            for (SizeType i = 0; i < REHASH_STEP && isRehashing(); ++i) {
+                moveBucket(oldBuckets[migrated]);
+                if (++migrated == oldBucketNum) {
+                    dropOldBuckets();
+                }
+            }
+        });
+    }
+
+    // Move all remaining old buckets
+    void finishRehash() {
+        while (isRehashing()) {
+            rehashStep();
+        }
+    }
+
+    // Release the old buckets of an incremental rehash
+    void dropOldBuckets() {
+        Container().swap(oldBuckets);
+        oldBucketNum = 0;
+        migrated = 0;
     }
 
 private:
     static const SizeType MIN_BUCKET = 8;
+    static const SizeType REHASH_STEP = 2;
+    static const SizeType BATCH_SIZE = 16;
 
     SizeType size;
     SizeType bucketNum;
 
+    /*
+    State of an incremental rehash. The old buckets
+    in [0, migrated) have been moved to 'buckets'.
+    */
+    SizeType oldBucketNum;
+    SizeType migrated;
+
+    float maxLoadFactor;
+    bool incremental;
+
     PredCmp predCmp;
     Hash hasher;
 
     Container buckets;
+    Container oldBuckets;
+
+    mutable HashTableCounter<Stats> counter;  // Updated by const lookups
 };
 
 TASTYLIB_NS_END
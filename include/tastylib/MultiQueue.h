@@ -0,0 +1,202 @@
+#ifndef TASTYLIB_MULTIQUEUE_H_
+#define TASTYLIB_MULTIQUEUE_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/hash.h"
+#include "tastylib/BinaryHeap.h"
+#include <functional>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A relaxed priority queue that can be shared by many threads.
+
+The elements are spread over c * P BinaryHeaps, where P is the amount of
+threads, and each heap is guarded by its own mutex. push() adds an element
+to a random heap. pop() locks a few random heaps with try_lock(), never
+waiting for a busy one, and removes the best root among them. So pop()
+returns an element close to the best one, but not always the best one.
+
+The amount of heaps sampled by each pop() is the quality knob. Sampling
+more heaps lowers the rank error, i.e. how many better elements are still
+in the queue when an element is popped, and costs more locking. With one
+heap the queue is exact.
+
+@param Value   The type of the value stored in the queue
+@param PredCmp The type of the binary predicate to arrange the nodes.
+               It has the same meaning as in BinaryHeap.
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+class MultiQueue {
+public:
+    using SizeType = std::size_t;
+
+    static const SizeType DEFAULT_FACTOR = 2;
+    static const SizeType DEFAULT_CHOICES = 2;
+
+    /*
+    Initialize the queue.
+
+    @param threads The amount of threads that share the queue
+    @param factor  Amount of heaps per thread (c)
+    @param choices Amount of heaps sampled by each pop(). At least 1.
+    @param cmp     The comparator
+    */
+    explicit MultiQueue(const SizeType threads = std::thread::hardware_concurrency(),
+                        const SizeType factor = DEFAULT_FACTOR,
+                        const SizeType choices = DEFAULT_CHOICES,
+                        const PredCmp& cmp = PredCmp())
+    : heapNum(threads * factor > 0 ? threads * factor : 1),
+      choiceNum(choices > 0 ? choices : 1), predCmp(cmp), size(0) {
+        heaps.reset(new Heap[heapNum]);
+        for (SizeType i = 0; i < heapNum; ++i) {
+            heaps[i].heap = BinaryHeap<Value, PredCmp>(cmp);
+        }
+    }
+
+    // Forbid copy
+    MultiQueue(const MultiQueue&) = delete;
+    MultiQueue& operator=(const MultiQueue&) = delete;
+
+    /*
+    Return the amount of elements in the queue. If other threads
+    are modifying the queue, the result is approximate.
+    */
+    SizeType getSize() const noexcept {
+        return size.load(std::memory_order_relaxed);
+    }
+
+    // Return true if the queue has no elements
+    bool isEmpty() const noexcept {
+        return getSize() == 0;
+    }
+
+    // Return the amount of heaps
+    SizeType getHeapCount() const noexcept {
+        return heapNum;
+    }
+
+    // Insert a new element to the queue
+    void push(const Value& val) {
+        Value copy(val);
+        push(std::move(copy));
+    }
+
+    void push(Value&& val) {
+        while (true) {
+            Heap &h = heaps[randomIndex()];
+            if (h.lock.try_lock()) {
+                h.heap.push(std::move(val));
+                size.fetch_add(1, std::memory_order_relaxed);
+                h.lock.unlock();
+                return;
+            }
+        }
+    }
+
+    /*
+    Remove an element close to the best one and return it.
+
+    @param val Set to the removed element
+    @return    False if the queue is empty
+    */
+    bool tryPop(Value& val) {
+        while (getSize() > 0) {
+            for (SizeType attempt = 0; attempt < MAX_ATTEMPT; ++attempt) {
+                if (popSampled(val)) {
+                    return true;
+                }
+            }
+            // The sampled heaps are busy or empty. Look at every heap.
+            if (popAny(val)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    /*
+    Lock up to 'choiceNum' random heaps that are free, and pop the best
+    root among them.
+
+    @return False if all sampled heaps were busy or empty
+    */
+    bool popSampled(Value& val) {
+        Heap *best = nullptr;
+        for (SizeType k = 0; k < choiceNum; ++k) {
+            Heap *h = &heaps[randomIndex()];
+            if (h == best || !h->lock.try_lock()) {
+                continue;
+            }
+            if (!h->heap.isEmpty() &&
+                (!best || predCmp(h->heap.top(), best->heap.top()))) {
+                if (best) {
+                    best->lock.unlock();
+                }
+                best = h;
+            } else {
+                h->lock.unlock();
+            }
+        }
+        if (!best) {
+            return false;
+        }
+        val = best->heap.popValue();
+        size.fetch_sub(1, std::memory_order_relaxed);
+        best->lock.unlock();
+        return true;
+    }
+
+    // Pop the root of the first non-empty heap
+    bool popAny(Value& val) {
+        for (SizeType i = 0; i < heapNum; ++i) {
+            std::lock_guard<std::mutex> guard(heaps[i].lock);
+            if (!heaps[i].heap.isEmpty()) {
+                val = heaps[i].heap.popValue();
+                size.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Return a random heap index from a generator owned by the calling thread
+    SizeType randomIndex() const noexcept {
+        static std::atomic<std::uint64_t> seeds(0);
+        thread_local std::uint64_t state = mixHash(seeds.fetch_add(1) + 1);
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        const std::uint64_t r = state * 0x2545f4914f6cdd1dULL;
+        return (SizeType)(((r >> 32) * heapNum) >> 32);
+    }
+
+private:
+    // Amount of rounds of sampling before a pop() looks at every heap
+    static const SizeType MAX_ATTEMPT = 8;
+
+    struct Heap {
+        std::mutex lock;
+        BinaryHeap<Value, PredCmp> heap;
+        char pad[64];  // Keep the locks of adjacent heaps on different cache lines
+    };
+
+    SizeType heapNum;
+    SizeType choiceNum;
+    PredCmp predCmp;
+    std::unique_ptr<Heap[]> heaps;
+    std::atomic<SizeType> size;
+};
+
+TASTYLIB_NS_END
+
+#endif
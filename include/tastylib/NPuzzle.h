@@ -3,13 +3,14 @@
 
 #include "tastylib/internal/base.h"
 #include "tastylib/util/random.h"
-#include "tastylib/HashTable.h"
+#include "tastylib/HashMap.h"
 #include "tastylib/BinaryHeap.h"
 #include <vector>
 #include <sstream>
 #include <string>
 #include <list>
 #include <utility>
+#include <cstdint>
 
 TASTYLIB_NS_BEGIN
 
@@ -163,9 +164,14 @@ private:
         return val;
     }
 
-    // Return the hash value of the node
-    SizeType hash() const {
-        return std::hash<std::string>()(toString());
+    // Return the hash value of the node (FNV-1a over the tiles)
+    SizeType hash() const noexcept {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (const auto v : val) {
+            h ^= (std::uint64_t)v;
+            h *= 0x100000001b3ULL;
+        }
+        return (SizeType)h;
     }
 
     /*
@@ -284,28 +290,17 @@ public:
     using SizeType = Node::SizeType;
 
     NPuzzle(const Node& beg_, const Node& end_)
-        : beg(beg_), end(end_), closeList(1000000) {}
+        : beg(beg_), end(end_), states(1000000) {}
 
     void solve() {
         std::vector<SizeType> index = buildIndex();
         searchCnt = 0;
-        openList.push(&beg);
+        states.tryEmplace(&beg, openList.push(&beg));
         while (!openList.isEmpty()) {
-            Node *cur = nullptr;
-            do {
-                // Loop until the open list is empty or a node
-                // that is not in the close list is found.
-                cur = openList.top();
-                openList.pop();
-            } while (!openList.isEmpty() && closeList.has(cur));
-            if (openList.isEmpty() && closeList.has(cur)) {
-                // If all the nodes in the open list is in the
-                // close list, then there is no available path
-                // between the two nodes.
-                return;
-            }
+            Node *cur = openList.top();
+            openList.pop();
+            *states.find(cur) = CLOSED;
             ++searchCnt;
-            closeList.insert(cur);
             if (*cur == end) {
                 buildPath(cur);
                 freeResources();
@@ -316,15 +311,24 @@ public:
                 if (cur->canMove(d)) {
                     Node *adj = cur->getNeighbor(d);
                     alloc.push_back(adj);
-                    if (!closeList.has(adj)) {
-                        adj->setParent(cur);
-                        adj->setG(cur->getG() + 1);
+                    adj->setParent(cur);
+                    adj->setG(cur->getG() + 1);
+                    auto state = states.find(adj);
+                    if (!state) {
                         adj->setH(adj->heuristic(&end, index));
-                        openList.push(adj);
+                        states.tryEmplace(adj, openList.push(adj));
+                    } else if (*state != CLOSED) {
+                        // The node is already in the open list. Keep the shorter path.
+                        const Node *old = openList.get(*state);
+                        if (adj->getG() < old->getG()) {
+                            adj->setH(old->getH());
+                            openList.decreaseKey(*state, adj);
+                        }
                     }
                 }
             }
         }
+        // There is no path between the two nodes
     }
 
     const std::list<Direc>& getPath() const {
@@ -391,7 +395,7 @@ private:
         }
         alloc.clear();
         openList.clear();
-        closeList.clear();
+        states.clear();
     }
 
 private:
@@ -418,8 +422,16 @@ private:
     Node beg;
     Node end;
 
-    BinaryHeap<Node*, Less> openList;
-    HashTable<Node*, Equal, Hash> closeList;
+    using OpenList = IndexedBinaryHeap<Node*, Less>;
+    using Handle = OpenList::Handle;
+
+    // The state of a searched node whose handle is not in the open list
+    static const Handle CLOSED = UINT32_MAX;
+
+    OpenList openList;
+
+    // The handle of each node in the open list, or CLOSED
+    HashMap<Node*, Handle, Equal, Hash> states;
 
     std::list<Direc> path;
     std::list<Node*> alloc;
@@ -0,0 +1,306 @@
+#ifndef TASTYLIB_PAIRINGHEAP_H_
+#define TASTYLIB_PAIRINGHEAP_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/NodePool.h"
+#include <functional>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A meldable heap taking the form of a multiway tree. Each node keeps its
+leftmost child and its right sibling, so two heaps are melded by making
+the worse root the leftmost child of the better one. pop() removes the
+root and links its children in pairs from left to right, then links the
+pairs from right to left.
+
+The nodes come from a pool owned by the heap. meld() takes over the pool
+of the other heap along with its nodes, so neither melding nor popping
+goes through the global operator new.
+
+@param Value   The type of the value stored in the heap
+@param PredCmp The type of the binary predicate to arrange the nodes.
+               It has the same meaning as in BinaryHeap.
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+class PairingHeap {
+private:
+    struct Node {
+        Value val;
+        Node *child;    // The leftmost child
+        Node *sibling;  // The right sibling
+        Node *prev;     // The left sibling, or the parent of the leftmost child
+
+        template<typename... Args>
+        explicit Node(Args&&... args)
+        : val(std::forward<Args>(args)...), child(nullptr), sibling(nullptr), prev(nullptr) {}
+    };
+
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Refer to an element from its push() until it is popped. If the heap is
+    melded into another one, the handle refers to the element in that heap.
+    */
+    using Handle = Node*;
+
+    // Default ctor
+    PairingHeap(const PredCmp& cmp = PredCmp())
+    : size(0), root(nullptr), predCmp(cmp) {}
+
+    // Forbid copy
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+
+    // Move ctor
+    PairingHeap(PairingHeap&& other)
+    : size(other.size), root(other.root), predCmp(other.predCmp), pool(std::move(other.pool)) {
+        other.size = 0;
+        other.root = nullptr;
+    }
+
+    // Move assignment
+    PairingHeap& operator=(PairingHeap&& other) {
+        if (this != &other) {
+            clear();
+            size = other.size;
+            root = other.root;
+            predCmp = other.predCmp;
+            pool = std::move(other.pool);
+            other.size = 0;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    // Dtor
+    ~PairingHeap() {
+        clear();
+    }
+
+    // Return the amount of elements in the heap
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return true if the heap has no elements
+    bool isEmpty() const noexcept {
+        return size == 0;
+    }
+
+    // Clear the elements in the heap. The pool keeps the memory.
+    void clear() {
+        // Walk the tree as a binary tree (child = left, sibling = right),
+        // rotating left children up so that no stack is needed
+        Node *cur = root;
+        while (cur) {
+            if (cur->child) {
+                Node *c = cur->child;
+                cur->child = c->sibling;
+                c->sibling = cur;
+                cur = c;
+            } else {
+                Node *next = cur->sibling;
+                destroyNode(cur);
+                cur = next;
+            }
+        }
+        root = nullptr;
+        size = 0;
+    }
+
+    /*
+    Insert a new element to the heap.
+
+    @return The handle of the element
+    */
+    Handle push(const Value& val) {
+        return emplace(val);
+    }
+
+    Handle push(Value&& val) {
+        return emplace(std::move(val));
+    }
+
+    // Construct a new element in the heap with the given arguments
+    template<typename... Args>
+    Handle emplace(Args&&... args) {
+        Node *node = createNode(std::forward<Args>(args)...);
+        root = root ? link(root, node) : node;
+        ++size;
+        return node;
+    }
+
+    /*
+    Return the root element of the heap.
+    Precondition: The heap is non-empty.
+    */
+    const Value& top() const noexcept {
+        return root->val;
+    }
+
+    // Return the value of an element in the heap
+    const Value& get(const Handle h) const noexcept {
+        return h->val;
+    }
+
+    /*
+    Remove the root element of the heap.
+    Precondition: The heap is non-empty.
+    */
+    void pop() {
+        Node *old = root;
+        root = mergePairs(old->child);
+        destroyNode(old);
+        --size;
+    }
+
+    /*
+    Remove the root element of the heap and return it.
+    Precondition: The heap is non-empty.
+    */
+    Value popValue() {
+        Value res(std::move(root->val));
+        pop();
+        return res;
+    }
+
+    /*
+    Change the value of an element to a better or equal one, i.e.
+    PredCmp(get(h), val) is false.
+
+    @param h   The handle of the element
+    @param val The new value
+    */
+    void decreaseKey(const Handle h, const Value& val) {
+        h->val = val;
+        if (h != root) {
+            cut(h);
+            root = link(root, h);
+        }
+    }
+
+    void decreaseKey(const Handle h, Value&& val) {
+        h->val = std::move(val);
+        if (h != root) {
+            cut(h);
+            root = link(root, h);
+        }
+    }
+
+    /*
+    Move all elements of another heap into this one in O(1) time. The
+    handles of the other heap stay valid and refer to this heap.
+
+    @param other The other heap, which is left empty. It must use an
+                 equivalent comparator.
+    */
+    void meld(PairingHeap& other) noexcept {
+        if (this == &other || !other.root) {
+            return;
+        }
+        root = root ? link(root, other.root) : other.root;
+        size += other.size;
+        pool.absorb(other.pool);
+        other.root = nullptr;
+        other.size = 0;
+    }
+
+private:
+    template<typename... Args>
+    Node* createNode(Args&&... args) {
+        Node *mem = pool.allocate();
+        try {
+            return new (mem) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(mem);
+            throw;
+        }
+    }
+
+    void destroyNode(Node *const node) noexcept {
+        node->~Node();
+        pool.deallocate(node);
+    }
+
+    /*
+    Link two trees. The worse root becomes the leftmost child of the
+    better one.
+
+    @return The root of the linked tree
+    */
+    Node* link(Node *a, Node *b) noexcept {
+        if (predCmp(b->val, a->val)) {
+            std::swap(a, b);
+        }
+        b->prev = a;
+        b->sibling = a->child;
+        if (a->child) {
+            a->child->prev = b;
+        }
+        a->child = b;
+        a->prev = nullptr;
+        a->sibling = nullptr;
+        return a;
+    }
+
+    // Detach a non-root node, along with its subtree, from its parent
+    void cut(Node *const node) noexcept {
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
+        } else {
+            node->prev->sibling = node->sibling;
+        }
+        if (node->sibling) {
+            node->sibling->prev = node->prev;
+        }
+        node->prev = nullptr;
+        node->sibling = nullptr;
+    }
+
+    // Link a list of sibling trees into one tree with the two-pass method
+    Node* mergePairs(Node *first) noexcept {
+        if (!first) {
+            return nullptr;
+        }
+        // Link pairs from left to right, keeping the results in reverse order
+        Node *pairs = nullptr;
+        while (first) {
+            Node *a = first, *b = first->sibling;
+            if (!b) {
+                a->sibling = pairs;
+                pairs = a;
+                break;
+            }
+            first = b->sibling;
+            Node *linked = link(a, b);
+            linked->sibling = pairs;
+            pairs = linked;
+        }
+        // Link the pairs from right to left
+        Node *res = pairs;
+        pairs = pairs->sibling;
+        while (pairs) {
+            Node *next = pairs->sibling;
+            res = link(res, pairs);
+            pairs = next;
+        }
+        res->prev = nullptr;
+        res->sibling = nullptr;
+        return res;
+    }
+
+private:
+    SizeType size;
+    Node *root;
+    PredCmp predCmp;
+    NodePool<Node> pool;
+};
+
+TASTYLIB_NS_END
+
+#endif
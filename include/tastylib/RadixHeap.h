@@ -0,0 +1,175 @@
+#ifndef TASTYLIB_RADIXHEAP_H_
+#define TASTYLIB_RADIXHEAP_H_
+
+#include "tastylib/internal/base.h"
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A monotone priority queue for non-negative integer keys. The key of a new
+element must not be less than the minimum key seen by the last top() or
+pop(), which is the case in Dijkstra's algorithm and in event scheduling.
+
+An element lives in the bucket given by the highest bit in which its key
+differs from the last minimum key. When bucket 0 runs out, the lowest
+non-empty bucket is scanned for its minimum, which becomes the new last
+key, and its elements move to lower buckets. Each element moves at most
+once per bit of the key, so push() and pop() cost O(log C) amortized time
+where C is the range of the keys, and the buckets are accessed in order.
+
+@param Key   The type of the keys. It must be an integer type.
+@param Value The type of the values stored along with the keys.
+*/
+template<typename Key, typename Value>
+class RadixHeap {
+    static_assert(std::is_integral<Key>::value, "Key must be an integer type");
+
+public:
+    using Entry = std::pair<Key, Value>;
+    using SizeType = std::size_t;
+
+    // Default ctor
+    RadixHeap() : size(0), last(0), buckets(BITS + 1) {}
+
+    // Return the amount of elements in the heap
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return true if the heap has no elements
+    bool isEmpty() const noexcept {
+        return size == 0;
+    }
+
+    // Clear the elements in the heap and accept any key again
+    void clear() noexcept {
+        for (auto &b : buckets) {
+            b.clear();
+        }
+        size = 0;
+        last = 0;
+    }
+
+    /*
+    Insert a new element to the heap. Throw std::out_of_range if the key
+    is less than getLastKey().
+
+    @param key The key of the element
+    @param val The value of the element
+    */
+    void push(const Key key, const Value& val) {
+        checkKey(key);
+        buckets[bucketOf(key)].emplace_back(key, val);
+        ++size;
+    }
+
+    void push(const Key key, Value&& val) {
+        checkKey(key);
+        buckets[bucketOf(key)].emplace_back(key, std::move(val));
+        ++size;
+    }
+
+    /*
+    Return the element with the minimum key.
+    Precondition: The heap is non-empty.
+    */
+    const Entry& top() const {
+        pull();
+        return buckets[0].back();
+    }
+
+    /*
+    Remove the element with the minimum key.
+    Precondition: The heap is non-empty.
+    */
+    void pop() {
+        pull();
+        buckets[0].pop_back();
+        --size;
+    }
+
+    // Return the minimum key seen by the last top() or pop(). A new key must not be less than it.
+    Key getLastKey() const noexcept {
+        return (Key)last;
+    }
+
+private:
+    using UKey = typename std::make_unsigned<Key>::type;
+
+    static const SizeType BITS = std::numeric_limits<UKey>::digits;
+
+    void checkKey(const Key key) const {
+        if (isNegative(key, std::is_signed<Key>()) || (UKey)key < last) {
+            throw std::out_of_range("RadixHeap: key is less than the last removed key");
+        }
+    }
+
+    // Return true if a key is negative
+    static bool isNegative(const Key key, std::true_type) noexcept {
+        return key < 0;
+    }
+
+    static bool isNegative(const Key, std::false_type) noexcept {
+        return false;
+    }
+
+    // Return the bucket of a key, i.e. the bit length of (key XOR last)
+    SizeType bucketOf(const Key key) const noexcept {
+        return bitLength((UKey)key ^ last);
+    }
+
+    // Return the amount of bits needed to represent a number
+    static SizeType bitLength(UKey x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return x ? (SizeType)(64 - __builtin_clzll((unsigned long long)x)) : 0;
+#else
+        SizeType n = 0;
+        for (; x; x >>= 1) {
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    // Make sure that bucket 0 holds the elements with the minimum key
+    void pull() const {
+        if (!buckets[0].empty()) {
+            return;
+        }
+        SizeType i = 1;
+        while (buckets[i].empty()) {
+            ++i;
+        }
+        auto &from = buckets[i];
+        UKey minKey = (UKey)from[0].first;
+        for (const auto &e : from) {
+            if ((UKey)e.first < minKey) {
+                minKey = (UKey)e.first;
+            }
+        }
+        // All keys in the bucket share the bits above bit i - 1 with the
+        // new last key, so they move to buckets below i
+        last = minKey;
+        for (auto &e : from) {
+            buckets[bucketOf(e.first)].push_back(std::move(e));
+        }
+        from.clear();
+    }
+
+private:
+    SizeType size;
+
+    // The buckets are refilled lazily by the const top()
+    mutable UKey last;
+    mutable std::vector<std::vector<Entry>> buckets;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -2,8 +2,19 @@
 #define TASTYLIB_SORT_H_
 
 #include "tastylib/internal/base.h"
+#include "tastylib/internal/parallel.h"
+#include "tastylib/internal/SortingNetwork.h"
+#include "tastylib/internal/merge.h"
 #include "tastylib/BinaryHeap.h"
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
 TASTYLIB_NS_BEGIN
@@ -61,13 +72,11 @@ The heapsort algorithm to sort an unordered array.
 */
 template<typename Value, typename PredCmp = std::less<Value>>
 void heapSort(Value *const arr, const std::size_t n, const PredCmp& cmp = PredCmp()) {
-    BinaryHeap<Value, PredCmp> heap(cmp);
+    // Build the heap bottom-up in O(n) time
+    BinaryHeap<Value, PredCmp> heap(
+        std::vector<Value>(std::make_move_iterator(arr), std::make_move_iterator(arr + n)), cmp);
     for (std::size_t i = 0; i < n; ++i) {
-        heap.push(arr[i]);
-    }
-    for (std::size_t i = 0; i < n; ++i) {
-        arr[i] = heap.top();
-        heap.pop();
+        arr[i] = heap.popValue();
     }
 }
 
@@ -104,7 +113,61 @@ Value pivot(Value *const arr,
 }
 
 /*
-The quicksort algorithm to sort an unordered array.
+Partition an array around the median-of-three pivot. This function is used
+in quickSort(), quickSelect(), introSort() and introSelect(). After its
+execution, no element before the pivot is bigger than it, and no element
+after the pivot is smaller than it.
+
+@param arr   The array to be processed
+@param left  The beginning index of the array to be processed
+@param right The ending index of the array to be processed. It must be
+             at least left + 2.
+@param cmp   The comparator
+@return      The index of the pivot
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+std::size_t quickPartition(Value *const arr,
+                           const std::size_t left,
+                           const std::size_t right,
+                           const PredCmp& cmp = PredCmp()) {
+    Value p = pivot<Value, PredCmp>(arr, left, right, cmp);
+    std::size_t i = left, j = right - 1;
+    while (true) {
+        while (cmp(arr[++i], p)) {}
+        while (cmp(p, arr[--j])) {}
+        if (i < j) {
+            std::swap(arr[i], arr[j]);
+        } else {
+            break;
+        }
+    }
+    std::swap(arr[i], arr[right - 1]);  // Restore pivot
+    return i;
+}
+
+// Sort a small array with a sorting network
+template<typename Value>
+void smallSort(Value *const arr, const std::size_t n, const std::less<Value>&, std::true_type) {
+    networkSort<Value>(arr, n);
+}
+
+template<typename Value>
+void smallSort(Value *const arr, const std::size_t n, const std::greater<Value>&, std::true_type) {
+    networkSort<Value>(arr, n);
+    std::reverse(arr, arr + n);
+}
+
+// Sort a small array with insertion sort
+template<typename Value, typename PredCmp>
+void smallSort(Value *const arr, const std::size_t n, const PredCmp& cmp, std::false_type) {
+    insertionSort<Value, PredCmp>(arr, n, cmp);
+}
+
+/*
+The quicksort algorithm to sort an unordered array. Arrays of at most 10
+elements are sorted by insertion sort, or, for int32 and float elements
+compared by std::less or std::greater, arrays of at most 32 elements by a
+sorting network when AVX2 or SSE4.1 is enabled, see networkSort().
 
 @param arr   The array to be sorted
 @param left  The beginning index of the array to be sorted
@@ -116,24 +179,14 @@ void quickSort(Value *const arr,
                const std::size_t left,
                const std::size_t right,
                const PredCmp& cmp = PredCmp()) {
-    if (left + 10 <= right) {
-        Value p = pivot<Value, PredCmp>(arr, left, right);
-        std::size_t i = left, j = right - 1;
-        while (true) {
-            while (cmp(arr[++i], p)) {}
-            while (cmp(p, arr[--j])) {}
-            if (i < j) {
-                std::swap(arr[i], arr[j]);
-            } else {
-                break;
-            }
-        }
-        std::swap(arr[i], arr[right - 1]);  // Restore pivot
+    using Network = NetworkSortable<Value, PredCmp>;
+    if (left + (Network::value ? 32 : 10) <= right) {
+        std::size_t i = quickPartition<Value, PredCmp>(arr, left, right, cmp);
         quickSort<Value, PredCmp>(arr, left, i - 1, cmp);
         quickSort<Value, PredCmp>(arr, i + 1, right, cmp);
     } else {
-        // Use insertion sort for small array
-        insertionSort<Value, PredCmp>(arr + left, right - left + 1, cmp);
+        // Use a sorting network or insertion sort for small array
+        smallSort<Value>(arr + left, right - left + 1, cmp, Network());
     }
 }
 
@@ -155,18 +208,7 @@ void quickSelect(Value *const arr,
                  const std::size_t k,
                  const PredCmp& cmp = PredCmp()) {
     if (left + 10 <= right) {
-        Value p = pivot<Value, PredCmp>(arr, left, right);
-        std::size_t i = left, j = right - 1;
-        while (true) {
-            while (cmp(arr[++i], p)) {}
-            while (cmp(p, arr[--j])) {}
-            if (i < j) {
-                std::swap(arr[i], arr[j]);
-            } else {
-                break;
-            }
-        }
-        std::swap(arr[i], arr[right - 1]);  // Restore pivot
+        std::size_t i = quickPartition<Value, PredCmp>(arr, left, right, cmp);
         if (k < i) {
             quickSelect<Value, PredCmp>(arr, left, i - 1, k, cmp);
         } else if (k > i) {
@@ -178,6 +220,1250 @@ void quickSelect(Value *const arr,
     }
 }
 
+// Return the depth limit of introSort() and introSelect(), i.e. 2 * floor(log2(n))
+inline std::size_t introDepthLimit(std::size_t n) noexcept {
+    std::size_t depth = 0;
+    for (; n > 1; n >>= 1) {
+        depth += 2;
+    }
+    return depth;
+}
+
+/*
+The median-of-medians algorithm to find the kth smallest/biggest element
+in an unordered array in O(n) time in the worst case. After its execution,
+the kth element will be stored at arr[k]. It is slower than quickSelect()
+on most inputs, and is the fallback of introSelect().
+
+@param arr   The array to be processed
+@param left  The beginning index of the array to be processed
+@param right The ending index of the array to be processed
+@param k     The kth element to find
+@param cmp   The comparator
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void medianOfMediansSelect(Value *const arr,
+                           std::size_t left,
+                           std::size_t right,
+                           const std::size_t k,
+                           const PredCmp& cmp = PredCmp()) {
+    while (left + 10 <= right) {
+        // Move the median of each group of 5 elements to the front
+        std::size_t m = left;
+        for (std::size_t g = left; g + 4 <= right; g += 5) {
+            insertionSort<Value, PredCmp>(arr + g, 5, cmp);
+            std::swap(arr[m++], arr[g + 2]);
+        }
+        // The median of the medians is bigger than 3/10 of the elements
+        // and smaller than another 3/10
+        const std::size_t mid = left + (m - left - 1) / 2;
+        medianOfMediansSelect<Value, PredCmp>(arr, left, m - 1, mid, cmp);
+        // Split the array into the elements smaller than, equal to and
+        // bigger than the pivot, so that duplicates don't slow it down
+        Value p = arr[mid];
+        std::size_t lt = left, i = left, gt = right + 1;
+        while (i < gt) {
+            if (cmp(arr[i], p)) {
+                std::swap(arr[lt++], arr[i++]);
+            } else if (cmp(p, arr[i])) {
+                std::swap(arr[i], arr[--gt]);
+            } else {
+                ++i;
+            }
+        }
+        if (k < lt) {
+            right = lt - 1;
+        } else if (k >= gt) {
+            left = gt;
+        } else {
+            return;
+        }
+    }
+    insertionSort<Value, PredCmp>(arr + left, right - left + 1, cmp);
+}
+
+/*
+The introsort loop. It runs quicksort until the depth limit is reached,
+then sorts the remaining range with heapsort. It recurses on the smaller
+side of each partition and loops on the larger one.
+
+@param arr   The array to be sorted
+@param left  The beginning index of the array to be sorted
+@param right The ending index of the array to be sorted
+@param depth The amount of partitions allowed before heapsort is used
+@param cmp   The comparator
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void introSortLoop(Value *const arr,
+                   std::size_t left,
+                   std::size_t right,
+                   std::size_t depth,
+                   const PredCmp& cmp = PredCmp()) {
+    while (left + 10 <= right) {
+        if (depth == 0) {
+            heapSort<Value, PredCmp>(arr + left, right - left + 1, cmp);
+            return;
+        }
+        --depth;
+        std::size_t i = quickPartition<Value, PredCmp>(arr, left, right, cmp);
+        if (i - left < right - i) {
+            introSortLoop<Value, PredCmp>(arr, left, i - 1, depth, cmp);
+            left = i + 1;
+        } else {
+            introSortLoop<Value, PredCmp>(arr, i + 1, right, depth, cmp);
+            right = i - 1;
+        }
+    }
+    // Use insertion sort for small array
+    insertionSort<Value, PredCmp>(arr + left, right - left + 1, cmp);
+}
+
+/*
+The introsort algorithm to sort an unordered array. It is quickSort() with
+a limit of 2 * log2(n) on the depth of partitions, beyond which heapsort
+takes over, so it costs O(nlogn) time and O(logn) stack in the worst case.
+
+@param arr   The array to be sorted
+@param left  The beginning index of the array to be sorted
+@param right The ending index of the array to be sorted
+@param cmp   The comparator
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void introSort(Value *const arr,
+               const std::size_t left,
+               const std::size_t right,
+               const PredCmp& cmp = PredCmp()) {
+    introSortLoop<Value, PredCmp>(arr, left, right, introDepthLimit(right - left + 1), cmp);
+}
+
+/*
+The introselect algorithm to find the kth smallest/biggest element in an
+unordered array. It is quickSelect() with a limit of 2 * log2(n) on the
+amount of partitions, beyond which medianOfMediansSelect() takes over, so
+it costs O(n) time in the worst case. After its execution, the kth element
+will be stored at arr[k].
+
+@param arr   The array to be processed
+@param left  The beginning index of the array to be processed
+@param right The ending index of the array to be processed
+@param k     The kth element to find
+@param cmp   The comparator
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void introSelect(Value *const arr,
+                 std::size_t left,
+                 std::size_t right,
+                 const std::size_t k,
+                 const PredCmp& cmp = PredCmp()) {
+    std::size_t depth = introDepthLimit(right - left + 1);
+    while (left + 10 <= right) {
+        if (depth == 0) {
+            medianOfMediansSelect<Value, PredCmp>(arr, left, right, k, cmp);
+            return;
+        }
+        --depth;
+        std::size_t i = quickPartition<Value, PredCmp>(arr, left, right, cmp);
+        if (k < i) {
+            right = i - 1;
+        } else if (k > i) {
+            left = i + 1;
+        } else {
+            return;
+        }
+    }
+    // Use insertion sort for small array
+    insertionSort<Value, PredCmp>(arr + left, right - left + 1, cmp);
+}
+
+// Swap arr[a] and arr[b] if arr[b] should be before arr[a]
+template<typename Value, typename PredCmp>
+void pdqSort2(Value *const arr, const std::size_t a, const std::size_t b, const PredCmp& cmp) {
+    if (cmp(arr[b], arr[a])) {
+        std::swap(arr[a], arr[b]);
+    }
+}
+
+// Sort arr[a], arr[b] and arr[c]
+template<typename Value, typename PredCmp>
+void pdqSort3(Value *const arr,
+              const std::size_t a,
+              const std::size_t b,
+              const std::size_t c,
+              const PredCmp& cmp) {
+    pdqSort2<Value, PredCmp>(arr, a, b, cmp);
+    pdqSort2<Value, PredCmp>(arr, b, c, cmp);
+    pdqSort2<Value, PredCmp>(arr, a, b, cmp);
+}
+
+/*
+Move the pivot of pdqSort() and pdqSelect() to arr[0]. It is the median of
+three elements, or for more than 128 elements the median of the medians of
+three groups of three (Tukey's ninther). Both ensure that an element not
+smaller than the pivot and an element not bigger than it are left
+elsewhere in the array, which bounds the scans of the partitions.
+
+@param arr The array to be processed
+@param n   The amount of elements in the array. It must be at least 24.
+@param cmp The comparator
+*/
+template<typename Value, typename PredCmp>
+void pdqChoosePivot(Value *const arr, const std::size_t n, const PredCmp& cmp) {
+    const std::size_t half = n / 2;
+    if (n > 128) {
+        pdqSort3<Value, PredCmp>(arr, 0, half, n - 1, cmp);
+        pdqSort3<Value, PredCmp>(arr, 1, half - 1, n - 2, cmp);
+        pdqSort3<Value, PredCmp>(arr, 2, half + 1, n - 3, cmp);
+        pdqSort3<Value, PredCmp>(arr, half - 1, half, half + 1, cmp);
+        std::swap(arr[0], arr[half]);
+    } else {
+        pdqSort3<Value, PredCmp>(arr, half, 0, n - 1, cmp);
+    }
+}
+
+/*
+Swap the elements of two blocks recorded by pdqPartitionRight(). The
+elements are at arr[baseL + offsetsL[i]] and arr[baseR - offsetsR[i]].
+Unless the blocks have as many elements, they are moved along one cycle,
+which costs one move per element instead of three.
+*/
+template<typename Value>
+void pdqSwapOffsets(Value *const arr,
+                    const std::size_t baseL,
+                    const std::size_t baseR,
+                    const unsigned char *const offsetsL,
+                    const unsigned char *const offsetsR,
+                    const std::size_t num,
+                    const bool useSwaps) {
+    if (useSwaps) {
+        for (std::size_t i = 0; i < num; ++i) {
+            std::swap(arr[baseL + offsetsL[i]], arr[baseR - offsetsR[i]]);
+        }
+    } else if (num > 0) {
+        std::size_t l = baseL + offsetsL[0], r = baseR - offsetsR[0];
+        Value tmp(std::move(arr[l]));
+        arr[l] = std::move(arr[r]);
+        for (std::size_t i = 1; i < num; ++i) {
+            l = baseL + offsetsL[i];
+            arr[r] = std::move(arr[l]);
+            r = baseR - offsetsR[i];
+            arr[l] = std::move(arr[r]);
+        }
+        arr[r] = std::move(tmp);
+    }
+}
+
+/*
+Partition an array around the pivot at arr[0] with blocks, as BlockQuicksort
+does. The comparisons of a block of 64 elements on each side only record
+the offsets of the elements on the wrong side, so the loops have no branch
+that depends on the data. The recorded elements are then swapped in pairs.
+After its execution, the elements before the pivot are smaller than it,
+and the ones after it are not.
+
+@param arr                The array to be processed
+@param n                  The amount of elements in the array
+@param cmp                The comparator
+@param alreadyPartitioned Set to true if no element had to be swapped
+@return                   The index of the pivot
+*/
+template<typename Value, typename PredCmp>
+std::size_t pdqPartitionRight(Value *const arr,
+                              const std::size_t n,
+                              const PredCmp& cmp,
+                              bool& alreadyPartitioned,
+                              std::true_type) {
+    const std::size_t BLOCK = 64;
+    Value p(std::move(arr[0]));
+    std::size_t first = 0, last = n;
+    while (cmp(arr[++first], p)) {}
+    if (first == 1) {
+        while (first < last && !cmp(arr[--last], p)) {}
+    } else {
+        while (!cmp(arr[--last], p)) {}
+    }
+    alreadyPartitioned = first >= last;
+    if (!alreadyPartitioned) {
+        std::swap(arr[first], arr[last]);
+        ++first;
+        alignas(64) unsigned char offsetsL[BLOCK];
+        alignas(64) unsigned char offsetsR[BLOCK];
+        std::size_t baseL = first, baseR = last;
+        std::size_t numL = 0, numR = 0, startL = 0, startR = 0;
+        while (first < last) {
+            // Refill the empty blocks, splitting the unknown elements
+            // between them when both are empty
+            const std::size_t unknown = last - first;
+            const std::size_t splitL = numL == 0 ? (numR == 0 ? unknown / 2 : unknown) : 0;
+            const std::size_t splitR = numR == 0 ? unknown - splitL : 0;
+            const std::size_t sizeL = std::min(splitL, BLOCK), sizeR = std::min(splitR, BLOCK);
+            for (std::size_t i = 0; i < sizeL; ++i) {
+                offsetsL[numL] = (unsigned char)i;
+                numL += !cmp(arr[first], p);
+                ++first;
+            }
+            for (std::size_t i = 1; i <= sizeR; ++i) {
+                offsetsR[numR] = (unsigned char)i;
+                numR += cmp(arr[--last], p);
+            }
+            const std::size_t num = std::min(numL, numR);
+            pdqSwapOffsets(arr, baseL, baseR, offsetsL + startL, offsetsR + startR, num, numL == numR);
+            numL -= num;
+            numR -= num;
+            startL += num;
+            startR += num;
+            if (numL == 0) {
+                startL = 0;
+                baseL = first;
+            }
+            if (numR == 0) {
+                startR = 0;
+                baseR = last;
+            }
+        }
+        // Move the elements left in a block to the boundary
+        if (numL > 0) {
+            for (; numL > 0; --numL) {
+                std::swap(arr[baseL + offsetsL[startL + numL - 1]], arr[--last]);
+            }
+            first = last;
+        }
+        if (numR > 0) {
+            for (; numR > 0; --numR) {
+                std::swap(arr[baseR - offsetsR[startR + numR - 1]], arr[first++]);
+            }
+        }
+    }
+    const std::size_t pos = first - 1;
+    arr[0] = std::move(arr[pos]);
+    arr[pos] = std::move(p);
+    return pos;
+}
+
+/*
+Partition an array around the pivot at arr[0] with the classic Hoare scans,
+which suit comparators that branch anyway. It has the same contract as the
+block partition.
+*/
+template<typename Value, typename PredCmp>
+std::size_t pdqPartitionRight(Value *const arr,
+                              const std::size_t n,
+                              const PredCmp& cmp,
+                              bool& alreadyPartitioned,
+                              std::false_type) {
+    Value p(std::move(arr[0]));
+    std::size_t first = 0, last = n;
+    while (cmp(arr[++first], p)) {}
+    if (first == 1) {
+        while (first < last && !cmp(arr[--last], p)) {}
+    } else {
+        while (!cmp(arr[--last], p)) {}
+    }
+    alreadyPartitioned = first >= last;
+    while (first < last) {
+        std::swap(arr[first], arr[last]);
+        while (cmp(arr[++first], p)) {}
+        while (!cmp(arr[--last], p)) {}
+    }
+    const std::size_t pos = first - 1;
+    arr[0] = std::move(arr[pos]);
+    arr[pos] = std::move(p);
+    return pos;
+}
+
+/*
+Partition an array around the pivot at arr[0] so that the elements equal
+to it go to the left side. pdqSort() and pdqSelect() use it when the pivot
+equals the element before the array, which is not bigger than any element
+of the array, so that the whole left side is equal to the pivot and needs
+no more work.
+
+@param arr The array to be processed
+@param n   The amount of elements in the array
+@param cmp The comparator
+@return    The index of the pivot
+*/
+template<typename Value, typename PredCmp>
+std::size_t pdqPartitionLeft(Value *const arr, const std::size_t n, const PredCmp& cmp) {
+    Value p(std::move(arr[0]));
+    std::size_t first = 0, last = n;
+    while (cmp(p, arr[--last])) {}
+    if (last + 1 == n) {
+        while (first < last && !cmp(p, arr[++first])) {}
+    } else {
+        while (!cmp(p, arr[++first])) {}
+    }
+    while (first < last) {
+        std::swap(arr[first], arr[last]);
+        while (cmp(p, arr[--last])) {}
+        while (!cmp(p, arr[++first])) {}
+    }
+    arr[0] = std::move(arr[last]);
+    arr[last] = std::move(p);
+    return last;
+}
+
+/*
+Run insertion sort on an array, but give up once more than 8 elements have
+been moved. pdqSort() uses it to finish partitions that needed no swaps,
+which are often already sorted.
+
+@return True if the array is sorted
+*/
+template<typename Value, typename PredCmp>
+bool pdqPartialInsertionSort(Value *const arr, const std::size_t n, const PredCmp& cmp) {
+    std::size_t moved = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (cmp(arr[i], arr[i - 1])) {
+            Value tmp(std::move(arr[i]));
+            std::size_t j = i;
+            do {
+                arr[j] = std::move(arr[j - 1]);
+                --j;
+            } while (j > 0 && cmp(tmp, arr[j - 1]));
+            arr[j] = std::move(tmp);
+            moved += i - j;
+            if (moved > 8) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+Swap a few elements of both sides of an unbalanced partition with elements
+a quarter of the way in, which breaks the patterns that make the pivots
+bad, e.g. the ones built by an adversary.
+
+@param arr The array to be processed
+@param n   The amount of elements in the array
+@param pos The index of the pivot
+*/
+template<typename Value>
+void pdqShuffle(Value *const arr, const std::size_t n, const std::size_t pos) {
+    const std::size_t sizeL = pos, sizeR = n - pos - 1;
+    if (sizeL >= 24) {
+        std::swap(arr[0], arr[sizeL / 4]);
+        std::swap(arr[pos - 1], arr[pos - sizeL / 4]);
+        if (sizeL > 128) {
+            std::swap(arr[1], arr[sizeL / 4 + 1]);
+            std::swap(arr[2], arr[sizeL / 4 + 2]);
+            std::swap(arr[pos - 2], arr[pos - (sizeL / 4 + 1)]);
+            std::swap(arr[pos - 3], arr[pos - (sizeL / 4 + 2)]);
+        }
+    }
+    if (sizeR >= 24) {
+        std::swap(arr[pos + 1], arr[pos + 1 + sizeR / 4]);
+        std::swap(arr[n - 1], arr[n - sizeR / 4]);
+        if (sizeR > 128) {
+            std::swap(arr[pos + 2], arr[pos + 2 + sizeR / 4]);
+            std::swap(arr[pos + 3], arr[pos + 3 + sizeR / 4]);
+            std::swap(arr[n - 2], arr[n - (1 + sizeR / 4)]);
+            std::swap(arr[n - 3], arr[n - (2 + sizeR / 4)]);
+        }
+    }
+}
+
+/*
+The pattern-defeating quicksort loop. It recurses on the smaller side of
+each partition and loops on the larger one.
+
+@param arr        The array to be sorted
+@param n          The amount of elements in the array
+@param cmp        The comparator
+@param badAllowed The amount of unbalanced partitions allowed before
+                  heapsort is used
+@param leftmost   False if arr[-1] belongs to the array being sorted by
+                  pdqSort(), i.e. it is not bigger than any element of arr
+@param block      Whether to use the block partition
+*/
+template<typename Value, typename PredCmp, typename Block>
+void pdqSortLoop(Value *arr,
+                 std::size_t n,
+                 const PredCmp& cmp,
+                 std::size_t badAllowed,
+                 bool leftmost,
+                 Block block) {
+    while (n >= 24) {
+        pdqChoosePivot<Value, PredCmp>(arr, n, cmp);
+        // The pivot equals the element before the array, so put the
+        // elements equal to it on the left, where they are in place
+        if (!leftmost && !cmp(*(arr - 1), arr[0])) {
+            const std::size_t pos = pdqPartitionLeft<Value, PredCmp>(arr, n, cmp);
+            arr += pos + 1;
+            n -= pos + 1;
+            continue;
+        }
+        bool alreadyPartitioned = false;
+        const std::size_t pos = pdqPartitionRight<Value, PredCmp>(arr, n, cmp, alreadyPartitioned, block);
+        const std::size_t sizeL = pos, sizeR = n - pos - 1;
+        if (sizeL < n / 8 || sizeR < n / 8) {
+            if (--badAllowed == 0) {
+                heapSort<Value, PredCmp>(arr, n, cmp);
+                return;
+            }
+            pdqShuffle(arr, n, pos);
+        } else if (alreadyPartitioned &&
+                   pdqPartialInsertionSort<Value, PredCmp>(arr, sizeL, cmp) &&
+                   pdqPartialInsertionSort<Value, PredCmp>(arr + pos + 1, sizeR, cmp)) {
+            return;
+        }
+        if (sizeL < sizeR) {
+            pdqSortLoop<Value, PredCmp, Block>(arr, sizeL, cmp, badAllowed, leftmost, block);
+            arr += pos + 1;
+            n = sizeR;
+            leftmost = false;
+        } else {
+            pdqSortLoop<Value, PredCmp, Block>(arr + pos + 1, sizeR, cmp, badAllowed, false, block);
+            n = sizeL;
+        }
+    }
+    // Use insertion sort for small array
+    insertionSort<Value, PredCmp>(arr, n, cmp);
+}
+
+/*
+The pattern-defeating quicksort (pdqsort) algorithm to sort an unordered
+array. It has the same signature as quickSort(), and differs from it in that:
+
+1. The partition compares blocks of elements without branches, see
+   pdqPartitionRight(). It is used for arithmetic types by default, and can
+   be turned on or off with the BlockPartition template argument.
+2. A partition that swapped no element is finished by an insertion sort that
+   gives up quickly, so sorted runs cost O(n). A strictly descending array
+   is reversed first.
+3. After an unbalanced partition, a few elements are swapped to break the
+   pattern, and after log2(n) of them heapsort takes over, so it costs
+   O(nlogn) time in the worst case.
+4. Runs of elements equal to a previous pivot are split off in one pass.
+
+@param arr   The array to be sorted
+@param left  The beginning index of the array to be sorted
+@param right The ending index of the array to be sorted
+@param cmp   The comparator
+*/
+template<typename Value,
+         typename PredCmp = std::less<Value>,
+         bool BlockPartition = std::is_arithmetic<Value>::value>
+void pdqSort(Value *const arr,
+             const std::size_t left,
+             const std::size_t right,
+             const PredCmp& cmp = PredCmp()) {
+    const std::size_t n = right - left + 1;
+    std::size_t run = 1;
+    while (run < n && cmp(arr[left + run], arr[left + run - 1])) {
+        ++run;
+    }
+    if (n > 1 && run == n) {
+        std::reverse(arr + left, arr + left + n);
+        return;
+    }
+    pdqSortLoop<Value, PredCmp>(arr + left, n, cmp, introDepthLimit(n) / 2, true,
+                                std::integral_constant<bool, BlockPartition>());
+}
+
+/*
+The quickselect algorithm with the partitions of pdqSort() to find the kth
+smallest/biggest element in an unordered array. It has the same signature
+as quickSelect(). After log2(n) unbalanced partitions medianOfMediansSelect()
+takes over, so it costs O(n) time in the worst case. After its execution,
+the kth element will be stored at arr[k].
+
+@param arr   The array to be processed
+@param left  The beginning index of the array to be processed
+@param right The ending index of the array to be processed
+@param k     The kth element to find
+@param cmp   The comparator
+*/
+template<typename Value,
+         typename PredCmp = std::less<Value>,
+         bool BlockPartition = std::is_arithmetic<Value>::value>
+void pdqSelect(Value *const arr,
+               const std::size_t left,
+               const std::size_t right,
+               const std::size_t k,
+               const PredCmp& cmp = PredCmp()) {
+    Value *a = arr + left;
+    std::size_t n = right - left + 1, kth = k - left;
+    std::size_t badAllowed = introDepthLimit(n) / 2;
+    bool leftmost = true;
+    while (n >= 24) {
+        pdqChoosePivot<Value, PredCmp>(a, n, cmp);
+        if (!leftmost && !cmp(*(a - 1), a[0])) {
+            const std::size_t pos = pdqPartitionLeft<Value, PredCmp>(a, n, cmp);
+            if (kth <= pos) {
+                return;  // All of a[0..pos] are equal
+            }
+            a += pos + 1;
+            n -= pos + 1;
+            kth -= pos + 1;
+            continue;
+        }
+        bool alreadyPartitioned = false;
+        const std::size_t pos = pdqPartitionRight<Value, PredCmp>(
+            a, n, cmp, alreadyPartitioned, std::integral_constant<bool, BlockPartition>());
+        if (kth == pos) {
+            return;
+        }
+        if (pos < n / 8 || n - pos - 1 < n / 8) {
+            if (--badAllowed == 0) {
+                medianOfMediansSelect<Value, PredCmp>(a, 0, n - 1, kth, cmp);
+                return;
+            }
+            pdqShuffle(a, n, pos);
+        }
+        if (kth < pos) {
+            n = pos;
+        } else {
+            a += pos + 1;
+            n -= pos + 1;
+            kth -= pos + 1;
+            leftmost = false;
+        }
+    }
+    // Use insertion sort for small array
+    insertionSort<Value, PredCmp>(a, n, cmp);
+}
+
+/*
+Sort arr[lo, hi) by binary insertion sort, knowing that arr[lo, start) is
+sorted. It is stable, and is used by timSort() to extend short runs.
+*/
+template<typename Value, typename PredCmp>
+void binaryInsertionSort(Value *const arr,
+                         const std::size_t lo,
+                         const std::size_t hi,
+                         const std::size_t start,
+                         const PredCmp& cmp) {
+    for (std::size_t i = std::max(start, lo + 1); i < hi; ++i) {
+        Value *const pos = std::upper_bound(arr + lo, arr + i, arr[i], cmp);
+        if (pos != arr + i) {
+            Value tmp(std::move(arr[i]));
+            std::move_backward(pos, arr + i, arr + i + 1);
+            *pos = std::move(tmp);
+        }
+    }
+}
+
+/*
+Merge the adjacent sorted ranges arr[lo, mid) and arr[mid, hi) stably.
+The smaller range is moved to the buffer and merged with the other one by
+gallopMerge(), from the front or from the back. If the smaller range holds
+more than 'maxBuffer' elements, the ranges are split around the middle of
+the larger one and the pieces in between are rotated, which needs no
+buffer.
+
+@param arr       The array to be processed
+@param lo        The beginning index of the first range
+@param mid       The beginning index of the second range
+@param hi        The ending index of the second range
+@param cmp       The comparator
+@param buffer    The buffer
+@param maxBuffer The maximum amount of elements in the buffer
+@param minGallop The galloping threshold of gallopMerge()
+*/
+template<typename Value, typename PredCmp>
+void timMerge(Value *const arr,
+              const std::size_t lo,
+              const std::size_t mid,
+              const std::size_t hi,
+              const PredCmp& cmp,
+              std::vector<Value>& buffer,
+              const std::size_t maxBuffer,
+              std::size_t& minGallop) {
+    const std::size_t lenA = mid - lo, lenB = hi - mid;
+    if (lenA == 0 || lenB == 0) {
+        return;
+    }
+    if (std::min(lenA, lenB) > maxBuffer) {
+        if (lenA + lenB == 2) {
+            if (cmp(arr[mid], arr[lo])) {
+                std::swap(arr[lo], arr[mid]);
+            }
+            return;
+        }
+        std::size_t cutA, cutB;
+        if (lenA >= lenB) {
+            cutA = lo + lenA / 2;
+            cutB = std::lower_bound(arr + mid, arr + hi, arr[cutA], cmp) - arr;
+        } else {
+            cutB = mid + lenB / 2;
+            cutA = std::upper_bound(arr + lo, arr + mid, arr[cutB], cmp) - arr;
+        }
+        const std::size_t newMid = std::rotate(arr + cutA, arr + mid, arr + cutB) - arr;
+        timMerge<Value, PredCmp>(arr, lo, cutA, newMid, cmp, buffer, maxBuffer, minGallop);
+        timMerge<Value, PredCmp>(arr, newMid, cutB, hi, cmp, buffer, maxBuffer, minGallop);
+        return;
+    }
+    if (lenA <= lenB) {
+        // Merge from the front, writing over the first range
+        buffer.assign(std::make_move_iterator(arr + lo), std::make_move_iterator(arr + mid));
+        Value *out = arr + lo;
+        // The elements of the second range left at the end are in place
+        auto emit = [&out](Value *const first, const std::size_t count) {
+            if (first == out) {
+                out += count;
+            } else if (count == 1) {
+                *out++ = std::move(*first);
+            } else {
+                out = std::move(first, first + count, out);
+            }
+        };
+        gallopMerge(buffer.data(), lenA, arr + mid, lenB, emit, cmp, minGallop);
+    } else {
+        // Merge from the back, writing over the second range. The runs are
+        // swapped and the comparator reversed, so that equal elements of
+        // the second range still end up last.
+        using Rev = std::reverse_iterator<Value*>;
+        buffer.assign(std::make_move_iterator(arr + mid), std::make_move_iterator(arr + hi));
+        Rev out(arr + hi);
+        auto emit = [&out](const Rev first, const std::size_t count) {
+            if (first == out) {
+                out += count;
+            } else if (count == 1) {
+                *out++ = std::move(*first);
+            } else {
+                out = std::move(first, first + count, out);
+            }
+        };
+        auto revCmp = [&cmp](const Value& x, const Value& y) {
+            return cmp(y, x);
+        };
+        gallopMerge(Rev(buffer.data() + lenB), lenB, Rev(arr + mid), lenA, emit, revCmp, minGallop);
+    }
+}
+
+/*
+The timsort algorithm to sort an unordered array stably. It splits the
+array into natural runs, reversing strictly descending ones, and extends
+runs shorter than 16 to 32 elements by binary insertion sort. The runs are
+kept on a stack whose lengths grow at least as fast as the Fibonacci
+numbers, and adjacent runs are merged by timMerge() when that fails. It
+costs O(n) time on sorted or reversed input and O(nlogn) in the worst case.
+
+@param arr       The array to be sorted
+@param n         The amount of elements in the array
+@param cmp       The comparator
+@param maxBuffer The maximum amount of elements moved to the temporary
+                 buffer, n / 2 at most. With a smaller buffer, larger
+                 merges are done by rotations, in O(nlog^2 n) time if
+                 there is no buffer.
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void timSort(Value *const arr,
+             const std::size_t n,
+             const PredCmp& cmp = PredCmp(),
+             const std::size_t maxBuffer = (std::size_t)-1) {
+    const std::size_t MIN_MERGE = 32;
+    if (n < MIN_MERGE) {
+        binaryInsertionSort<Value, PredCmp>(arr, 0, n, 1, cmp);
+        return;
+    }
+    // The minimum run length, in [16, 32], such that n / minRun is close
+    // to but not more than a power of 2
+    std::size_t minRun = n, odd = 0;
+    while (minRun >= MIN_MERGE) {
+        odd |= minRun & 1;
+        minRun >>= 1;
+    }
+    minRun += odd;
+
+    struct Run {
+        std::size_t base, len;
+    };
+    std::vector<Run> runs;
+    std::vector<Value> buffer;
+    std::size_t minGallop = 7;
+    auto mergeAt = [&](const std::size_t i) {
+        const Run a = runs[i], b = runs[i + 1];
+        runs[i].len = a.len + b.len;
+        runs.erase(runs.begin() + i + 1);
+        // Skip the elements of the first run that are already in place,
+        // and the ones of the second run after its last element
+        const std::size_t skip = gallopUpper(arr + a.base, a.len, arr[b.base], cmp);
+        if (skip == a.len) {
+            return;
+        }
+        const std::size_t lenB = gallopLower(arr + b.base, b.len, arr[b.base - 1], cmp);
+        timMerge<Value, PredCmp>(arr, a.base + skip, b.base, b.base + lenB, cmp, buffer,
+                                 std::min(maxBuffer, n / 2), minGallop);
+    };
+
+    for (std::size_t lo = 0; lo < n;) {
+        // Find the run starting at lo
+        std::size_t hi = lo + 1;
+        if (hi < n) {
+            const bool descending = cmp(arr[hi], arr[lo]);
+            ++hi;
+            if (descending) {
+                while (hi < n && cmp(arr[hi], arr[hi - 1])) {
+                    ++hi;
+                }
+                std::reverse(arr + lo, arr + hi);
+            } else {
+                while (hi < n && !cmp(arr[hi], arr[hi - 1])) {
+                    ++hi;
+                }
+            }
+        }
+        if (hi - lo < minRun) {
+            const std::size_t end = std::min(n, lo + minRun);
+            binaryInsertionSort<Value, PredCmp>(arr, lo, end, hi, cmp);
+            hi = end;
+        }
+        runs.push_back(Run{lo, hi - lo});
+        lo = hi;
+        // Restore the invariants on the lengths of the top runs
+        while (runs.size() > 1) {
+            std::size_t i = runs.size() - 2;
+            if ((i > 0 && runs[i - 1].len <= runs[i].len + runs[i + 1].len) ||
+                (i > 1 && runs[i - 2].len <= runs[i - 1].len + runs[i].len)) {
+                if (runs[i - 1].len < runs[i + 1].len) {
+                    --i;
+                }
+            } else if (runs[i].len > runs[i + 1].len) {
+                break;
+            }
+            mergeAt(i);
+        }
+    }
+    while (runs.size() > 1) {
+        std::size_t i = runs.size() - 2;
+        if (i > 0 && runs[i - 1].len < runs[i + 1].len) {
+            --i;
+        }
+        mergeAt(i);
+    }
+}
+
+/*
+Partition an array on several threads. Each thread partitions one chunk,
+then the elements on the wrong side of the final boundary are swapped in
+pairs, split evenly among the threads.
+
+@param arr     The array to be processed
+@param n       The amount of elements in the array
+@param pred    A unary predicate. The elements satisfying it are moved
+               to the front.
+@param threads The amount of threads
+@return        The amount of elements satisfying the predicate
+*/
+template<typename Value, typename Pred>
+std::size_t parallelPartition(Value *const arr,
+                              const std::size_t n,
+                              const Pred& pred,
+                              const std::size_t threads) {
+    struct Segment {
+        std::size_t begin, end;
+    };
+    const std::size_t chunk = (n + threads - 1) / threads;
+    std::vector<std::size_t> mids(threads);
+    parallelFor(threads, [&](const std::size_t t) {
+        const std::size_t b = std::min(n, t * chunk), e = std::min(n, b + chunk);
+        mids[t] = std::partition(arr + b, arr + e, pred) - arr;
+    });
+    std::size_t total = 0;
+    for (std::size_t t = 0; t < threads; ++t) {
+        total += mids[t] - std::min(n, t * chunk);
+    }
+    // The elements failing the predicate before 'total', and the ones
+    // satisfying it from 'total' on. There are as many of each.
+    std::vector<Segment> wrongLeft, wrongRight;
+    std::size_t wrong = 0;
+    for (std::size_t t = 0; t < threads; ++t) {
+        const std::size_t b = std::min(n, t * chunk), e = std::min(n, b + chunk);
+        if (mids[t] < total) {
+            wrongLeft.push_back(Segment{mids[t], std::min(e, total)});
+            wrong += wrongLeft.back().end - wrongLeft.back().begin;
+        }
+        if (mids[t] > total) {
+            wrongRight.push_back(Segment{std::max(b, total), mids[t]});
+        }
+    }
+    parallelFor(threads, [&](const std::size_t t) {
+        const std::size_t from = wrong * t / threads, to = wrong * (t + 1) / threads;
+        // Find the from-th wrong element of each side
+        std::size_t l = 0, r = 0, lpos = from, rpos = from;
+        while (l < wrongLeft.size() && lpos >= wrongLeft[l].end - wrongLeft[l].begin) {
+            lpos -= wrongLeft[l].end - wrongLeft[l].begin;
+            ++l;
+        }
+        while (r < wrongRight.size() && rpos >= wrongRight[r].end - wrongRight[r].begin) {
+            rpos -= wrongRight[r].end - wrongRight[r].begin;
+            ++r;
+        }
+        lpos += l < wrongLeft.size() ? wrongLeft[l].begin : 0;
+        rpos += r < wrongRight.size() ? wrongRight[r].begin : 0;
+        for (std::size_t i = from; i < to; ++i) {
+            std::swap(arr[lpos], arr[rpos]);
+            if (++lpos == wrongLeft[l].end && ++l < wrongLeft.size()) {
+                lpos = wrongLeft[l].begin;
+            }
+            if (++rpos == wrongRight[r].end && ++r < wrongRight.size()) {
+                rpos = wrongRight[r].begin;
+            }
+        }
+    });
+    return total;
+}
+
+/*
+The parallel quicksort algorithm to sort an unordered array. The ranges
+left by each partition are tasks of a work-stealing pool, so that idle
+threads take over the largest ranges. Ranges of at most 16384 elements,
+and ranges that reach the depth limit of introSort(), are sorted by
+introSort() on one thread. The comparator must be safe to call from
+several threads at a time and must not throw.
+
+@param arr     The array to be sorted
+@param n       The amount of elements in the array
+@param cmp     The comparator
+@param threads The amount of threads
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void parallelSort(Value *const arr,
+                  const std::size_t n,
+                  const PredCmp& cmp = PredCmp(),
+                  const std::size_t threads = std::thread::hardware_concurrency()) {
+    const std::size_t CUTOFF = 16384;
+    if (n < 2) {
+        return;
+    }
+    if (threads <= 1 || n <= CUTOFF) {
+        introSort<Value, PredCmp>(arr, 0, n - 1, cmp);
+        return;
+    }
+    struct Range {
+        std::size_t left, right, depth;
+    };
+    WorkStealingPool<Range> pool(threads);
+    pool.run(Range{0, n - 1, introDepthLimit(n)},
+             [arr, &cmp](WorkStealingPool<Range>& p, const std::size_t w, const Range& r) {
+        std::size_t left = r.left, right = r.right, depth = r.depth;
+        while (right - left >= CUTOFF && depth > 0) {
+            --depth;
+            std::size_t i = quickPartition<Value, PredCmp>(arr, left, right, cmp);
+            // Offer the larger side to the other threads and keep the smaller one
+            if (i - left < right - i) {
+                p.spawn(w, Range{i + 1, right, depth});
+                right = i - 1;
+            } else {
+                p.spawn(w, Range{left, i - 1, depth});
+                left = i + 1;
+            }
+        }
+        introSort<Value, PredCmp>(arr, left, right, cmp);
+    });
+}
+
+/*
+The parallel quickselect algorithm to find the kth smallest/biggest
+element in an unordered array. Each round partitions the range around the
+median of three on all threads with parallelPartition(), first into the
+elements smaller than the pivot and the others, then, if needed, into the
+elements equal to the pivot and the bigger ones. Ranges of at most 16384
+elements are finished by introSelect() on one thread. After its execution,
+the kth element will be stored at arr[k]. The comparator must be safe to
+call from several threads at a time.
+
+@param arr     The array to be processed
+@param n       The amount of elements in the array
+@param k       The kth element to find
+@param cmp     The comparator
+@param threads The amount of threads
+*/
+template<typename Value, typename PredCmp = std::less<Value>>
+void parallelQuickSelect(Value *const arr,
+                         const std::size_t n,
+                         const std::size_t k,
+                         const PredCmp& cmp = PredCmp(),
+                         const std::size_t threads = std::thread::hardware_concurrency()) {
+    const std::size_t CUTOFF = 16384;
+    if (n == 0) {
+        return;
+    }
+    std::size_t left = 0, right = n - 1, depth = introDepthLimit(n);
+    while (threads > 1 && right - left >= CUTOFF && depth > 0) {
+        --depth;
+        const Value p = pivot<Value, PredCmp>(arr, left, right, cmp);
+        const std::size_t less = left + parallelPartition(arr + left, right - left + 1,
+            [&cmp, &p](const Value& x) {
+                return cmp(x, p);
+            }, threads);
+        if (k < less) {
+            right = less - 1;
+            continue;
+        }
+        // The pivot is in the range, so at least one element is equal to it
+        const std::size_t equal = less + parallelPartition(arr + less, right - less + 1,
+            [&cmp, &p](const Value& x) {
+                return !cmp(p, x);
+            }, threads);
+        if (k < equal) {
+            return;
+        }
+        left = equal;
+    }
+    introSelect<Value, PredCmp>(arr, left, right, k, cmp);
+}
+
+/*
+Sort an array of int32 or float keys in ascending order with sorting
+networks. Blocks of 32 keys are sorted by networkSort(), then merged in
+pairs by networkMerge() with a buffer of n keys. The networks run on AVX2
+or SSE4.1 registers when the compiler enables them, e.g. with -mavx2, and
+on scalar registers otherwise.
+
+@param arr The array to be sorted
+@param n   The amount of keys in the array
+*/
+template<typename Value>
+void simdSort(Value *const arr, const std::size_t n) {
+    const std::size_t BLOCK = 32;
+    for (std::size_t i = 0; i < n; i += BLOCK) {
+        networkSort<Value>(arr + i, std::min(BLOCK, n - i));
+    }
+    if (n <= BLOCK) {
+        return;
+    }
+    std::vector<Value> buffer(n);
+    Value *src = arr, *dst = buffer.data();
+    for (std::size_t width = BLOCK; width < n; width *= 2) {
+        for (std::size_t i = 0; i < n; i += 2 * width) {
+            const std::size_t mid = std::min(i + width, n), end = std::min(i + 2 * width, n);
+            networkMerge<Value>(src + i, mid - i, src + mid, end - mid, dst + i);
+        }
+        std::swap(src, dst);
+    }
+    if (src != arr) {
+        std::copy(src, src + n, arr);
+    }
+}
+
+/*
+The unsigned integer type of the same width as a radix sort key.
+
+@param Key The type of the key. It must be an arithmetic type of at
+           most 8 bytes.
+*/
+template<typename Key>
+struct RadixUnsigned {
+    static_assert(std::is_arithmetic<Key>::value && sizeof(Key) <= 8,
+                  "A radix sort key must be an arithmetic type of at most 8 bytes");
+    using type = typename std::conditional<sizeof(Key) == 8, std::uint64_t,
+                 typename std::conditional<sizeof(Key) == 4, std::uint32_t,
+                 typename std::conditional<sizeof(Key) == 2, std::uint16_t,
+                 std::uint8_t>::type>::type>::type;
+};
+
+// Unsigned integers
+template<typename Key>
+typename RadixUnsigned<Key>::type radixKey(const Key key, std::false_type, std::false_type) noexcept {
+    return (typename RadixUnsigned<Key>::type)key;
+}
+
+// Signed integers
+template<typename Key>
+typename RadixUnsigned<Key>::type radixKey(const Key key, std::false_type, std::true_type) noexcept {
+    using U = typename RadixUnsigned<Key>::type;
+    return (U)((U)key ^ ((U)1 << (sizeof(U) * 8 - 1)));
+}
+
+// Floating point numbers
+template<typename Key>
+typename RadixUnsigned<Key>::type radixKey(const Key key, std::true_type, std::true_type) noexcept {
+    using U = typename RadixUnsigned<Key>::type;
+    U bits;
+    std::memcpy(&bits, &key, sizeof(U));
+    const U sign = (U)1 << (sizeof(U) * 8 - 1);
+    return (bits & sign) ? (U)~bits : (U)(bits | sign);
+}
+
+/*
+Map a key to an unsigned integer in the same order. Signed integers have
+their sign bit flipped. Floating point numbers have all bits flipped if
+they are negative, and their sign bit flipped otherwise.
+*/
+template<typename Key>
+typename RadixUnsigned<Key>::type radixKey(const Key key) noexcept {
+    return radixKey(key, std::is_floating_point<Key>(), std::is_signed<Key>());
+}
+
+/*
+The LSD radix sort algorithm for keys of fixed width. The histograms of
+all bytes of the keys are counted in one pass. Each byte is then scattered
+from the array to a buffer or back, skipping the bytes that are the same
+in all keys. It is stable.
+
+@param arr   The array to be sorted. The elements must be default constructible.
+@param n     The amount of elements in the array
+@param keyOf The function to get the key of an element
+*/
+template<typename Value, typename KeyOf>
+void lsdRadixSort(Value *const arr, const std::size_t n, const KeyOf& keyOf) {
+    using Key = typename std::decay<decltype(keyOf(*arr))>::type;
+    using U = typename RadixUnsigned<Key>::type;
+    const std::size_t BYTES = sizeof(U);
+    if (n < 64) {
+        insertionSort(arr, n, [&keyOf](const Value& a, const Value& b) {
+            return radixKey(keyOf(a)) < radixKey(keyOf(b));
+        });
+        return;
+    }
+    const U first = radixKey(keyOf(arr[0]));
+    std::vector<std::size_t> counts(BYTES * 256, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const U key = radixKey(keyOf(arr[i]));
+        for (std::size_t b = 0; b < BYTES; ++b) {
+            ++counts[b * 256 + ((key >> (b * 8)) & 255)];
+        }
+    }
+    std::vector<Value> buffer(n);
+    Value *from = arr, *to = buffer.data();
+    for (std::size_t b = 0; b < BYTES; ++b) {
+        std::size_t *const offsets = &counts[b * 256];
+        if (offsets[(first >> (b * 8)) & 255] == n) {
+            continue;  // All keys have the same byte
+        }
+        std::size_t sum = 0;
+        for (std::size_t d = 0; d < 256; ++d) {
+            const std::size_t cnt = offsets[d];
+            offsets[d] = sum;
+            sum += cnt;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            to[offsets[(radixKey(keyOf(from[i])) >> (b * 8)) & 255]++] = std::move(from[i]);
+        }
+        std::swap(from, to);
+    }
+    if (from != arr) {
+        std::move(from, from + n, arr);
+    }
+}
+
+/*
+The American flag sort algorithm, an in-place MSD radix sort, for string
+keys. The elements are split into 257 buckets by the character at a given
+depth, the first bucket holding the keys that end before it, and each
+bucket except the first is sorted by the next character. It is not stable.
+Only the buckets other than the largest one are sorted by recursion, and
+the largest one by the loop, so the recursion depth is O(log n) even when
+the keys are prefixes of each other.
+
+@param arr   The array to be sorted
+@param n     The amount of elements in the array
+@param depth The amount of leading characters that all keys share
+@param keyOf The function to get the key of an element
+*/
+template<typename Value, typename KeyOf>
+void americanFlagSort(Value *arr, std::size_t n, std::size_t depth, const KeyOf& keyOf) {
+    const std::size_t BUCKETS = 257;
+    auto bucketOf = [&keyOf, &depth](const Value& v) -> std::size_t {
+        const std::string &key = keyOf(v);
+        return depth < key.size() ? (std::size_t)(unsigned char)key[depth] + 1 : 0;
+    };
+    while (n >= 32) {
+        std::size_t counts[BUCKETS] = {0};
+        for (std::size_t i = 0; i < n; ++i) {
+            ++counts[bucketOf(arr[i])];
+        }
+        if (counts[bucketOf(arr[0])] == n) {  // All keys have the same character
+            if (counts[0] == n) {
+                return;  // All keys are equal
+            }
+            ++depth;
+            continue;
+        }
+        // Swap each element into its bucket
+        std::size_t next[BUCKETS], end[BUCKETS];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            next[b] = sum;
+            sum += counts[b];
+            end[b] = sum;
+        }
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            while (next[b] < end[b]) {
+                const std::size_t v = bucketOf(arr[next[b]]);
+                if (v == b) {
+                    ++next[b];
+                } else {
+                    std::swap(arr[next[b]], arr[next[v]++]);
+                }
+            }
+        }
+        std::size_t largest = 1;
+        for (std::size_t b = 2; b < BUCKETS; ++b) {
+            if (counts[b] > counts[largest]) {
+                largest = b;
+            }
+        }
+        for (std::size_t b = 1; b < BUCKETS; ++b) {
+            if (b != largest && counts[b] > 1) {
+                americanFlagSort(arr + end[b] - counts[b], counts[b], depth + 1, keyOf);
+            }
+        }
+        arr += end[largest] - counts[largest];
+        n = counts[largest];
+        ++depth;
+    }
+    // Use insertion sort for small array
+    insertionSort(arr, n, [&keyOf](const Value& a, const Value& b) {
+        return keyOf(a) < keyOf(b);
+    });
+}
+
+// Choose the radix sort for numeric keys
+template<typename Value, typename KeyOf>
+void radixSortImpl(Value *const arr, const std::size_t n, const KeyOf& keyOf, std::true_type) {
+    lsdRadixSort(arr, n, keyOf);
+}
+
+// Choose the radix sort for string keys
+template<typename Value, typename KeyOf>
+void radixSortImpl(Value *const arr, const std::size_t n, const KeyOf& keyOf, std::false_type) {
+    static_assert(std::is_same<typename std::decay<decltype(keyOf(*arr))>::type, std::string>::value,
+                  "A radix sort key must be an arithmetic type or std::string");
+    americanFlagSort(arr, n, 0, keyOf);
+}
+
+/*
+The radix sort algorithm to sort an array by the keys of its elements in
+ascending order. Numeric keys, i.e. integers and floating point numbers,
+are sorted by lsdRadixSort(), which is stable and needs a buffer of n
+elements. std::string keys are sorted in place by americanFlagSort().
+
+@param arr   The array to be sorted
+@param n     The amount of elements in the array
+@param keyOf The function to get the key of an element. Its param is an
+             element, and it returns an arithmetic value or a std::string.
+*/
+template<typename Value, typename KeyOf>
+void radixSort(Value *const arr, const std::size_t n, const KeyOf& keyOf) {
+    using Key = typename std::decay<decltype(keyOf(*arr))>::type;
+    radixSortImpl(arr, n, keyOf, std::integral_constant<bool, std::is_arithmetic<Key>::value>());
+}
+
+// Return an element itself as its key
+struct RadixIdentity {
+    template<typename Value>
+    const Value& operator()(const Value& v) const noexcept {
+        return v;
+    }
+};
+
+/*
+The radix sort algorithm to sort an array of numbers or std::strings in
+ascending order.
+
+@param arr The array to be sorted
+@param n   The amount of elements in the array
+*/
+template<typename Value>
+void radixSort(Value *const arr, const std::size_t n) {
+    radixSort(arr, n, RadixIdentity());
+}
+
 TASTYLIB_NS_END
 
 #endif
@@ -0,0 +1,144 @@
+#ifndef TASTYLIB_TOPK_H_
+#define TASTYLIB_TOPK_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/BinaryHeap.h"
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+Select the K best values of a stream in O(K) memory.
+
+The values kept are stored in a BinaryHeap of capacity K whose root is the
+worst of them, i.e. the threshold. Once K values are kept, a new value
+costs one comparison with the threshold if it is not better, and replaces
+the root with one percolation otherwise. Partial results, e.g. one per
+thread, can be merged.
+
+@param Value   The type of the values
+@param PredCmp A binary predicate. If PredCmp(a, b) == true, then value 'a'
+               is better than value 'b'. By default it keeps the K largest
+               values.
+*/
+template<typename Value, typename PredCmp = std::greater<Value>>
+class TopK {
+private:
+    // Order the heap with the worst value at the root
+    struct Worse {
+        PredCmp predCmp;
+
+        explicit Worse(const PredCmp& cmp) : predCmp(cmp) {}
+
+        bool operator()(const Value& a, const Value& b) const {
+            return predCmp(b, a);
+        }
+    };
+
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Initialize the selector.
+
+    @param k   The amount of values to keep
+    @param cmp The comparator
+    */
+    explicit TopK(const SizeType k, const PredCmp& cmp = PredCmp())
+    : capacity(k), predCmp(cmp), heap(Worse(cmp)) {
+        heap.reserve(k);
+    }
+
+    // Return the amount of values kept
+    SizeType getSize() const noexcept {
+        return heap.getSize();
+    }
+
+    // Return the maximum amount of values kept, i.e. K
+    SizeType getCapacity() const noexcept {
+        return capacity;
+    }
+
+    // Return true if K values are kept
+    bool isFull() const noexcept {
+        return heap.getSize() == capacity;
+    }
+
+    // Remove all values
+    void clear() noexcept {
+        heap.clear();
+    }
+
+    /*
+    Return the worst value kept. Once the selector is full, only
+    values better than it are accepted.
+    Precondition: getSize() > 0.
+    */
+    const Value& getThreshold() const noexcept {
+        return heap.top();
+    }
+
+    /*
+    Offer a value to the selector.
+
+    @param val The value
+    @return    True if the value is kept
+    */
+    bool push(const Value& val) {
+        if (heap.getSize() < capacity) {
+            heap.push(val);
+            return true;
+        } else if (capacity > 0 && predCmp(val, heap.top())) {
+            heap.replaceTop(val);
+            return true;
+        }
+        return false;
+    }
+
+    bool push(Value&& val) {
+        if (heap.getSize() < capacity) {
+            heap.push(std::move(val));
+            return true;
+        } else if (capacity > 0 && predCmp(val, heap.top())) {
+            heap.replaceTop(std::move(val));
+            return true;
+        }
+        return false;
+    }
+
+    /*
+    Offer all values kept by another selector, so that this one keeps the
+    best K values of both streams.
+
+    @param other The other selector
+    */
+    void merge(const TopK& other) {
+        other.heap.traverse([this](const Value& val) {
+            push(val);
+        });
+    }
+
+    /*
+    Return the values kept, from the best to the worst. The selector
+    is left empty.
+    */
+    std::vector<Value> takeSorted() {
+        std::vector<Value> res(heap.getSize());
+        for (SizeType i = res.size(); i > 0; --i) {
+            res[i - 1] = heap.popValue();
+        }
+        return res;
+    }
+
+private:
+    SizeType capacity;
+    PredCmp predCmp;
+    BinaryHeap<Value, Worse> heap;
+};
+
+TASTYLIB_NS_END
+
+#endif
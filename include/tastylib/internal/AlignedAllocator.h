@@ -0,0 +1,68 @@
+#ifndef TASTYLIB_INTERNAL_ALIGNEDALLOCATOR_H_
+#define TASTYLIB_INTERNAL_ALIGNEDALLOCATOR_H_
+
+#include "tastylib/internal/base.h"
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+TASTYLIB_NS_BEGIN
+
+/*
+An allocator that aligns every block to a given boundary, usually the size
+of a cache line. The block is taken from malloc() with 'Align' extra bytes,
+and the address returned by malloc() is kept right before the aligned one.
+
+@param T     The type of the elements
+@param Align The alignment in bytes. It must be a power of 2 and at least
+             the size of a pointer.
+*/
+template<typename T, std::size_t Align = 64>
+class AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0 && Align >= sizeof(void*),
+                  "Align must be a power of 2 and hold a pointer");
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() noexcept {}
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(const std::size_t n) {
+        void *raw = std::malloc(n * sizeof(T) + Align);
+        if (!raw) {
+            throw std::bad_alloc();
+        }
+        const std::uintptr_t addr = ((std::uintptr_t)raw + Align) & ~(std::uintptr_t)(Align - 1);
+        ((void**)addr)[-1] = raw;
+        return (T*)addr;
+    }
+
+    void deallocate(T *const p, const std::size_t) noexcept {
+        if (p) {
+            std::free(((void**)p)[-1]);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const noexcept {
+        return false;
+    }
+};
+
+TASTYLIB_NS_END
+
+#endif
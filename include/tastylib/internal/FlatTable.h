@@ -0,0 +1,333 @@
+#ifndef TASTYLIB_INTERNAL_FLATTABLE_H_
+#define TASTYLIB_INTERNAL_FLATTABLE_H_
+
+#include "tastylib/internal/base.h"
+#include "tastylib/internal/hash.h"
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+TASTYLIB_NS_BEGIN
+
+/*
+The open addressing storage shared by FlatHashTable and HashMap.
+
+Each slot owns a one-byte control word (SwissTable style) that is either
+EMPTY, DELETED or the 7 high bits of the element's hash value. A lookup
+scans the control bytes with linear probing and only calls PredCmp on the
+slots whose 7-bit tag matches, so most lookups touch one cache line of
+control bytes and one cache line of slots.
+
+@param Slot    The type of the elements stored in the slots
+@param KeyOf   A unary functor that returns the key of a slot
+@param PredCmp A binary predicate that checks if two keys are equal
+@param Hash    A unary functor that computes the hash value of a key
+*/
+template<typename Slot, typename KeyOf, typename PredCmp, typename Hash>
+class FlatTable {
+private:
+    using Alloc = std::allocator<Slot>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using SizeType = std::size_t;
+
+    static const SizeType MIN_BUCKET = 8;
+    static const SizeType NPOS = (SizeType)-1;
+
+    /*
+    Initialize the table.
+
+    @param n   Expected buckets amount. In practice, the
+               amount of buckets may be greater than 'n'
+    @param cmp The comparator
+    @param h   The hash function
+    */
+    FlatTable(const SizeType n, const PredCmp& cmp, const Hash& h)
+    : size(0), deleted(0), bucketNum(1), predCmp(cmp), hasher(h),
+      ctrl(emptyCtrl()), slots(nullptr) {
+        rehash(n);
+    }
+
+    // Forbid copy
+    FlatTable(const FlatTable&) = delete;
+    FlatTable& operator=(const FlatTable&) = delete;
+
+    // Move ctor
+    FlatTable(FlatTable&& other) noexcept
+    : size(other.size), deleted(other.deleted), bucketNum(other.bucketNum),
+      predCmp(std::move(other.predCmp)), hasher(std::move(other.hasher)),
+      ctrl(other.ctrl), slots(other.slots) {
+        other.reset();
+    }
+
+    // Move assignment
+    FlatTable& operator=(FlatTable&& other) noexcept {
+        if (this != &other) {
+            release();
+            size = other.size;
+            deleted = other.deleted;
+            bucketNum = other.bucketNum;
+            predCmp = std::move(other.predCmp);
+            hasher = std::move(other.hasher);
+            ctrl = other.ctrl;
+            slots = other.slots;
+            other.reset();
+        }
+        return *this;
+    }
+
+    // Dtor
+    ~FlatTable() noexcept {
+        release();
+    }
+
+    // Return the amount of elements
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return the amount of buckets
+    SizeType getBucketCount() const noexcept {
+        return slots ? bucketNum : 0;
+    }
+
+    // Remove all elements
+    void clear() noexcept {
+        if (slots) {
+            destroyAll();
+            std::memset(ctrl, EMPTY, bucketNum);
+        }
+        size = 0;
+        deleted = 0;
+    }
+
+    // Return the hash value of a key after mixing its bits
+    template<typename K>
+    std::uint64_t hashOf(const K& key) const {
+        return mixHash((std::uint64_t)hasher(key));
+    }
+
+    /*
+    Find the slot of a key.
+
+    @param key The key to be found
+    @param h   The hash value of 'key'
+    @return    The index of the slot. If the key doesn't exist, return NPOS.
+    */
+    template<typename K>
+    SizeType find(const K& key, const std::uint64_t h) const {
+        const std::uint8_t tag = tagOf(h);
+        for (SizeType i = indexOf(h); ; i = (i + 1) & (bucketNum - 1)) {
+            if (ctrl[i] == tag && predCmp(keyOf(slots[i]), key)) {
+                return i;
+            } else if (ctrl[i] == EMPTY) {
+                return NPOS;
+            }
+        }
+    }
+
+    // Hint the processor to fetch the first slot probed for a hash value
+    void prefetch(const std::uint64_t h) const noexcept {
+        const SizeType i = indexOf(h);
+        TASTYLIB_PREFETCH(ctrl + i);
+        TASTYLIB_PREFETCH(slots + i);
+    }
+
+    /*
+    Construct an element whose key is known to be absent from the table.
+
+    @param h    The hash value of the element's key
+    @param args The arguments to construct the element
+    @return     The index of the new slot
+    */
+    template<typename... Args>
+    SizeType insertNew(const std::uint64_t h, Args&&... args) {
+        if (size + deleted + 1 > maxLoad(bucketNum)) {
+            // Drop tombstones in place if there are many of them, otherwise grow
+            rehash(size + 1 > (maxLoad(bucketNum) >> 1) ? bucketNum << 1 : bucketNum);
+        }
+        const SizeType pos = findFree(h);
+        AllocTraits::construct(alloc, slots + pos, std::forward<Args>(args)...);
+        if (ctrl[pos] == DELETED) {
+            --deleted;
+        }
+        ctrl[pos] = tagOf(h);
+        ++size;
+        return pos;
+    }
+
+    // Remove the element stored at a given slot
+    void erase(const SizeType pos) noexcept {
+        AllocTraits::destroy(alloc, slots + pos);
+        --size;
+        // A probing sequence passing this slot would stop at the next
+        // slot if it is empty, so no tombstone is needed in that case.
+        if (ctrl[(pos + 1) & (bucketNum - 1)] == EMPTY) {
+            ctrl[pos] = EMPTY;
+        } else {
+            ctrl[pos] = DELETED;
+            ++deleted;
+        }
+    }
+
+    // Return the element stored at a given slot
+    Slot& at(const SizeType pos) noexcept {
+        return slots[pos];
+    }
+
+    const Slot& at(const SizeType pos) const noexcept {
+        return slots[pos];
+    }
+
+    /*
+    Traverse the elements in slot order.
+
+    @param f The function to traverse each element. Its param is the element.
+    */
+    template<typename Func>
+    void traverse(const Func& f) const {
+        for (SizeType i = 0; i < bucketNum; ++i) {
+            if (isFull(ctrl[i])) {
+                f(slots[i]);
+            }
+        }
+    }
+
+    template<typename Func>
+    void traverse(const Func& f) {
+        for (SizeType i = 0; i < bucketNum; ++i) {
+            if (isFull(ctrl[i])) {
+                f(slots[i]);
+            }
+        }
+    }
+
+    /*
+    Rehash the table. All tombstones are dropped.
+
+    @param n Expected buckets amount. In practice, the amount of buckets
+             may be greater than 'n' since the table always keeps enough
+             buckets to hold its elements under the maximum load factor.
+    */
+    void rehash(const SizeType n) {
+        SizeType num = MIN_BUCKET;
+        while (num < n || size > maxLoad(num)) {
+            num <<= 1;
+        }
+        std::uint8_t *oldCtrl = ctrl;
+        Slot *oldSlots = slots;
+        SizeType oldNum = bucketNum;
+
+        // Allocate both arrays before changing the table, so it stays valid if either throws
+        std::unique_ptr<std::uint8_t[]> newCtrl(new std::uint8_t[num]);
+        slots = alloc.allocate(num);
+        ctrl = newCtrl.release();
+        std::memset(ctrl, EMPTY, num);
+        bucketNum = num;
+        deleted = 0;
+
+        if (oldSlots) {
+            for (SizeType i = 0; i < oldNum; ++i) {
+                if (isFull(oldCtrl[i])) {
+                    const std::uint64_t h = hashOf(keyOf(oldSlots[i]));
+                    const SizeType pos = findFree(h);
+                    AllocTraits::construct(alloc, slots + pos, std::move(oldSlots[i]));
+                    AllocTraits::destroy(alloc, oldSlots + i);
+                    ctrl[pos] = tagOf(h);
+                }
+            }
+            alloc.deallocate(oldSlots, oldNum);
+            delete[] oldCtrl;
+        }
+    }
+
+private:
+    // Return the bucket where the probing of a hash value begins
+    SizeType indexOf(const std::uint64_t h) const noexcept {
+        return (SizeType)h & (bucketNum - 1);
+    }
+
+    // Return the 7-bit tag of a hash value stored in the control bytes
+    static std::uint8_t tagOf(const std::uint64_t h) noexcept {
+        return (std::uint8_t)(h >> 57);
+    }
+
+    // Return true if a control byte marks a slot holding an element
+    static bool isFull(const std::uint8_t c) noexcept {
+        return (c & EMPTY) == 0;
+    }
+
+    // Return the maximum amount of occupied slots (7/8 of the buckets)
+    static SizeType maxLoad(const SizeType num) noexcept {
+        return (num >> 3) * 7;
+    }
+
+    // Return the first empty or deleted slot on the probing sequence of a hash value
+    SizeType findFree(const std::uint64_t h) const noexcept {
+        SizeType i = indexOf(h);
+        while (isFull(ctrl[i])) {
+            i = (i + 1) & (bucketNum - 1);
+        }
+        return i;
+    }
+
+    // Destroy all elements without touching the control bytes
+    void destroyAll() noexcept {
+        for (SizeType i = 0; i < bucketNum; ++i) {
+            if (isFull(ctrl[i])) {
+                AllocTraits::destroy(alloc, slots + i);
+            }
+        }
+    }
+
+    // Free all resources
+    void release() noexcept {
+        if (slots) {
+            destroyAll();
+            alloc.deallocate(slots, bucketNum);
+            delete[] ctrl;
+        }
+        reset();
+    }
+
+    // Leave the table empty without owning any resources
+    void reset() noexcept {
+        size = 0;
+        deleted = 0;
+        bucketNum = 1;
+        ctrl = emptyCtrl();
+        slots = nullptr;
+    }
+
+    /*
+    Return the control bytes of a table which owns no resources. It has one
+    EMPTY bucket so that lookups on a moved-from table need no extra check.
+    */
+    static std::uint8_t* emptyCtrl() noexcept {
+        static std::uint8_t empty = EMPTY;
+        return &empty;
+    }
+
+private:
+    static const std::uint8_t EMPTY = 0x80;
+    static const std::uint8_t DELETED = 0xfe;
+
+    SizeType size;
+    SizeType deleted;  // Amount of tombstones
+    SizeType bucketNum;
+
+    KeyOf keyOf;
+    PredCmp predCmp;
+    Hash hasher;
+    Alloc alloc;
+
+    std::uint8_t *ctrl;
+    Slot *slots;
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TASTYLIB_INTERNAL_IOTHREAD_H_
+#define TASTYLIB_INTERNAL_IOTHREAD_H_
+
+#include "tastylib/internal/base.h"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A thread that runs file reads and writes in the background, one at a time
+and in the order they are submitted. So a task may reuse a buffer that an
+earlier task writes out without waiting for it.
+
+The objects used by the tasks must outlive the IOThread. The dtor drops
+the tasks that have not started and waits for the running one.
+*/
+class IOThread {
+public:
+    // Start the thread
+    IOThread() : stopping(false), worker([this]() { run(); }) {}
+
+    // Forbid copy
+    IOThread(const IOThread&) = delete;
+    IOThread& operator=(const IOThread&) = delete;
+
+    // Dtor
+    ~IOThread() noexcept {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+            tasks.clear();
+        }
+        ready.notify_one();
+        worker.join();
+    }
+
+    /*
+    Add a task to the queue.
+
+    @param f The task. Its exceptions are thrown by the returned future.
+    @return  The future to wait for the task
+    */
+    template<typename Func>
+    std::future<void> submit(Func&& f) {
+        std::packaged_task<void()> task(std::forward<Func>(f));
+        std::future<void> res = task.get_future();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            tasks.push_back(std::move(task));
+        }
+        ready.notify_one();
+        return res;
+    }
+
+private:
+    // Run the tasks until the dtor is called
+    void run() {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                ready.wait(guard, [this]() {
+                    return stopping || !tasks.empty();
+                });
+                if (stopping) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+private:
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::packaged_task<void()>> tasks;
+    bool stopping;
+    std::thread worker;  // Declared last, so that it starts after the other members
+};
+
+TASTYLIB_NS_END
+
+#endif
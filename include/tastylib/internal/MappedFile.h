@@ -0,0 +1,147 @@
+#ifndef TASTYLIB_INTERNAL_MAPPEDFILE_H_
+#define TASTYLIB_INTERNAL_MAPPEDFILE_H_
+
+#include "tastylib/internal/base.h"
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TASTYLIB_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TASTYLIB_NS_BEGIN
+
+/*
+A read-only view of a whole file. On POSIX systems the file is mapped
+with mmap(), so the pages are loaded lazily and shared with the page
+cache. On other systems the file is read into a buffer.
+*/
+class MappedFile {
+public:
+    using SizeType = std::size_t;
+
+    // Create an empty view
+    MappedFile() noexcept : data(nullptr), size(0), mapped(false) {}
+
+    /*
+    Open a file. Throw std::runtime_error if the file can't be read.
+
+    @param path The path of the file
+    */
+    explicit MappedFile(const std::string& path)
+    : data(nullptr), size(0), mapped(false) {
+#ifdef TASTYLIB_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        size = (SizeType)st.st_size;
+        if (size > 0) {
+            void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+            data = (const char*)addr;
+            mapped = true;
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        size = (SizeType)in.tellg();
+        buffer.reset(new char[size ? size : 1]);
+        in.seekg(0);
+        if (!in.read(buffer.get(), size)) {
+            throw std::runtime_error("MappedFile: cannot read " + path);
+        }
+        data = buffer.get();
+#endif
+    }
+
+    // Forbid copy
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Move ctor
+    MappedFile(MappedFile&& other) noexcept
+    : data(other.data), size(other.size), mapped(other.mapped),
+      buffer(std::move(other.buffer)) {
+        other.data = nullptr;
+        other.size = 0;
+        other.mapped = false;
+    }
+
+    // Move assignment
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data = other.data;
+            size = other.size;
+            mapped = other.mapped;
+            buffer = std::move(other.buffer);
+            other.data = nullptr;
+            other.size = 0;
+            other.mapped = false;
+        }
+        return *this;
+    }
+
+    // Dtor
+    ~MappedFile() noexcept {
+        release();
+    }
+
+    // Return the content of the file
+    const char* getData() const noexcept {
+        return data;
+    }
+
+    // Return the size of the file in bytes
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return true if the content is mapped instead of copied
+    bool isMapped() const noexcept {
+        return mapped;
+    }
+
+private:
+    // Unmap the file or free the buffer
+    void release() noexcept {
+#ifdef TASTYLIB_HAS_MMAP
+        if (mapped) {
+            ::munmap((void*)data, size);
+        }
+#endif
+        buffer.reset();
+        data = nullptr;
+        size = 0;
+        mapped = false;
+    }
+
+private:
+    const char *data;
+    SizeType size;
+    bool mapped;
+    std::unique_ptr<char[]> buffer;
+};
+
+TASTYLIB_NS_END
+
+#endif
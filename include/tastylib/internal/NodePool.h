@@ -0,0 +1,170 @@
+#ifndef TASTYLIB_INTERNAL_NODEPOOL_H_
+#define TASTYLIB_INTERNAL_NODEPOOL_H_
+
+#include "tastylib/internal/base.h"
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+A pool of memory slots for nodes of one type. The slots are carved out of
+blocks that double in size, and freed slots are kept in a free list, so
+allocating and freeing a node never calls the global operator new after
+the pool has grown large enough. Two pools can be merged in O(1) time,
+after which the merged pool owns the nodes of both.
+
+The pool hands out raw memory. Its owner constructs and destroys the nodes,
+and must destroy all of them before the pool is destroyed.
+
+@param T The type of the nodes
+*/
+template<typename T>
+class NodePool {
+private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+public:
+    using SizeType = std::size_t;
+
+    // Default ctor
+    NodePool() noexcept
+    : blocks(nullptr), lastBlock(nullptr), freeHead(nullptr), freeTail(nullptr),
+      blockSize(MIN_BLOCK_SIZE) {}
+
+    // Forbid copy
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Move ctor
+    NodePool(NodePool&& other) noexcept
+    : blocks(other.blocks), lastBlock(other.lastBlock), freeHead(other.freeHead),
+      freeTail(other.freeTail), blockSize(other.blockSize) {
+        other.reset();
+    }
+
+    // Move assignment
+    NodePool& operator=(NodePool&& other) noexcept {
+        if (this != &other) {
+            release();
+            blocks = other.blocks;
+            lastBlock = other.lastBlock;
+            freeHead = other.freeHead;
+            freeTail = other.freeTail;
+            blockSize = other.blockSize;
+            other.reset();
+        }
+        return *this;
+    }
+
+    // Dtor
+    ~NodePool() noexcept {
+        release();
+    }
+
+    // Return the memory of one node
+    T* allocate() {
+        if (!freeHead) {
+            grow();
+        }
+        Slot *s = freeHead;
+        freeHead = s->next;
+        if (!freeHead) {
+            freeTail = nullptr;
+        }
+        return (T*)s->storage;
+    }
+
+    // Give the memory of a node back to the pool
+    void deallocate(T *const p) noexcept {
+        Slot *s = (Slot*)p;
+        s->next = freeHead;
+        if (!freeHead) {
+            freeTail = s;
+        }
+        freeHead = s;
+    }
+
+    /*
+    Take over the blocks and the free slots of another pool. The nodes
+    allocated from the other pool now belong to this one.
+
+    @param other The other pool, which is left empty
+    */
+    void absorb(NodePool& other) noexcept {
+        if (this == &other) {
+            return;
+        }
+        if (other.blocks) {
+            other.lastBlock->next = blocks;
+            if (!blocks) {
+                lastBlock = other.lastBlock;
+            }
+            blocks = other.blocks;
+        }
+        if (other.freeHead) {
+            if (freeTail) {
+                freeTail->next = other.freeHead;
+            } else {
+                freeHead = other.freeHead;
+            }
+            freeTail = other.freeTail;
+        }
+        if (other.blockSize > blockSize) {
+            blockSize = other.blockSize;
+        }
+        other.reset();
+    }
+
+private:
+    static const SizeType MIN_BLOCK_SIZE = 64;
+    static const SizeType MAX_BLOCK_SIZE = 65536;
+
+    // Allocate a new block and put its slots in the free list
+    void grow() {
+        // Slot 0 of a block links the blocks, the others hold nodes
+        Slot *block = new Slot[blockSize + 1];
+        block[0].next = blocks;
+        if (!blocks) {
+            lastBlock = block;
+        }
+        blocks = block;
+        for (SizeType i = 1; i < blockSize; ++i) {
+            block[i].next = &block[i + 1];
+        }
+        block[blockSize].next = nullptr;
+        freeHead = &block[1];
+        freeTail = &block[blockSize];
+        if (blockSize < MAX_BLOCK_SIZE) {
+            blockSize *= 2;
+        }
+    }
+
+    // Free all blocks
+    void release() noexcept {
+        while (blocks) {
+            Slot *next = blocks->next;
+            delete[] blocks;
+            blocks = next;
+        }
+        reset();
+    }
+
+    void reset() noexcept {
+        blocks = lastBlock = freeHead = freeTail = nullptr;
+        blockSize = MIN_BLOCK_SIZE;
+    }
+
+private:
+    Slot *blocks;     // Linked by slot 0 of each block
+    Slot *lastBlock;
+    Slot *freeHead;
+    Slot *freeTail;
+    SizeType blockSize;  // Amount of slots of the next block
+};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,451 @@
+#ifndef TASTYLIB_INTERNAL_SORTINGNETWORK_H_
+#define TASTYLIB_INTERNAL_SORTINGNETWORK_H_
+
+#include "tastylib/internal/base.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// The widest instruction set enabled at compile time, e.g. by -mavx2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TASTYLIB_SIMD_AVX2
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define TASTYLIB_SIMD_SSE4
+#endif
+
+TASTYLIB_NS_BEGIN
+
+/*
+The registers used by the sorting networks for int32 and float keys. Each
+specialization provides:
+
+Reg        The register type
+width()    The amount of keys in a register
+load()     Load a register from an unaligned address
+store()    Store a register to an unaligned address
+cmpx()     Compare and exchange two registers lane by lane, so that the
+           smaller keys end in the first one
+reverse()  Reverse the lanes of a register
+sortReg()  Sort the lanes of a register
+mergeReg() Sort the lanes of a register holding a bitonic sequence
+
+The compare-exchanges keep both keys of each pair even when they compare
+equal, e.g. -0.0f and 0.0f, so the keys sorted are a permutation of the
+input. They use AVX2 or SSE4.1 when the compiler enables them, and plain
+scalar code otherwise.
+*/
+template<typename Value>
+struct SimdVec;
+
+#if defined(TASTYLIB_SIMD_AVX2)
+
+template<>
+struct SimdVec<std::int32_t> {
+    using Reg = __m256i;
+
+    static constexpr std::size_t width() noexcept {
+        return 8;
+    }
+
+    static Reg load(const std::int32_t *const p) noexcept {
+        return _mm256_loadu_si256((const __m256i*)p);
+    }
+
+    static void store(std::int32_t *const p, const Reg x) noexcept {
+        _mm256_storeu_si256((__m256i*)p, x);
+    }
+
+    static void cmpx(Reg& a, Reg& b) noexcept {
+        const Reg lo = _mm256_min_epi32(a, b);
+        b = _mm256_max_epi32(a, b);
+        a = lo;
+    }
+
+    static Reg reverse(const Reg x) noexcept {
+        return _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    // Compare each lane with the lane of 'y' at the same index, and take
+    // the bigger key in the lanes set in 'Mask'
+    template<int Mask>
+    static Reg stage(const Reg x, const Reg y) noexcept {
+        return _mm256_blend_epi32(_mm256_min_epi32(x, y), _mm256_max_epi32(x, y), Mask);
+    }
+
+    static Reg sortReg(Reg x) noexcept {
+        x = stage<0x66>(x, _mm256_shuffle_epi32(x, 0xB1));
+        x = stage<0x3C>(x, _mm256_shuffle_epi32(x, 0x4E));
+        x = stage<0x5A>(x, _mm256_shuffle_epi32(x, 0xB1));
+        return mergeReg(x);
+    }
+
+    static Reg mergeReg(Reg x) noexcept {
+        x = stage<0xF0>(x, _mm256_permute2x128_si256(x, x, 1));
+        x = stage<0xCC>(x, _mm256_shuffle_epi32(x, 0x4E));
+        return stage<0xAA>(x, _mm256_shuffle_epi32(x, 0xB1));
+    }
+};
+
+template<>
+struct SimdVec<float> {
+    using Reg = __m256;
+
+    static constexpr std::size_t width() noexcept {
+        return 8;
+    }
+
+    static Reg load(const float *const p) noexcept {
+        return _mm256_loadu_ps(p);
+    }
+
+    static void store(float *const p, const Reg x) noexcept {
+        _mm256_storeu_ps(p, x);
+    }
+
+    // _mm256_min_ps() and _mm256_max_ps() return their second operand
+    // when the keys are unordered, so the order of the operands matters
+    static void cmpx(Reg& a, Reg& b) noexcept {
+        const Reg lo = _mm256_min_ps(a, b);
+        b = _mm256_max_ps(b, a);
+        a = lo;
+    }
+
+    static Reg reverse(const Reg x) noexcept {
+        return _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    template<int Mask>
+    static Reg stage(const Reg x, const Reg y) noexcept {
+        return _mm256_blend_ps(_mm256_min_ps(x, y), _mm256_max_ps(x, y), Mask);
+    }
+
+    static Reg sortReg(Reg x) noexcept {
+        x = stage<0x66>(x, _mm256_shuffle_ps(x, x, 0xB1));
+        x = stage<0x3C>(x, _mm256_shuffle_ps(x, x, 0x4E));
+        x = stage<0x5A>(x, _mm256_shuffle_ps(x, x, 0xB1));
+        return mergeReg(x);
+    }
+
+    static Reg mergeReg(Reg x) noexcept {
+        x = stage<0xF0>(x, _mm256_permute2f128_ps(x, x, 1));
+        x = stage<0xCC>(x, _mm256_shuffle_ps(x, x, 0x4E));
+        return stage<0xAA>(x, _mm256_shuffle_ps(x, x, 0xB1));
+    }
+};
+
+#elif defined(TASTYLIB_SIMD_SSE4)
+
+template<>
+struct SimdVec<std::int32_t> {
+    using Reg = __m128i;
+
+    static constexpr std::size_t width() noexcept {
+        return 4;
+    }
+
+    static Reg load(const std::int32_t *const p) noexcept {
+        return _mm_loadu_si128((const __m128i*)p);
+    }
+
+    static void store(std::int32_t *const p, const Reg x) noexcept {
+        _mm_storeu_si128((__m128i*)p, x);
+    }
+
+    static void cmpx(Reg& a, Reg& b) noexcept {
+        const Reg lo = _mm_min_epi32(a, b);
+        b = _mm_max_epi32(a, b);
+        a = lo;
+    }
+
+    static Reg reverse(const Reg x) noexcept {
+        return _mm_shuffle_epi32(x, 0x1B);
+    }
+
+    // The mask has two bits per lane, since the blend works on 16-bit words
+    template<int Mask>
+    static Reg stage(const Reg x, const Reg y) noexcept {
+        return _mm_blend_epi16(_mm_min_epi32(x, y), _mm_max_epi32(x, y), Mask);
+    }
+
+    static Reg sortReg(Reg x) noexcept {
+        x = stage<0x3C>(x, _mm_shuffle_epi32(x, 0xB1));
+        return mergeReg(x);
+    }
+
+    static Reg mergeReg(Reg x) noexcept {
+        x = stage<0xF0>(x, _mm_shuffle_epi32(x, 0x4E));
+        return stage<0xCC>(x, _mm_shuffle_epi32(x, 0xB1));
+    }
+};
+
+template<>
+struct SimdVec<float> {
+    using Reg = __m128;
+
+    static constexpr std::size_t width() noexcept {
+        return 4;
+    }
+
+    static Reg load(const float *const p) noexcept {
+        return _mm_loadu_ps(p);
+    }
+
+    static void store(float *const p, const Reg x) noexcept {
+        _mm_storeu_ps(p, x);
+    }
+
+    // _mm_min_ps() and _mm_max_ps() return their second operand when the
+    // keys are unordered, so the order of the operands matters
+    static void cmpx(Reg& a, Reg& b) noexcept {
+        const Reg lo = _mm_min_ps(a, b);
+        b = _mm_max_ps(b, a);
+        a = lo;
+    }
+
+    static Reg reverse(const Reg x) noexcept {
+        return _mm_shuffle_ps(x, x, 0x1B);
+    }
+
+    template<int Mask>
+    static Reg stage(const Reg x, const Reg y) noexcept {
+        return _mm_blend_ps(_mm_min_ps(x, y), _mm_max_ps(x, y), Mask);
+    }
+
+    static Reg sortReg(Reg x) noexcept {
+        x = stage<0x6>(x, _mm_shuffle_ps(x, x, 0xB1));
+        return mergeReg(x);
+    }
+
+    static Reg mergeReg(Reg x) noexcept {
+        x = stage<0xC>(x, _mm_shuffle_ps(x, x, 0x4E));
+        return stage<0xA>(x, _mm_shuffle_ps(x, x, 0xB1));
+    }
+};
+
+#else
+
+// The scalar fallback, whose registers hold one key
+template<typename Value>
+struct ScalarVec {
+    using Reg = Value;
+
+    static constexpr std::size_t width() noexcept {
+        return 1;
+    }
+
+    static Reg load(const Value *const p) noexcept {
+        return *p;
+    }
+
+    static void store(Value *const p, const Reg x) noexcept {
+        *p = x;
+    }
+
+    // Written with conditional moves in mind, without a branch
+    static void cmpx(Reg& a, Reg& b) noexcept {
+        const bool swap = b < a;
+        const Reg lo = swap ? b : a;
+        b = swap ? a : b;
+        a = lo;
+    }
+
+    static Reg reverse(const Reg x) noexcept {
+        return x;
+    }
+
+    static Reg sortReg(const Reg x) noexcept {
+        return x;
+    }
+
+    static Reg mergeReg(const Reg x) noexcept {
+        return x;
+    }
+};
+
+template<>
+struct SimdVec<std::int32_t> : ScalarVec<std::int32_t> {};
+
+template<>
+struct SimdVec<float> : ScalarVec<float> {};
+
+#endif
+
+/*
+Sort the keys in some registers that form a bitonic sequence, i.e. they
+increase and then decrease.
+
+@param r The registers
+@param m The amount of registers. It must be a power of 2.
+*/
+template<typename Value>
+void networkMergeRegs(typename SimdVec<Value>::Reg *const r, const std::size_t m) {
+    using V = SimdVec<Value>;
+    for (std::size_t h = m / 2; h > 0; h /= 2) {
+        for (std::size_t i = 0; i < m; ++i) {
+            if ((i & h) == 0) {
+                V::cmpx(r[i], r[i + h]);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+        r[i] = V::mergeReg(r[i]);
+    }
+}
+
+/*
+Sort the keys in some registers with a bitonic network. The registers are
+read in order, and the lanes of each register from the lowest.
+
+@param r The registers
+@param m The amount of registers. It must be a power of 2.
+*/
+template<typename Value>
+void networkSortRegs(typename SimdVec<Value>::Reg *const r, const std::size_t m) {
+    using V = SimdVec<Value>;
+    if (m == 1) {
+        r[0] = V::sortReg(r[0]);
+        return;
+    }
+    const std::size_t half = m / 2;
+    networkSortRegs<Value>(r, half);
+    networkSortRegs<Value>(r + half, half);
+    // Reverse the second half, so that the keys form a bitonic sequence
+    std::reverse(r + half, r + m);
+    for (std::size_t i = half; i < m; ++i) {
+        r[i] = V::reverse(r[i]);
+    }
+    networkMergeRegs<Value>(r, m);
+}
+
+/*
+Sort at most 32 int32 or float keys in ascending order with a sorting
+network of 8, 16 or 32 keys. The missing keys are filled with the biggest
+value of the type.
+
+@param arr The array to be sorted
+@param n   The amount of keys in the array. At most 32.
+*/
+template<typename Value>
+void networkSort(Value *const arr, const std::size_t n) {
+    using V = SimdVec<Value>;
+    const std::size_t MAX_SIZE = 32;
+    std::size_t size = 8;
+    while (size < n) {
+        size *= 2;
+    }
+    const std::size_t m = std::max<std::size_t>(1, size / V::width());
+    typename V::Reg r[MAX_SIZE];
+    if (n == size) {
+        for (std::size_t i = 0; i < m; ++i) {
+            r[i] = V::load(arr + i * V::width());
+        }
+        networkSortRegs<Value>(r, m);
+        for (std::size_t i = 0; i < m; ++i) {
+            V::store(arr + i * V::width(), r[i]);
+        }
+        return;
+    }
+    Value buf[MAX_SIZE];
+    std::copy(arr, arr + n, buf);
+    std::fill(buf + n, buf + size, std::numeric_limits<Value>::has_infinity ?
+        std::numeric_limits<Value>::infinity() : std::numeric_limits<Value>::max());
+    for (std::size_t i = 0; i < m; ++i) {
+        r[i] = V::load(buf + i * V::width());
+    }
+    networkSortRegs<Value>(r, m);
+    for (std::size_t i = 0; i < m; ++i) {
+        V::store(buf + i * V::width(), r[i]);
+    }
+    std::copy(buf, buf + n, arr);
+}
+
+/*
+Merge two sorted runs of int32 or float keys. A register of each run goes
+through the bitonic merge network; the lower half is written out, and the
+upper half is merged with the next register of the run whose next key is
+smaller. The keys left once a run has less than a register are merged one
+by one.
+
+@param a   The first run
+@param na  The amount of keys in the first run
+@param b   The second run
+@param nb  The amount of keys in the second run
+@param out The output, of na + nb keys. It must not overlap the runs.
+*/
+template<typename Value>
+void networkMerge(const Value *const a, const std::size_t na,
+                  const Value *const b, const std::size_t nb,
+                  Value *out) {
+    using V = SimdVec<Value>;
+    const std::size_t W = V::width();
+    if (na < W || nb < W) {
+        std::merge(a, a + na, b, b + nb, out);
+        return;
+    }
+    typename V::Reg x = V::load(a), y = V::load(b);
+    std::size_t ia = W, ib = W;
+    while (true) {
+        y = V::reverse(y);
+        V::cmpx(x, y);
+        x = V::mergeReg(x);
+        y = V::mergeReg(y);
+        V::store(out, x);
+        out += W;
+        if (ia + W > na || ib + W > nb) {
+            break;
+        }
+        if (b[ib] < a[ia]) {
+            x = V::load(b + ib);
+            ib += W;
+        } else {
+            x = V::load(a + ia);
+            ia += W;
+        }
+    }
+    // The keys in 'y' are not smaller than the ones written out. Merge
+    // them with the run that has less than a register left, then with
+    // the other run.
+    Value tail[V::width()];
+    V::store(tail, y);
+    const Value *small = a + ia, *smallEnd = a + na, *big = b + ib, *bigEnd = b + nb;
+    if (na - ia >= W) {
+        std::swap(small, big);
+        std::swap(smallEnd, bigEnd);
+    }
+    Value tmp[2 * V::width()];
+    Value *tmpEnd = std::merge(tail, tail + W, small, smallEnd, tmp);
+    std::merge(tmp, tmpEnd, big, bigEnd, out);
+}
+
+/*
+Whether quickSort() finishes small arrays with networkSort(). The scalar
+networks make more comparisons than insertion sort, so they are only used
+with SIMD registers.
+*/
+template<typename Value, typename PredCmp>
+struct NetworkSortable : std::false_type {};
+
+#if defined(TASTYLIB_SIMD_AVX2) || defined(TASTYLIB_SIMD_SSE4)
+
+template<>
+struct NetworkSortable<std::int32_t, std::less<std::int32_t>> : std::true_type {};
+
+template<>
+struct NetworkSortable<std::int32_t, std::greater<std::int32_t>> : std::true_type {};
+
+template<>
+struct NetworkSortable<float, std::less<float>> : std::true_type {};
+
+template<>
+struct NetworkSortable<float, std::greater<float>> : std::true_type {};
+
+#endif
+
+TASTYLIB_NS_END
+
+#endif
@@ -9,4 +9,14 @@
 // Suppress unused variables warning
 #define UNUSED(expr) (void)(expr)
 
+// Hint the processor to fetch the cache line of an address
+#if defined(__GNUC__) || defined(__clang__)
+#define TASTYLIB_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define TASTYLIB_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define TASTYLIB_PREFETCH(addr) UNUSED(addr)
+#endif
+
 #endif
@@ -0,0 +1,46 @@
+#ifndef TASTYLIB_INTERNAL_HASH_H_
+#define TASTYLIB_INTERNAL_HASH_H_
+
+#include "tastylib/internal/base.h"
+#include <cstdint>
+#include <type_traits>
+
+TASTYLIB_NS_BEGIN
+
+/*
+Scramble the bits of a hash value. Many hash functors (e.g. std::hash<int>)
+are the identity function, which leaves the high bits empty and makes power
+of two tables cluster badly. The finalizer of MurmurHash3 spreads every input
+bit over the whole output word.
+
+@param h The hash value computed by a user-provided functor
+@return  The scrambled hash value
+*/
+inline std::uint64_t mixHash(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template<typename T>
+struct MakeVoid {
+    using type = void;
+};
+
+/*
+Check if a hash function or comparator supports heterogeneous
+lookup, i.e. it defines the member type 'is_transparent'.
+*/
+template<typename T, typename = void>
+struct IsTransparent : std::false_type {};
+
+template<typename T>
+struct IsTransparent<T, typename MakeVoid<typename T::is_transparent>::type>
+    : std::true_type {};
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef TASTYLIB_INTERNAL_MERGE_H_
+#define TASTYLIB_INTERNAL_MERGE_H_
+
+#include "tastylib/internal/base.h"
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+Return the amount of leading elements of a sorted run that are not bigger
+than a key. The elements at 0, 2, 6, 14, ... are probed until one is bigger,
+then the range left is binary searched, so it costs O(logk) comparisons
+for an answer k.
+
+@param first The beginning of the run
+@param n     The amount of elements in the run
+@param key   The key
+@param cmp   The comparator
+*/
+template<typename Iter, typename Value, typename PredCmp>
+std::size_t gallopUpper(const Iter first, const std::size_t n, const Value& key, const PredCmp& cmp) {
+    std::size_t lo = 0, probe = 0, step = 1;
+    Iter loIt = first, it = first;
+    while (probe < n && !cmp(key, *it)) {
+        lo = probe + 1;
+        loIt = std::next(it);
+        step *= 2;
+        const std::size_t next = std::min(n, probe + step);
+        std::advance(it, next - probe);
+        probe = next;
+    }
+    const std::size_t hi = std::min(probe, n);
+    return lo + (std::size_t)std::distance(loIt, std::upper_bound(loIt, std::next(loIt, hi - lo), key, cmp));
+}
+
+/*
+Return the amount of leading elements of a sorted run that are smaller
+than a key, with the same search as gallopUpper().
+
+@param first The beginning of the run
+@param n     The amount of elements in the run
+@param key   The key
+@param cmp   The comparator
+*/
+template<typename Iter, typename Value, typename PredCmp>
+std::size_t gallopLower(const Iter first, const std::size_t n, const Value& key, const PredCmp& cmp) {
+    std::size_t lo = 0, probe = 0, step = 1;
+    Iter loIt = first, it = first;
+    while (probe < n && cmp(*it, key)) {
+        lo = probe + 1;
+        loIt = std::next(it);
+        step *= 2;
+        const std::size_t next = std::min(n, probe + step);
+        std::advance(it, next - probe);
+        probe = next;
+    }
+    const std::size_t hi = std::min(probe, n);
+    return lo + (std::size_t)std::distance(loIt, std::lower_bound(loIt, std::next(loIt, hi - lo), key, cmp));
+}
+
+/*
+Merge two sorted runs stably. It is the merge kernel of timSort() and of
+DoublyLinkedList::sort(). The runs are merged one element at a time until
+one of them wins 'minGallop' times in a row; then it gallops, i.e. it
+finds with gallopUpper() and gallopLower() how many elements of each run
+go next and emits them at once, until both counts drop below 7. Galloping
+lowers 'minGallop' and leaving it raises it, so that runs with few
+interleavings are merged in O(logn) comparisons. Runs that are not random
+access are merged one element at a time.
+
+@param a         The beginning of the first run
+@param na        The amount of elements in the first run
+@param b         The beginning of the second run
+@param nb        The amount of elements in the second run
+@param emit      Called as emit(first, count) to append 'count' elements
+                 of a run to the output. The iterators are advanced past
+                 the elements before they are emitted, so it may relink
+                 or overwrite them.
+@param cmp       The comparator. For equal elements, the ones of the
+                 first run are emitted first.
+@param minGallop The amount of wins in a row that starts galloping. It is
+                 adjusted by the merge and can be kept for the next one.
+*/
+template<typename Iter, typename Emit, typename PredCmp>
+void gallopMerge(Iter a, std::size_t na,
+                 Iter b, std::size_t nb,
+                 Emit& emit,
+                 const PredCmp& cmp,
+                 std::size_t& minGallop) {
+    const std::size_t GALLOP = 7;
+    // Galloping over a list walks the nodes it skips anyway
+    const bool RANDOM_ACCESS = std::is_base_of<std::random_access_iterator_tag,
+        typename std::iterator_traits<Iter>::iterator_category>::value;
+    std::size_t winsA = 0, winsB = 0;
+    while (na > 0 && nb > 0) {
+        if (cmp(*b, *a)) {
+            const Iter cur = b++;
+            --nb;
+            emit(cur, 1);
+            ++winsB;
+            winsA = 0;
+        } else {
+            const Iter cur = a++;
+            --na;
+            emit(cur, 1);
+            ++winsA;
+            winsB = 0;
+        }
+        if (!RANDOM_ACCESS || (winsA < minGallop && winsB < minGallop)) {
+            continue;
+        }
+        while (na > 0 && nb > 0) {
+            const std::size_t countA = gallopUpper(a, na, *b, cmp);
+            if (countA > 0) {
+                const Iter cur = a;
+                std::advance(a, countA);
+                na -= countA;
+                emit(cur, countA);
+                if (na == 0) {
+                    break;
+                }
+            }
+            const std::size_t countB = gallopLower(b, nb, *a, cmp);
+            if (countB > 0) {
+                const Iter cur = b;
+                std::advance(b, countB);
+                nb -= countB;
+                emit(cur, countB);
+            }
+            if (countA < GALLOP && countB < GALLOP) {
+                ++minGallop;
+                break;
+            }
+            if (minGallop > 1) {
+                --minGallop;
+            }
+        }
+        winsA = winsB = 0;
+    }
+    if (na > 0) {
+        emit(a, na);
+    }
+    if (nb > 0) {
+        emit(b, nb);
+    }
+}
+
+TASTYLIB_NS_END
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef TASTYLIB_INTERNAL_PARALLEL_H_
+#define TASTYLIB_INTERNAL_PARALLEL_H_
+
+#include "tastylib/internal/base.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+TASTYLIB_NS_BEGIN
+
+/*
+Run a function on several threads and wait for all of them. The calling
+thread runs the last one.
+
+@param threads The amount of threads. At least 1.
+@param f       The function to run. Its param is the index of the thread,
+               from 0 to threads - 1.
+*/
+template<typename Func>
+void parallelFor(const std::size_t threads, const Func& f) {
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t + 1 < threads; ++t) {
+        pool.push_back(std::thread([&f, t]() {
+            f(t);
+        }));
+    }
+    try {
+        f(threads - 1);
+    } catch (...) {
+        for (auto &th : pool) {
+            th.join();
+        }
+        throw;
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+}
+
+/*
+Run tasks on several threads with work stealing. Each thread keeps its own
+deque of tasks, and a running task may spawn new tasks to it. A thread
+takes the newest task of its own deque, which is still in its cache. When
+its deque is empty, it steals the oldest task of another thread, which is
+usually the largest one left.
+
+The functions that run the tasks must not throw.
+
+@param Task The type of the tasks. It must be default constructible.
+*/
+template<typename Task>
+class WorkStealingPool {
+public:
+    using SizeType = std::size_t;
+
+    // Initialize the pool with a given amount of threads
+    explicit WorkStealingPool(const SizeType threads)
+    : workerNum(threads > 0 ? threads : 1), workers(new Worker[workerNum]), pending(0) {}
+
+    // Forbid copy
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /*
+    Add a task to the deque of a thread.
+
+    @param worker The index of the calling thread
+    @param task   The task
+    */
+    void spawn(const SizeType worker, Task task) {
+        pending.fetch_add(1);
+        std::lock_guard<std::mutex> guard(workers[worker].lock);
+        workers[worker].tasks.push_back(std::move(task));
+    }
+
+    /*
+    Run a task and all tasks spawned from it, and return when all of
+    them are finished.
+
+    @param root The first task
+    @param f    The function to run a task. Its params are the pool, the
+                index of the calling thread and the task.
+    */
+    template<typename Func>
+    void run(Task root, const Func& f) {
+        spawn(0, std::move(root));
+        parallelFor(workerNum, [this, &f](const SizeType w) {
+            Task task;
+            // A task is only counted as done after the tasks it spawns
+            // are counted, so 'pending' never drops to 0 too early
+            while (pending.load() > 0) {
+                if (take(w, task)) {
+                    f(*this, w, task);
+                    pending.fetch_sub(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+private:
+    // Take the newest task of a thread, or steal the oldest task of another
+    bool take(const SizeType w, Task& task) {
+        for (SizeType i = 0; i < workerNum; ++i) {
+            Worker &v = workers[(w + i) % workerNum];
+            std::lock_guard<std::mutex> guard(v.lock);
+            if (!v.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(v.tasks.back());
+                    v.tasks.pop_back();
+                } else {
+                    task = std::move(v.tasks.front());
+                    v.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        char pad[64];  // Keep the locks of adjacent threads on different cache lines
+    };
+
+    SizeType workerNum;
+    std::unique_ptr<Worker[]> workers;
+    std::atomic<SizeType> pending;  // Amount of tasks spawned and not finished
+};
+
+TASTYLIB_NS_END
+
+#endif
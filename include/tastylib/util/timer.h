@@ -3,6 +3,7 @@
 
 #include "tastylib/internal/base.h"
 #include <ctime>
+#include <chrono>
 #include <functional>
 
 TASTYLIB_NS_BEGIN
@@ -19,6 +20,23 @@ inline double timing(const std::function<void()>& f) {
     return elapse(start);
 }
 
+// Return elapsed milliseconds of wall-clock time from a starting time point
+inline double elapse(const std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+Run a function and compute its execution time in wall-clock time. Unlike
+timing(), the result does not add up the processor time of every thread,
+so it is suitable for multithreaded code and very short operations.
+*/
+inline double wallTiming(const std::function<void()>& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return elapse(start);
+}
+
 TASTYLIB_NS_END
 
 #endif
@@ -2,14 +2,107 @@
 #include "tastylib/util/timer.h"
 #include "tastylib/util/random.h"
 #include "tastylib/BinaryHeap.h"
+#include "tastylib/DaryHeap.h"
 #include <algorithm>
 #include <queue>
+#include <string>
+#include <cstddef>
 
 using tastylib::printLn;
 using tastylib::timing;
+using tastylib::wallTiming;
 using tastylib::Random;
 using tastylib::BinaryHeap;
+using tastylib::DaryHeap;
 
+// A 64-byte element, i.e. one cache line
+struct Payload {
+    int key;
+    char data[60];
+
+    bool operator<(const Payload& other) const noexcept {
+        return key < other.key;
+    }
+};
+
+// An allocator that counts the blocks it allocates
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    static std::size_t count;
+
+    CountingAllocator() noexcept {}
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(const std::size_t n) {
+        ++count;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *const p, const std::size_t n) noexcept {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+template<typename T>
+std::size_t CountingAllocator<T>::count = 0;
+
+// A string whose allocations are counted
+using CountedString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+
+/*
+Push strings to an empty heap and pop all of them. Print the time cost and
+the amount of string allocations per element.
+
+@param name     The name of the heap
+@param strs     The strings to push
+@param pushPop  A function that pushes and pops all strings of an array
+*/
+template<typename Func>
+void countStrings(const char *const name, const std::vector<CountedString>& strs, const Func& pushPop) {
+    std::vector<CountedString> test = strs;
+    CountingAllocator<char>::count = 0;
+    auto time = timing([&]() {
+        pushPop(test);
+    });
+    printLn(name, ": ", (double)CountingAllocator<char>::count / strs.size(),
+            " allocations, ", time / strs.size(), " ms per element");
+}
+
+/*
+Push values to an empty heap and pop all of them.
+
+@param name The name of the heap
+@param vals The values to push
+*/
+template<typename Heap, typename Value>
+void pushPop(const char *const name, const std::vector<Value>& vals) {
+    Heap heap;
+    auto pushTime = timing([&]() {
+        for (const auto &v : vals) {
+            heap.push(v);
+        }
+    });
+    auto popTime = timing([&]() {
+        while (!heap.isEmpty()) {
+            heap.pop();
+        }
+    });
+    printLn(name, ": push() ", pushTime / vals.size(), " ms, pop() ", popTime / vals.size(), " ms");
+}
 
 int main() {
     printLn("Benchmark of BinaryHeap running...\n");
@@ -82,6 +175,134 @@ int main() {
             printLn("Time of std VS TastyLib: ", stdTime, " ms / ", libTime, " ms");
             printLn("Benchmark of makeHeap() finished.\n");
         }
+
+        {   // Benchmark makeHeap() on several threads
+            printLn("Benchmarking parallel makeHeap()...");
+            printLn("Building a ", SIZE, " elements heap on 1, 2, 4 and 8 threads...");
+            for (std::size_t threads = 1; threads <= 8; threads <<= 1) {
+                std::vector<int> test = vals;
+                auto libTime = wallTiming([&]() {
+                    BinaryHeap<int, std::less_equal<int>> libHeap(std::move(test), std::less_equal<int>(), threads);
+                });
+                printLn(threads, " thread(s): ", libTime, " ms");
+            }
+            printLn("Benchmark of parallel makeHeap() finished.\n");
+        }
+
+        {   // Benchmark pushBatch()
+            const int BATCH = 100000;
+            printLn("Benchmarking pushBatch()...");
+            printLn("Pushing ", SIZE, " elements in batches of ", BATCH, "...");
+            // Random elements, then ascending ones, each of which push() percolates to the root
+            std::vector<int> sorted = vals;
+            std::sort(sorted.begin(), sorted.end());
+            for (const auto input : {&vals, &sorted}) {
+                auto pushTime = timing([&]() {
+                    BinaryHeap<int, std::less_equal<int>> libHeap;
+                    for (int i = 0; i < SIZE; ++i) {
+                        libHeap.push((*input)[i]);
+                    }
+                });
+                auto batchTime = timing([&]() {
+                    BinaryHeap<int, std::less_equal<int>> libHeap;
+                    std::vector<int> batch;
+                    for (int i = 0; i < SIZE; i += BATCH) {
+                        batch.assign(input->begin() + i, input->begin() + std::min(i + BATCH, SIZE));
+                        libHeap.pushBatch(std::move(batch));
+                    }
+                });
+                printLn(input == &vals ? "Random" : "Ascending", " input, time of push() VS pushBatch(): ",
+                        pushTime, " ms / ", batchTime, " ms");
+            }
+            printLn("Benchmark of pushBatch() finished.\n");
+        }
+    }
+    {
+        const int INT_SIZE = 10000000;
+        const int PAYLOAD_SIZE = 2000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", INT_SIZE, " integers and ", PAYLOAD_SIZE, " 64-byte payloads...");
+        std::vector<int> ints;
+        for (int i = 0; i < INT_SIZE; ++i) {
+            ints.push_back(random->nextInt(0, INT_SIZE));
+        }
+        std::vector<Payload> payloads(PAYLOAD_SIZE);
+        for (auto &p : payloads) {
+            p.key = random->nextInt(0, PAYLOAD_SIZE);
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking DaryHeap with integers...");
+        pushPop<BinaryHeap<int>>("BinaryHeap", ints);
+        pushPop<DaryHeap<int, std::less<int>, 2>>("DaryHeap D = 2", ints);
+        pushPop<DaryHeap<int, std::less<int>, 4>>("DaryHeap D = 4", ints);
+        pushPop<DaryHeap<int, std::less<int>, 8>>("DaryHeap D = 8", ints);
+        printLn("Benchmark of DaryHeap with integers finished.\n");
+
+        printLn("Benchmarking DaryHeap with 64-byte payloads...");
+        pushPop<BinaryHeap<Payload>>("BinaryHeap", payloads);
+        pushPop<DaryHeap<Payload, std::less<Payload>, 2>>("DaryHeap D = 2", payloads);
+        pushPop<DaryHeap<Payload, std::less<Payload>, 4>>("DaryHeap D = 4", payloads);
+        pushPop<DaryHeap<Payload, std::less<Payload>, 8>>("DaryHeap D = 8", payloads);
+        printLn("Benchmark of DaryHeap with 64-byte payloads finished.\n");
+    }
+    {
+        const int SIZE = 1000000;
+
+        Random *random = Random::getInstance();
+
+        // The strings are long enough to be allocated on the heap
+        printLn("Generating ", SIZE, " strings of 32 characters...");
+        std::vector<CountedString> strs;
+        for (int i = 0; i < SIZE; ++i) {
+            CountedString str(32, 'a');
+            for (auto &c : str) {
+                c = (char)random->nextInt('a', 'z');
+            }
+            strs.push_back(str);
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking BinaryHeap with strings...");
+        countStrings("std::priority_queue", strs, [](std::vector<CountedString>& vals) {
+            std::priority_queue<CountedString> heap;
+            for (const auto &v : vals) {
+                heap.push(v);
+            }
+            for (auto &v : vals) {
+                v = heap.top();
+                heap.pop();
+            }
+        });
+        countStrings("BinaryHeap (copy)", strs, [](std::vector<CountedString>& vals) {
+            BinaryHeap<CountedString> heap;
+            for (const auto &v : vals) {
+                heap.push(v);
+            }
+            for (auto &v : vals) {
+                v = heap.top();
+                heap.pop();
+            }
+        });
+        countStrings("BinaryHeap (move)", strs, [](std::vector<CountedString>& vals) {
+            BinaryHeap<CountedString> heap;
+            for (auto &v : vals) {
+                heap.push(std::move(v));
+            }
+            for (auto &v : vals) {
+                v = heap.popValue();
+            }
+        });
+        countStrings("BinaryHeap (Container&&)", strs, [](std::vector<CountedString>& vals) {
+            BinaryHeap<CountedString> heap(std::move(vals));
+            vals.resize(heap.getSize());
+            for (auto &v : vals) {
+                v = heap.popValue();
+            }
+        });
+        printLn("Benchmark of BinaryHeap with strings finished.\n");
     }
     printLn("Benchmark of BinaryHeap finished.");
     checkMemoryLeaks();
@@ -0,0 +1,134 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/BloomFilter.h"
+#include "tastylib/HashTable.h"
+#include "tastylib/AVLTree.h"
+#include <vector>
+
+using tastylib::printLn;
+using tastylib::timing;
+using tastylib::Random;
+using tastylib::BloomFilter;
+using tastylib::BloomFilteredTable;
+using tastylib::HashTable;
+using tastylib::AVLTree;
+
+/*
+Look up a mix of present and absent values.
+
+@param table   The table to benchmark
+@param queries The values to find
+@return        The amount of values found
+*/
+template<typename Table>
+int lookup(const Table& table, const std::vector<int>& queries) {
+    int found = 0;
+    for (const auto &q : queries) {
+        found += table.has(q);
+    }
+    return found;
+}
+
+/*
+Compare a table with and without a Bloom filter in front of it.
+
+@param name    The name of the table
+@param vals    The values in the table
+@param queries The queries of each workload
+@param missPct The percentage of absent values in each workload
+*/
+template<typename Table>
+void compare(const char *const name, const std::vector<int>& vals,
+             const std::vector<std::vector<int>>& queries, const std::vector<int>& missPct) {
+    printLn("Benchmarking ", name, "...");
+    Table plain;
+    BloomFilteredTable<Table, int> filtered(vals.size());
+    for (const auto &v : vals) {
+        plain.insert(v);
+        filtered.insert(v);
+    }
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        int plainFound = 0, filteredFound = 0;
+        double plainTime = timing([&]() {
+            plainFound = lookup(plain, queries[i]);
+        });
+        filtered.resetCounters();
+        double filteredTime = timing([&]() {
+            filteredFound = lookup(filtered, queries[i]);
+        });
+        printLn(missPct[i], "% misses: ", plainTime / queries[i].size(), " ms / ",
+                filteredTime / queries[i].size(), " ms (false positive rate: ",
+                filtered.getFalsePositiveRate() * 100, "%, correctness check: ",
+                plainFound == filteredFound ? "pass" : "fail", ")");
+    }
+    printLn("Benchmark of ", name, " finished.\n");
+}
+
+// Return true if a number is never inserted
+bool isAbsent(const int v) {
+    return (((unsigned)v * 2654435761U) >> 31) != 0;
+}
+
+int main() {
+    printLn("Benchmark of BloomFilter running...\n");
+    {
+        const int SIZE = 2000000;
+        const int QUERIES = 2000000;
+
+        Random *random = Random::getInstance();
+
+        // A pseudo-random bit of each number decides if it can be a present
+        // value, so the absent values are spread among the present ones
+        printLn("Generating ", SIZE, " elements to benchmark...");
+        std::vector<int> vals;
+        while ((int)vals.size() < SIZE) {
+            const int v = random->nextInt(0, 0x7fffffff);
+            if (!isAbsent(v)) {
+                vals.push_back(v);
+            }
+        }
+        std::vector<int> missPct = {0, 50, 90, 100};
+        std::vector<std::vector<int>> queries;
+        for (const auto pct : missPct) {
+            std::vector<int> q;
+            for (int i = 0; i < QUERIES; ++i) {
+                if (random->nextInt(0, 99) < pct) {
+                    int v = 0;
+                    do {
+                        v = random->nextInt(0, 0x7fffffff);
+                    } while (!isAbsent(v));
+                    q.push_back(v);
+                } else {
+                    q.push_back(vals[random->nextInt(0, SIZE - 1)]);
+                }
+            }
+            queries.push_back(q);
+        }
+        printLn("Finished.\n");
+
+        printLn("Avg time of has() without VS with a Bloom filter (10 bits per key):\n");
+        compare<HashTable<int>>("HashTable", vals, queries, missPct);
+        compare<AVLTree<int>>("AVLTree", vals, queries, missPct);
+
+        printLn("Benchmarking the false positive rate of BloomFilter...");
+        for (const std::size_t bits : {4, 8, 10, 16}) {
+            BloomFilter<int> filter(SIZE, bits);
+            for (const auto &v : vals) {
+                filter.insert(v);
+            }
+            int falsePositives = 0;
+            double cost = timing([&]() {
+                for (const auto &q : queries.back()) {
+                    falsePositives += filter.mayHave(q);
+                }
+            });
+            printLn(bits, " bits per key: ", (double)falsePositives / QUERIES * 100,
+                    "% false positives, ", cost / QUERIES, " ms per query");
+        }
+        printLn("Finished.\n");
+    }
+    printLn("Benchmark of BloomFilter finished.");
+    checkMemoryLeaks();
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/HashTable.h"
+#include "tastylib/ConcurrentHashTable.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+
+using tastylib::printLn;
+using tastylib::wallTiming;
+using tastylib::Random;
+using tastylib::HashTable;
+using tastylib::ConcurrentHashTable;
+
+/*
+A HashTable shared by wrapping every operation in one global mutex.
+*/
+class GlobalLockTable {
+public:
+    explicit GlobalLockTable(const std::size_t n) : table(n) {}
+
+    bool has(const int v) const {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.has(v);
+    }
+
+    void insert(const int v) {
+        std::lock_guard<std::mutex> guard(lock);
+        table.insert(v);
+    }
+
+    void remove(const int v) {
+        std::lock_guard<std::mutex> guard(lock);
+        table.remove(v);
+    }
+
+private:
+    mutable std::mutex lock;
+    HashTable<int> table;
+};
+
+/*
+Run operations on a table from several threads.
+
+@param table    The table to benchmark
+@param threads  The amount of threads
+@param keys     The keys used by the operations. Thread i starts at keys[i * step].
+@param ops      The amount of operations per thread
+@param writePct Percentage of operations that modify the table
+@return         Million operations per second
+*/
+template<typename Table>
+double run(Table& table, const int threads, const std::vector<int>& keys,
+           const int ops, const int writePct) {
+    double ms = wallTiming([&]() {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.push_back(std::thread([&, t]() {
+                const std::size_t n = keys.size();
+                std::size_t k = (std::size_t)t * 7919 % n;
+                int found = 0;
+                for (int i = 0; i < ops; ++i, k = (k + 1 == n ? 0 : k + 1)) {
+                    if (i % 100 < writePct) {
+                        // Insert or remove keys that are absent in the prefilled table
+                        if (i & 1) {
+                            table.insert(keys[k] | 1);
+                        } else {
+                            table.remove(keys[k] | 1);
+                        }
+                    } else {
+                        found += table.has(keys[k]);
+                    }
+                }
+                UNUSED(found);
+            }));
+        }
+        for (auto &th : pool) {
+            th.join();
+        }
+    });
+    return (double)threads * ops / ms / 1000;
+}
+
+int main() {
+    printLn("Benchmark of ConcurrentHashTable running...\n");
+    {
+        const int SIZE = 1000000;
+        const int OPS = 1000000;
+        const int MAX_THREADS = 64;
+
+        Random *random = Random::getInstance();
+
+        // The tables hold the even numbers in [0, 2 * SIZE)
+        printLn("Generating ", SIZE, " elements to benchmark...");
+        std::vector<int> keys;
+        for (int i = 0; i < SIZE; ++i) {
+            keys.push_back(random->nextInt(0, 2 * SIZE - 1));
+        }
+        GlobalLockTable lockTable(SIZE);
+        ConcurrentHashTable<int> concTable(SIZE);
+        for (int i = 0; i < SIZE; ++i) {
+            lockTable.insert(2 * i);
+            concTable.insert(2 * i);
+        }
+        printLn("Finished.\n");
+
+        for (const int writePct : {0, 10}) {
+            printLn("Benchmarking ", 100 - writePct, "% has() and ", writePct,
+                    "% insert()/remove() with ", OPS, " operations per thread...");
+            printLn("Throughput of global mutex HashTable VS ConcurrentHashTable:");
+            for (int threads = 1; threads <= MAX_THREADS; threads <<= 1) {
+                double lockOps = run(lockTable, threads, keys, OPS, writePct);
+                double concOps = run(concTable, threads, keys, OPS, writePct);
+                printLn(threads, " thread(s): ", lockOps, " Mops/s / ", concOps, " Mops/s");
+            }
+            printLn("Finished.\n");
+        }
+    }
+    printLn("Benchmark of ConcurrentHashTable finished.");
+    checkMemoryLeaks();
+    return 0;
+}
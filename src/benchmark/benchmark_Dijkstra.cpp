@@ -0,0 +1,66 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/Dijkstra.h"
+
+using tastylib::printLn;
+using tastylib::timing;
+using tastylib::Random;
+using tastylib::DijkGraph;
+using tastylib::DijkQueue;
+using tastylib::DIJK_BINARY_HEAP;
+using tastylib::DIJK_RADIX_HEAP;
+using tastylib::dijkstra;
+
+typedef DijkGraph<int> G;
+typedef G::NumType NumType;
+typedef G::WeightType WeightType;
+
+/*
+Run Dijkstra's algorithm with both queues on a random graph.
+
+@param size      The amount of vertices
+@param degree    The amount of random edges from each vertex
+@param maxWeight The maximum weight of the edges
+*/
+void benchmark(const NumType size, const int degree, const WeightType maxWeight) {
+    Random *random = Random::getInstance();
+    printLn("Generating a graph of ", size, " vertices, ", degree,
+            " edges per vertex and weights in [1, ", maxWeight, "]...");
+    G graph(size, G::LIST);
+    for (NumType i = 0; i < size; ++i) {
+        // A path through all vertices keeps them reachable
+        if (i + 1 < size) {
+            graph.setWeight(i, i + 1, random->nextInt(1, maxWeight));
+        }
+        for (int j = 0; j < degree; ++j) {
+            graph.setWeight(i, (NumType)random->nextInt(0, (int)size - 1), random->nextInt(1, maxWeight));
+        }
+    }
+    printLn("Finished.");
+
+    std::vector<WeightType> dists[2];
+    const DijkQueue queues[2] = {DIJK_BINARY_HEAP, DIJK_RADIX_HEAP};
+    double costs[2];
+    for (int q = 0; q < 2; ++q) {
+        costs[q] = timing([&]() {
+            dijkstra(graph, 0, queues[q]);
+        });
+        for (NumType i = 0; i < size; ++i) {
+            dists[q].push_back(graph[i].dist);
+        }
+    }
+    printLn("Time of BinaryHeap VS RadixHeap: ", costs[0], " ms / ", costs[1],
+            " ms (correctness check: ", dists[0] == dists[1] ? "pass" : "fail", ")\n");
+}
+
+int main() {
+    printLn("Benchmark of Dijkstra running...\n");
+    {
+        benchmark(1000000, 4, 100);
+        benchmark(1000000, 4, 1000000);
+    }
+    printLn("Benchmark of Dijkstra finished.");
+    checkMemoryLeaks();
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/ExternalSort.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+using tastylib::printLn;
+using tastylib::wallTiming;
+using tastylib::Random;
+using tastylib::ExternalSortStats;
+using tastylib::externalSort;
+using tastylib::externalRadixSort;
+
+// A 64-byte record sorted by its key
+struct Record {
+    std::uint64_t key;
+    char data[56];
+
+    bool operator<(const Record& other) const noexcept {
+        return key < other.key;
+    }
+};
+
+/*
+Check that a file holds 'n' records sorted by their keys, whose keys add
+up to 'keySum'.
+
+@param path   The path of the file
+@param n      The amount of records
+@param keySum The sum of the keys of the input
+*/
+bool checkSorted(const char *const path, const std::size_t n, const std::uint64_t keySum) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<Record> buffer(1 << 16);
+    std::size_t count = 0;
+    std::uint64_t sum = 0, last = 0;
+    bool sorted = true;
+    while (in.read((char*)buffer.data(), buffer.size() * sizeof(Record)) || in.gcount() > 0) {
+        const std::size_t got = (std::size_t)in.gcount() / sizeof(Record);
+        for (std::size_t i = 0; i < got; ++i) {
+            sorted = sorted && buffer[i].key >= last;
+            last = buffer[i].key;
+            sum += buffer[i].key;
+        }
+        count += got;
+    }
+    return sorted && count == n && sum == keySum;
+}
+
+/*
+Sort the input file and print the throughput and the passes over it.
+
+@param name   The name of the configuration
+@param n      The amount of records
+@param keySum The sum of the keys
+@param sort   The function to sort the file
+*/
+void run(const char *const name, const std::size_t n, const std::uint64_t keySum,
+         const std::function<ExternalSortStats()>& sort) {
+    ExternalSortStats stats;
+    auto time = wallTiming([&]() {
+        stats = sort();
+    });
+    const double mb = (double)n * sizeof(Record) / (1 << 20);
+    printLn(name, ": ", time, " ms, ", mb / time * 1000, " MB/s, ", stats.runs, " runs, ",
+            stats.merges, " merges, ", stats.passes, " passes (runs ", stats.runTime, " ms, merges ",
+            stats.mergeTime, " ms), correctness check: ",
+            checkSorted("benchmark_ExternalSort.out", n, keySum) ? "pass" : "fail");
+}
+
+int main() {
+    printLn("Benchmark of ExternalSort running...\n");
+    {
+        const std::size_t SIZE = 4000000;
+        const std::size_t BLOCK = 1 << 16;
+        const std::size_t MEMORY = 16 << 20;
+        const char *const IN_PATH = "benchmark_ExternalSort.in";
+        const char *const OUT_PATH = "benchmark_ExternalSort.out";
+
+        Random *random = Random::getInstance();
+
+        printLn("Writing ", SIZE, " random 64-byte records to ", IN_PATH, "...");
+        std::uint64_t keySum = 0;
+        {
+            std::ofstream out(IN_PATH, std::ios::binary | std::ios::trunc);
+            std::vector<Record> block(BLOCK);
+            for (std::size_t i = 0; i < SIZE; i += BLOCK) {
+                const std::size_t len = std::min(BLOCK, SIZE - i);
+                for (std::size_t j = 0; j < len; ++j) {
+                    block[j].key = (std::uint64_t)random->nextInt(0, INT32_MAX);
+                    keySum += block[j].key;
+                }
+                out.write((const char*)block.data(), len * sizeof(Record));
+            }
+        }
+        printLn("Finished.\n");
+
+        printLn("Sorting ", SIZE * sizeof(Record) / (1 << 20), " MB with a memory budget of ",
+                MEMORY / (1 << 20), " MB...");
+        for (std::size_t fanIn : {4, 16, 64}) {
+            const std::string name = "pdqSort runs, fan-in " + std::to_string(fanIn);
+            run(name.c_str(), SIZE, keySum, [&]() {
+                return externalSort<Record>(IN_PATH, OUT_PATH, MEMORY, fanIn);
+            });
+        }
+        run("parallelSort runs on 4 threads, fan-in 16", SIZE, keySum, [&]() {
+            return externalSort<Record>(IN_PATH, OUT_PATH, MEMORY, 16, std::less<Record>(), 4);
+        });
+        run("radixSort runs, fan-in 16", SIZE, keySum, [&]() {
+            return externalRadixSort<Record>(IN_PATH, OUT_PATH, [](const Record& r) {
+                return r.key;
+            }, MEMORY, 16);
+        });
+        run("In memory, one run", SIZE, keySum, [&]() {
+            return externalSort<Record>(IN_PATH, OUT_PATH, 2 * SIZE * sizeof(Record));
+        });
+        std::remove(IN_PATH);
+        std::remove(OUT_PATH);
+        printLn("Benchmark of externalSort() finished.\n");
+    }
+    printLn("Benchmark of ExternalSort finished.");
+    checkMemoryLeaks();
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/HashTable.h"
+#include "tastylib/FlatHashTable.h"
+#include "tastylib/FrozenHashSet.h"
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+using tastylib::printLn;
+using tastylib::timing;
+using tastylib::wallTiming;
+using tastylib::Random;
+using tastylib::HashTable;
+using tastylib::FlatHashTable;
+using tastylib::FrozenHashSet;
+
+/*
+Time cost of the lookups of a set.
+*/
+struct Cost {
+    double hit = 0;
+    double miss = 0;
+    bool correct = true;
+};
+
+/*
+Run has() on a set.
+
+@param set    The set to benchmark
+@param vals   The elements in the set
+@param misses The elements that are not in the set
+*/
+template<typename Set>
+Cost run(const Set& set, const std::vector<int>& vals, const std::vector<int>& misses) {
+    Cost cost;
+    cost.hit = timing([&]() {
+        for (const auto &v : vals) {
+            if (!set.has(v)) {
+                cost.correct = false;
+            }
+        }
+    });
+    cost.miss = timing([&]() {
+        for (const auto &v : misses) {
+            if (set.has(v)) {
+                cost.correct = false;
+            }
+        }
+    });
+    return cost;
+}
+
+int main() {
+    printLn("Benchmark of FrozenHashSet running...\n");
+    {
+        const int SIZE = 5000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", SIZE, " elements to benchmark...");
+        std::vector<int> vals, misses;
+        for (int i = 0; i < SIZE; ++i) {
+            vals.push_back(2 * i);
+            misses.push_back(2 * i + 1);
+        }
+        random->shuffle(vals.begin(), vals.end());
+        random->shuffle(misses.begin(), misses.end());
+        HashTable<int> chainTable(SIZE);
+        FlatHashTable<int> flatTable(SIZE);
+        for (const auto &v : vals) {
+            chainTable.insert(v);
+            flatTable.insert(v);
+        }
+        printLn("Finished.\n");
+
+        printLn("Freezing the HashTable...");
+        FrozenHashSet<int> *frozen = nullptr;
+        double build = timing([&]() {
+            frozen = new FrozenHashSet<int>(chainTable);
+        });
+        printLn("Finished in ", build, " ms.");
+        double overhead = (double)(frozen->getBucketCount() * sizeof(std::uint16_t) +
+                                   (frozen->getSlotCount() - frozen->getSize()) * sizeof(int));
+        printLn("Overhead: ", overhead / SIZE, " bytes per element\n");
+
+        printLn("Benchmarking has()...");
+        Cost chainCost = run(chainTable, vals, misses);
+        Cost flatCost = run(flatTable, vals, misses);
+        Cost frozenCost = run(*frozen, vals, misses);
+        printLn("Correctness check: ", chainCost.correct && flatCost.correct &&
+                frozenCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Avg time of HashTable VS FlatHashTable VS FrozenHashSet:");
+        printLn(" has() (hit): ", chainCost.hit / SIZE, " ms / ",
+                flatCost.hit / SIZE, " ms / ", frozenCost.hit / SIZE, " ms");
+        printLn("has() (miss): ", chainCost.miss / SIZE, " ms / ",
+                flatCost.miss / SIZE, " ms / ", frozenCost.miss / SIZE, " ms\n");
+
+        {   // Benchmark the startup from a snapshot
+            const char *path = "benchmark_FrozenHashSet.snap";
+            printLn("Saving a snapshot to ", path, "...");
+            frozen->save(path);
+            printLn("Finished.\n");
+
+            printLn("Benchmarking the startup...");
+            double rebuild = wallTiming([&]() {
+                HashTable<int> table(SIZE);
+                for (const auto &v : vals) {
+                    table.insert(v);
+                }
+            });
+            FrozenHashSet<int> *loaded = nullptr;
+            double load = wallTiming([&]() {
+                loaded = new FrozenHashSet<int>(FrozenHashSet<int>::load(path));
+            });
+            Cost loadedCost = run(*loaded, vals, misses);
+            printLn("Correctness check: ", loadedCost.correct ? "pass" : "fail", "\n");
+
+            printLn("Time of rebuilding a HashTable VS loading a snapshot: ",
+                    rebuild, " ms / ", load, " ms");
+            printLn("Avg time of has() (hit) on the loaded snapshot (", loaded->isMapped() ?
+                    "mapped" : "copied", "): ", loadedCost.hit / SIZE, " ms\n");
+            delete loaded;
+            std::remove(path);
+        }
+        delete frozen;
+    }
+    printLn("Benchmark of FrozenHashSet finished.");
+    checkMemoryLeaks();
+    return 0;
+}
@@ -0,0 +1,307 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/HashTable.h"
+#include "tastylib/FlatHashTable.h"
+#include <unordered_set>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+using tastylib::printLn;
+using tastylib::timing;
+using tastylib::wallTiming;
+using tastylib::Random;
+using tastylib::HashTable;
+using tastylib::HashTableStats;
+using tastylib::FlatHashTable;
+
+/*
+Time cost of the operations of a hash table.
+*/
+struct Cost {
+    double insert = 0;
+    double hit = 0;
+    double miss = 0;
+    double remove = 0;
+    bool correct = true;
+};
+
+/*
+Run insert(), has() and remove() on a hash table.
+
+@param table  The hash table to benchmark
+@param vals   The elements to insert
+@param misses The elements that are not in the table
+*/
+template<typename Table, typename T>
+Cost run(Table& table, const std::vector<T>& vals, const std::vector<T>& misses) {
+    Cost cost;
+    cost.insert = timing([&]() {
+        for (const auto &v : vals) {
+            table.insert(v);
+        }
+    });
+    cost.hit = timing([&]() {
+        for (const auto &v : vals) {
+            if (!table.has(v)) {
+                cost.correct = false;
+            }
+        }
+    });
+    cost.miss = timing([&]() {
+        for (const auto &v : misses) {
+            if (table.has(v)) {
+                cost.correct = false;
+            }
+        }
+    });
+    cost.remove = timing([&]() {
+        for (const auto &v : vals) {
+            table.remove(v);
+        }
+    });
+    cost.correct = cost.correct && table.isEmpty();
+    return cost;
+}
+
+/*
+Adapter that gives std::unordered_set the interface of HashTable.
+*/
+class StdTable {
+public:
+    explicit StdTable(const std::size_t n) : set(n) {}
+    void insert(const int v) { set.insert(v); }
+    bool has(const int v) const { return set.find(v) != set.end(); }
+    void remove(const int v) { set.erase(v); }
+    bool isEmpty() const { return set.empty(); }
+
+private:
+    std::unordered_set<int> set;
+};
+
+/*
+Insert elements into a table that starts with the minimum amount of
+buckets, and record the latency of each insert().
+
+@param table The hash table to benchmark
+@param vals  The elements to insert
+@return      The sorted latencies
+*/
+template<typename Table>
+std::vector<double> latency(Table& table, const std::vector<int>& vals) {
+    std::vector<double> res;
+    res.reserve(vals.size());
+    for (const auto &v : vals) {
+        res.push_back(wallTiming([&]() {
+            table.insert(v);
+        }));
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+/*
+Time cost of single and batched operations of a hash table.
+*/
+struct BatchCost {
+    double insert = 0;
+    double insertBatch = 0;
+    double has = 0;
+    double hasBatch = 0;
+    bool correct = true;
+};
+
+/*
+Compare a loop of insert() and has() with insertBatch() and hasBatch().
+Each pair runs on its own table.
+
+@param vals    The elements to insert
+@param queries The elements to find
+*/
+template<typename Table>
+BatchCost runBatch(const std::vector<int>& vals, const std::vector<int>& queries) {
+    BatchCost cost;
+    std::unique_ptr<bool[]> single(new bool[queries.size()]);
+    std::unique_ptr<bool[]> batch(new bool[queries.size()]);
+    {
+        Table table(vals.size());
+        cost.insert = timing([&]() {
+            for (const auto &v : vals) {
+                table.insert(v);
+            }
+        });
+        cost.has = timing([&]() {
+            for (std::size_t i = 0; i < queries.size(); ++i) {
+                single[i] = table.has(queries[i]);
+            }
+        });
+    }
+    {
+        Table table(vals.size());
+        cost.insertBatch = timing([&]() {
+            table.insertBatch(vals.data(), vals.size());
+        });
+        cost.hasBatch = timing([&]() {
+            table.hasBatch(queries.data(), queries.size(), batch.get());
+        });
+    }
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        if (single[i] != batch[i]) {
+            cost.correct = false;
+        }
+    }
+    return cost;
+}
+
+// Return the p-th percentile of sorted values
+double percentile(const std::vector<double>& sorted, const double p) {
+    return sorted[(std::size_t)(p / 100 * (sorted.size() - 1))];
+}
+
+int main() {
+    printLn("Benchmark of HashTable running...\n");
+    {
+        const int SIZE = 5000000;
+
+        Random *random = Random::getInstance();
+
+        // Generate distinct elements and elements that are never inserted
+        printLn("Generating ", SIZE, " elements to benchmark...");
+        std::vector<int> vals, misses;
+        for (int i = 0; i < SIZE; ++i) {
+            vals.push_back(2 * i);
+            misses.push_back(2 * i + 1);
+        }
+        random->shuffle(vals.begin(), vals.end());
+        random->shuffle(misses.begin(), misses.end());
+        printLn("Finished.\n");
+
+        printLn("Benchmarking std::unordered_set...");
+        StdTable stdTable(SIZE);
+        Cost stdCost = run(stdTable, vals, misses);
+        printLn("Correctness check: ", stdCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Benchmarking HashTable...");
+        HashTable<int> chainTable(SIZE);
+        Cost chainCost = run(chainTable, vals, misses);
+        printLn("Correctness check: ", chainCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Benchmarking FlatHashTable...");
+        FlatHashTable<int> flatTable(SIZE);
+        Cost flatCost = run(flatTable, vals, misses);
+        printLn("Correctness check: ", flatCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Avg time of std VS HashTable VS FlatHashTable:");
+        printLn("    insert(): ", stdCost.insert / SIZE, " ms / ",
+                chainCost.insert / SIZE, " ms / ", flatCost.insert / SIZE, " ms");
+        printLn(" has() (hit): ", stdCost.hit / SIZE, " ms / ",
+                chainCost.hit / SIZE, " ms / ", flatCost.hit / SIZE, " ms");
+        printLn("has() (miss): ", stdCost.miss / SIZE, " ms / ",
+                chainCost.miss / SIZE, " ms / ", flatCost.miss / SIZE, " ms");
+        printLn("    remove(): ", stdCost.remove / SIZE, " ms / ",
+                chainCost.remove / SIZE, " ms / ", flatCost.remove / SIZE, " ms\n");
+
+        {   // Benchmark the cost of the statistics counters
+            // The table starts with the minimum amount of buckets to record its rehashes
+            printLn("Benchmarking HashTable with statistics...");
+            HashTable<int, std::equal_to<int>, std::hash<int>, true> statTable;
+            Cost statCost = run(statTable, vals, misses);
+            printLn("Correctness check: ", statCost.correct ? "pass" : "fail");
+            printLn("Avg time of HashTable without VS with statistics:");
+            printLn(" has() (hit): ", chainCost.hit / SIZE, " ms / ", statCost.hit / SIZE, " ms");
+            printLn("has() (miss): ", chainCost.miss / SIZE, " ms / ", statCost.miss / SIZE, " ms");
+            HashTableStats stats = statTable.getStats();
+            printLn("Avg probes per hit / miss: ", stats.avgProbesHit, " / ", stats.avgProbesMiss);
+            printLn("Rehash count: ", stats.rehashCount, ", rehash time: ", stats.rehashTime, " ms\n");
+        }
+
+        {   // Benchmark insert() latency when the table grows
+            printLn("Benchmarking insert() latency of a growing HashTable...");
+            HashTable<int> fullTable;
+            auto full = latency(fullTable, vals);
+            printLn("Stop-the-world rehash finished.");
+            HashTable<int> incTable;
+            incTable.setIncrementalRehash(true);
+            auto inc = latency(incTable, vals);
+            printLn("Incremental rehash finished.");
+            printLn("Latency of stop-the-world VS incremental rehash:");
+            for (const double p : {50.0, 99.0, 99.99, 100.0}) {
+                printLn("p", p, ": ", percentile(full, p), " ms / ", percentile(inc, p), " ms");
+            }
+            printLn("Benchmark of insert() latency finished.\n");
+        }
+    }
+    {   // Benchmark cached hash values with keys that are expensive to hash and compare
+        const int STR_SIZE = 1000000;
+        const int STR_LEN = 64;
+
+        Random *random = Random::getInstance();
+
+        // Distinct strings sharing a long prefix
+        printLn("Generating ", STR_SIZE, " strings to benchmark cached hash values...");
+        std::vector<std::string> vals, misses;
+        const std::string prefix(STR_LEN, 'x');
+        for (int i = 0; i < STR_SIZE; ++i) {
+            vals.push_back(prefix + std::to_string(2 * i));
+            misses.push_back(prefix + std::to_string(2 * i + 1));
+        }
+        random->shuffle(vals.begin(), vals.end());
+        random->shuffle(misses.begin(), misses.end());
+        printLn("Finished.\n");
+
+        // The tables start with the minimum amount of buckets so that they rehash
+        printLn("Benchmarking HashTable...");
+        HashTable<std::string> plainTable;
+        Cost plainCost = run(plainTable, vals, misses);
+        printLn("Correctness check: ", plainCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Benchmarking HashTable with cached hash values...");
+        HashTable<std::string, std::equal_to<std::string>,
+                  std::hash<std::string>, false, true> cachedTable;
+        Cost cachedCost = run(cachedTable, vals, misses);
+        printLn("Correctness check: ", cachedCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Avg time of HashTable without VS with cached hash values:");
+        printLn("    insert(): ", plainCost.insert / STR_SIZE, " ms / ", cachedCost.insert / STR_SIZE, " ms");
+        printLn(" has() (hit): ", plainCost.hit / STR_SIZE, " ms / ", cachedCost.hit / STR_SIZE, " ms");
+        printLn("has() (miss): ", plainCost.miss / STR_SIZE, " ms / ", cachedCost.miss / STR_SIZE, " ms");
+        printLn("    remove(): ", plainCost.remove / STR_SIZE, " ms / ", cachedCost.remove / STR_SIZE, " ms\n");
+    }
+    {   // Benchmark batched operations on tables much larger than the last level cache
+        const int BIG_SIZE = 16000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", BIG_SIZE, " elements to benchmark batched operations...");
+        std::vector<int> vals, queries;
+        for (int i = 0; i < BIG_SIZE; ++i) {
+            vals.push_back(random->nextInt(0, 2 * BIG_SIZE - 1));
+            queries.push_back(random->nextInt(0, 2 * BIG_SIZE - 1));
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking HashTable...");
+        BatchCost chainCost = runBatch<HashTable<int>>(vals, queries);
+        printLn("Correctness check: ", chainCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Benchmarking FlatHashTable...");
+        BatchCost flatCost = runBatch<FlatHashTable<int>>(vals, queries);
+        printLn("Correctness check: ", flatCost.correct ? "pass" : "fail", "\n");
+
+        printLn("Avg time of single VS batched operations:");
+        printLn("    HashTable insert(): ", chainCost.insert / BIG_SIZE, " ms / ",
+                chainCost.insertBatch / BIG_SIZE, " ms");
+        printLn("       HashTable has(): ", chainCost.has / BIG_SIZE, " ms / ",
+                chainCost.hasBatch / BIG_SIZE, " ms");
+        printLn("FlatHashTable insert(): ", flatCost.insert / BIG_SIZE, " ms / ",
+                flatCost.insertBatch / BIG_SIZE, " ms");
+        printLn("   FlatHashTable has(): ", flatCost.has / BIG_SIZE, " ms / ",
+                flatCost.hasBatch / BIG_SIZE, " ms\n");
+    }
+    printLn("Benchmark of HashTable finished.");
+    checkMemoryLeaks();
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/BinaryHeap.h"
+#include "tastylib/MultiQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+using tastylib::printLn;
+using tastylib::wallTiming;
+using tastylib::Random;
+using tastylib::BinaryHeap;
+using tastylib::MultiQueue;
+
+/*
+A BinaryHeap shared by wrapping every operation in one global mutex.
+*/
+class GlobalLockHeap {
+public:
+    void push(const int v) {
+        std::lock_guard<std::mutex> guard(lock);
+        heap.push(v);
+    }
+
+    bool tryPop(int& v) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (heap.isEmpty()) {
+            return false;
+        }
+        v = heap.popValue();
+        return true;
+    }
+
+private:
+    std::mutex lock;
+    BinaryHeap<int> heap;
+};
+
+/*
+Run the hold model: each operation pops an element and pushes it back
+with a larger key, as a best-first scheduler does.
+
+@param queue   The queue to benchmark. It holds some elements.
+@param threads The amount of threads
+@param ops     The amount of operations per thread
+@return        Million operations (a pop and a push) per second
+*/
+template<typename Queue>
+double hold(Queue& queue, const int threads, const int ops) {
+    double ms = wallTiming([&]() {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.push_back(std::thread([&, t]() {
+                std::uint32_t seed = (std::uint32_t)t * 2654435761U + 1;
+                for (int i = 0; i < ops; ++i) {
+                    int v = 0;
+                    if (queue.tryPop(v)) {
+                        seed = seed * 1664525U + 1013904223U;
+                        queue.push(v + (int)(seed >> 22));  // Add [0, 1024)
+                    }
+                }
+            }));
+        }
+        for (auto &th : pool) {
+            th.join();
+        }
+    });
+    return (double)threads * ops / ms / 1000;
+}
+
+/*
+Pop all elements of a queue holding the keys 0 to n - 1 from several
+threads, and measure the rank error of the pops. The rank error of a pop
+is the amount of smaller keys still in the queue. The pops are ordered by
+a ticket taken right after each pop.
+
+@param queue   The queue to benchmark
+@param threads The amount of threads
+@param n       The amount of keys in the queue
+@param maxErr  Set to the maximum rank error
+@return        The average rank error
+*/
+template<typename Queue>
+double rankError(Queue& queue, const int threads, const int n, int& maxErr) {
+    std::vector<int> order(n);
+    std::atomic<int> ticket(0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.push_back(std::thread([&]() {
+            int v = 0;
+            while (queue.tryPop(v)) {
+                order[ticket.fetch_add(1)] = v;
+            }
+        }));
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+    // Replay the pops with a Fenwick tree of the keys still in the queue
+    std::vector<int> tree(n + 1, 0);
+    for (int i = 1; i <= n; ++i) {
+        tree[i] += 1;
+        if (i + (i & -i) <= n) {
+            tree[i + (i & -i)] += tree[i];
+        }
+    }
+    double sum = 0;
+    maxErr = 0;
+    for (int i = 0; i < n; ++i) {
+        int smaller = 0;
+        for (int j = order[i]; j > 0; j -= j & -j) {
+            smaller += tree[j];
+        }
+        sum += smaller;
+        maxErr = std::max(maxErr, smaller);
+        for (int j = order[i] + 1; j <= n; j += j & -j) {
+            tree[j] -= 1;
+        }
+    }
+    return sum / n;
+}
+
+int main() {
+    printLn("Benchmark of MultiQueue running...\n");
+    {
+        const int SIZE = 1000000;
+        const int OPS = 1000000;
+        const int MAX_THREADS = 8;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", SIZE, " elements to benchmark...");
+        std::vector<int> keys;
+        for (int i = 0; i < SIZE; ++i) {
+            keys.push_back(i);
+        }
+        random->shuffle(keys.begin(), keys.end());
+        printLn("Finished.\n");
+
+        printLn("Benchmarking the hold model with ", OPS, " operations per thread...");
+        printLn("Throughput of global mutex BinaryHeap VS MultiQueue (c = 2, 2 choices) VS MultiQueue (c = 2, 4 choices):");
+        for (int threads = 1; threads <= MAX_THREADS; threads <<= 1) {
+            GlobalLockHeap lockHeap;
+            MultiQueue<int> multi2(threads, 2, 2), multi4(threads, 2, 4);
+            for (const auto &k : keys) {
+                lockHeap.push(k);
+                multi2.push(k);
+                multi4.push(k);
+            }
+            double lockOps = hold(lockHeap, threads, OPS);
+            double multi2Ops = hold(multi2, threads, OPS);
+            double multi4Ops = hold(multi4, threads, OPS);
+            printLn(threads, " thread(s): ", lockOps, " Mops/s / ", multi2Ops, " Mops/s / ",
+                    multi4Ops, " Mops/s");
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking the rank error of popping ", SIZE, " elements...");
+        printLn("Average (maximum) rank error of MultiQueue (c = 2) with 1, 2 and 4 choices:");
+        for (int threads = 1; threads <= MAX_THREADS; threads <<= 1) {
+            double avg[3];
+            int max[3];
+            const int choices[3] = {1, 2, 4};
+            for (int c = 0; c < 3; ++c) {
+                MultiQueue<int> multi(threads, 2, choices[c]);
+                for (const auto &k : keys) {
+                    multi.push(k);
+                }
+                avg[c] = rankError(multi, threads, SIZE, max[c]);
+            }
+            printLn(threads, " thread(s): ", avg[0], " (", max[0], ") / ", avg[1], " (", max[1],
+                    ") / ", avg[2], " (", max[2], ")");
+        }
+        printLn("Finished.\n");
+    }
+    printLn("Benchmark of MultiQueue finished.");
+    checkMemoryLeaks();
+    return 0;
+}
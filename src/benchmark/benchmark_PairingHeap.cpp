@@ -0,0 +1,162 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/util/random.h"
+#include "tastylib/BinaryHeap.h"
+#include "tastylib/PairingHeap.h"
+#include <vector>
+
+using tastylib::printLn;
+using tastylib::timing;
+using tastylib::Random;
+using tastylib::BinaryHeap;
+using tastylib::IndexedBinaryHeap;
+using tastylib::PairingHeap;
+
+/*
+Push values to an empty heap and pop all of them.
+
+@param name The name of the heap
+@param vals The values to push
+*/
+template<typename Heap>
+void pushPop(const char *const name, const std::vector<int>& vals) {
+    Heap heap;
+    auto pushTime = timing([&]() {
+        for (const auto &v : vals) {
+            heap.push(v);
+        }
+    });
+    auto popTime = timing([&]() {
+        while (!heap.isEmpty()) {
+            heap.pop();
+        }
+    });
+    printLn(name, ": push() ", pushTime / vals.size(), " ms, pop() ", popTime / vals.size(), " ms");
+}
+
+int main() {
+    printLn("Benchmark of PairingHeap running...\n");
+    {
+        const int SIZE = 4000000;
+        const int WORKERS = 16;
+        const int ROUNDS = 8;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", SIZE, " elements to push...");
+        std::vector<int> vals;
+        for (int i = 0; i < SIZE; ++i) {
+            vals.push_back(random->nextInt(0, SIZE));
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking push() and pop()...");
+        pushPop<BinaryHeap<int>>("BinaryHeap", vals);
+        pushPop<PairingHeap<int>>("PairingHeap", vals);
+        printLn("Benchmark of push() and pop() finished.\n");
+
+        {   // Benchmark merging the heaps of the workers at each barrier
+            printLn("Benchmarking merging ", WORKERS, " worker heaps in ", ROUNDS, " rounds of ",
+                    SIZE / ROUNDS, " elements...");
+            const int PER_ROUND = SIZE / ROUNDS;
+            double binTime = 0, pairTime = 0;
+            BinaryHeap<int> binMain;
+            PairingHeap<int> pairMain;
+            for (int r = 0; r < ROUNDS; ++r) {
+                std::vector<BinaryHeap<int>> binWorkers(WORKERS);
+                std::vector<PairingHeap<int>> pairWorkers(WORKERS);
+                for (int i = r * PER_ROUND; i < (r + 1) * PER_ROUND; ++i) {
+                    binWorkers[i % WORKERS].push(vals[i]);
+                    pairWorkers[i % WORKERS].push(vals[i]);
+                }
+                binTime += timing([&]() {
+                    for (auto &w : binWorkers) {
+                        w.traverse([&](const int v) {
+                            binMain.push(v);
+                        });
+                        w.clear();
+                    }
+                });
+                pairTime += timing([&]() {
+                    for (auto &w : pairWorkers) {
+                        pairMain.meld(w);
+                    }
+                });
+            }
+            printLn("Time of merging with BinaryHeap VS PairingHeap: ", binTime / ROUNDS,
+                    " ms / ", pairTime / ROUNDS, " ms per round");
+            double binPop = timing([&]() {
+                while (!binMain.isEmpty()) {
+                    binMain.pop();
+                }
+            });
+            double pairPop = timing([&]() {
+                while (!pairMain.isEmpty()) {
+                    pairMain.pop();
+                }
+            });
+            printLn("Time of popping the merged heap with BinaryHeap VS PairingHeap: ", binPop,
+                    " ms / ", pairPop, " ms");
+            printLn("Benchmark of merging finished.\n");
+        }
+
+        {   // Benchmark decreaseKey()
+            printLn("Benchmarking decreaseKey() of ", SIZE, " elements...");
+            // Distinct keys, so that the popped element is known
+            std::vector<int> keys;
+            for (int i = 0; i < SIZE; ++i) {
+                keys.push_back(i);
+            }
+            random->shuffle(keys.begin(), keys.end());
+            IndexedBinaryHeap<int> binHeap;
+            PairingHeap<int> pairHeap;
+            std::vector<IndexedBinaryHeap<int>::Handle> binHandles;
+            std::vector<PairingHeap<int>::Handle> pairHandles;
+            for (const auto &k : keys) {
+                binHandles.push_back(binHeap.push(k));
+                pairHandles.push_back(pairHeap.push(k));
+            }
+            // Pop the smallest key so that the pairing heap is no longer flat
+            binHeap.pop();
+            pairHeap.pop();
+            std::vector<int> order;
+            for (int i = 0; i < SIZE; ++i) {
+                if (keys[i] != 0) {
+                    order.push_back(i);
+                }
+            }
+            random->shuffle(order.begin(), order.end());
+            std::vector<int> newKeys(keys);
+            for (auto &k : newKeys) {
+                k -= random->nextInt(0, SIZE);
+            }
+            double binTime = timing([&]() {
+                for (const auto &i : order) {
+                    binHeap.decreaseKey(binHandles[i], newKeys[i]);
+                }
+            });
+            double pairTime = timing([&]() {
+                for (const auto &i : order) {
+                    pairHeap.decreaseKey(pairHandles[i], newKeys[i]);
+                }
+            });
+            printLn("Avg time of IndexedBinaryHeap VS PairingHeap: ", binTime / order.size(),
+                    " ms / ", pairTime / order.size(), " ms");
+            double binPop = timing([&]() {
+                while (!binHeap.isEmpty()) {
+                    binHeap.pop();
+                }
+            });
+            double pairPop = timing([&]() {
+                while (!pairHeap.isEmpty()) {
+                    pairHeap.pop();
+                }
+            });
+            printLn("Time of popping all elements afterwards: ", binPop, " ms / ", pairPop, " ms");
+            printLn("Benchmark of decreaseKey() finished.\n");
+        }
+    }
+    printLn("Benchmark of PairingHeap finished.");
+    checkMemoryLeaks();
+    return 0;
+}
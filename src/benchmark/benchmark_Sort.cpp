@@ -3,23 +3,264 @@
 #include "tastylib/util/random.h"
 #include "tastylib/Sort.h"
 #include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
 
 using tastylib::printLn;
 using tastylib::timing;
+using tastylib::wallTiming;
 using tastylib::Random;
 using tastylib::insertionSort;
 using tastylib::selectionSort;
 using tastylib::heapSort;
 using tastylib::quickSort;
 using tastylib::quickSelect;
+using tastylib::introSort;
+using tastylib::introSelect;
+using tastylib::pdqSort;
+using tastylib::pdqSelect;
+using tastylib::parallelSort;
+using tastylib::parallelQuickSelect;
+using tastylib::radixSort;
+using tastylib::simdSort;
+using tastylib::timSort;
 
+// A 64-byte record sorted by its key
+struct Record {
+    std::uint64_t key;
+    char data[56];
+
+    bool operator<(const Record& other) const noexcept {
+        return key < other.key;
+    }
+
+    bool operator==(const Record& other) const noexcept {
+        return key == other.key;
+    }
+};
+
+/*
+Print the wall-clock time of std::sort(), and of parallelSort() and
+parallelQuickSelect() on 1 to 'maxThreads' threads.
+
+@param name       The name of the elements
+@param input      The elements
+@param maxThreads The maximum amount of threads
+*/
+template<typename Value>
+void scaling(const char *const name, const std::vector<Value>& input, const std::size_t maxThreads) {
+    const std::size_t n = input.size(), k = n / 2;
+    std::vector<Value> ans(input), arr;
+    auto stdTime = wallTiming([&]() {
+        std::sort(ans.begin(), ans.end());
+    });
+    printLn(name, ", std::sort: ", stdTime, " ms");
+    for (std::size_t threads = 1; threads <= maxThreads; threads <<= 1) {
+        arr = input;
+        auto sortTime = wallTiming([&]() {
+            parallelSort(arr.data(), n, std::less<Value>(), threads);
+        });
+        bool correct = arr == ans;
+        arr = input;
+        auto selectTime = wallTiming([&]() {
+            parallelQuickSelect(arr.data(), n, k, std::less<Value>(), threads);
+        });
+        correct = correct && arr[k] == ans[k];
+        printLn(name, ", ", threads, " thread(s): parallelSort ", sortTime, " ms, parallelQuickSelect ",
+                selectTime, " ms, correctness check: ", correct ? "pass" : "fail");
+    }
+}
+
+/*
+Build an input that makes a quicksort or quickselect take quadratic time
+with McIlroy's adversary ("A Killer Adversary for Quicksort"). The
+adversary decides the order of the elements lazily while the algorithm
+sorts their indices. The algorithm must be deterministic.
+*/
+class Adversary {
+public:
+    explicit Adversary(const int n) : val(n, n), gas(n), solid(0), candidate(0) {}
+
+    struct Cmp {
+        Adversary *adv;
+
+        explicit Cmp(Adversary *a) : adv(a) {}
+
+        bool operator()(const int x, const int y) const {
+            return adv->less(x, y);
+        }
+    };
+
+    // Run an algorithm on the indices 0 to n - 1 and return the input built
+    std::vector<int> build(const std::function<void(int*, const Cmp&)>& run) {
+        std::vector<int> idx;
+        for (int i = 0; i < (int)val.size(); ++i) {
+            idx.push_back(i);
+        }
+        run(idx.data(), Cmp(this));
+        return val;
+    }
+
+private:
+    bool less(const int x, const int y) {
+        if (val[x] == gas && val[y] == gas) {
+            val[x == candidate ? x : y] = solid++;
+        }
+        if (val[x] == gas) {
+            candidate = x;
+        } else if (val[y] == gas) {
+            candidate = y;
+        }
+        return val[x] < val[y];
+    }
+
+    std::vector<int> val;
+    int gas;
+    int solid;
+    int candidate;
+};
+
+/*
+Print the time of std::sort(), quickSort() and pdqSort() with the block
+partition and with the Hoare partition, then of std::nth_element(),
+quickSelect() and pdqSelect() with the block partition.
+
+@param name  The name of the elements
+@param input The elements
+*/
+template<typename Value>
+void pdqColumns(const char *const name, const std::vector<Value>& input) {
+    using Cmp = std::less<Value>;
+    const std::size_t n = input.size(), k = n / 2;
+    std::vector<Value> arr[7] = {input, input, input, input, input, input, input};
+    double t[7];
+    t[0] = timing([&]() {
+        std::sort(arr[0].begin(), arr[0].end());
+    });
+    t[1] = timing([&]() {
+        quickSort(arr[1].data(), 0, n - 1);
+    });
+    t[2] = timing([&]() {
+        pdqSort<Value, Cmp, true>(arr[2].data(), 0, n - 1);
+    });
+    t[3] = timing([&]() {
+        pdqSort<Value, Cmp, false>(arr[3].data(), 0, n - 1);
+    });
+    t[4] = timing([&]() {
+        std::nth_element(arr[4].begin(), arr[4].begin() + k, arr[4].end());
+    });
+    t[5] = timing([&]() {
+        quickSelect(arr[5].data(), 0, n - 1, k);
+    });
+    t[6] = timing([&]() {
+        pdqSelect<Value, Cmp, true>(arr[6].data(), 0, n - 1, k);
+    });
+    bool correct = arr[1] == arr[0] && arr[2] == arr[0] && arr[3] == arr[0] &&
+                   arr[5][k] == arr[4][k] && arr[6][k] == arr[4][k];
+    printLn(name, ": ", t[0], " ms / ", t[1], " ms / ", t[2], " ms / ", t[3], " ms, ",
+            t[4], " ms / ", t[5], " ms / ", t[6], " ms, correctness check: ", correct ? "pass" : "fail");
+}
+
+/*
+Print the time of std::sort(), quickSort(), pdqSort() and simdSort() on an
+array of int32 or float keys.
+
+@param name  The name of the keys
+@param input The keys
+*/
+template<typename Value>
+void simdColumns(const char *const name, const std::vector<Value>& input) {
+    const std::size_t n = input.size();
+    std::vector<Value> arr[4] = {input, input, input, input};
+    auto stdTime = timing([&]() {
+        std::sort(arr[0].begin(), arr[0].end());
+    });
+    auto quickTime = timing([&]() {
+        quickSort(arr[1].data(), 0, n - 1);
+    });
+    auto pdqTime = timing([&]() {
+        pdqSort(arr[2].data(), 0, n - 1);
+    });
+    auto simdTime = timing([&]() {
+        simdSort(arr[3].data(), n);
+    });
+    bool correct = arr[1] == arr[0] && arr[2] == arr[0] && arr[3] == arr[0];
+    printLn(name, ": ", stdTime, " ms / ", quickTime, " ms / ", pdqTime, " ms / ", simdTime,
+            " ms, correctness check: ", correct ? "pass" : "fail");
+}
+
+/*
+Print the time of std::sort(), std::stable_sort(), and of timSort() with
+an unbounded buffer and with a buffer of n / 64 elements.
+
+@param name  The name of the input
+@param input The elements
+*/
+template<typename Value>
+void timColumns(const char *const name, const std::vector<Value>& input) {
+    const std::size_t n = input.size();
+    std::vector<Value> arr[4] = {input, input, input, input};
+    auto stdTime = timing([&]() {
+        std::sort(arr[0].begin(), arr[0].end());
+    });
+    auto stableTime = timing([&]() {
+        std::stable_sort(arr[1].begin(), arr[1].end());
+    });
+    auto timTime = timing([&]() {
+        timSort(arr[2].data(), n);
+    });
+    auto boundedTime = timing([&]() {
+        timSort(arr[3].data(), n, std::less<Value>(), n / 64);
+    });
+    bool correct = arr[2] == arr[1] && arr[3] == arr[1];
+    printLn(name, ": ", stdTime, " ms / ", stableTime, " ms / ", timTime, " ms / ", boundedTime,
+            " ms, correctness check: ", correct ? "pass" : "fail");
+}
+
+/*
+Print the time of std::sort(), introSort() and radixSort() on an array.
+
+@param name  The name of the elements
+@param input The elements
+@param keyOf The function to get the key of an element
+*/
+template<typename Value, typename KeyOf>
+void radixColumns(const char *const name, const std::vector<Value>& input, const KeyOf& keyOf) {
+    auto cmp = [&keyOf](const Value& a, const Value& b) {
+        return keyOf(a) < keyOf(b);
+    };
+    std::vector<Value> arr[3] = {input, input, input};
+    auto stdTime = timing([&]() {
+        std::sort(arr[0].begin(), arr[0].end(), cmp);
+    });
+    auto introTime = timing([&]() {
+        introSort(arr[1].data(), 0, arr[1].size() - 1, cmp);
+    });
+    auto radixTime = timing([&]() {
+        radixSort(arr[2].data(), arr[2].size(), keyOf);
+    });
+    bool correct = std::is_sorted(arr[2].begin(), arr[2].end(), cmp) &&
+                   std::is_sorted(arr[1].begin(), arr[1].end(), cmp);
+    printLn(name, ": ", stdTime, " ms / ", introTime, " ms / ", radixTime, " ms, correctness check: ",
+            correct ? "pass" : "fail");
+}
+
+// Return a number itself as its key
+struct Self {
+    template<typename Value>
+    Value operator()(const Value& v) const noexcept {
+        return v;
+    }
+};
 
 int main() {
     printLn("Benchmark of Sort running...\n");
     {
         const int SIZE = 100000;
         const int CASES = 10;
-        const int METHOD_NUM = 7;
+        const int METHOD_NUM = 8;
 
         Random *random = Random::getInstance();
 
@@ -60,13 +301,16 @@ int main() {
             time[4] += timing([&]() {
                 quickSort(method[4], 0, SIZE - 1);
             });
-            // Quick select
-            unsigned k = random->nextInt(0, SIZE - 1);
             time[5] += timing([&]() {
-                std::nth_element(method[5], method[5] + k, method[5] + SIZE);
+                radixSort(method[5], SIZE);
             });
+            // Quick select
+            unsigned k = random->nextInt(0, SIZE - 1);
             time[6] += timing([&]() {
-                quickSelect(method[6], 0, SIZE - 1, k);
+                std::nth_element(method[6], method[6] + k, method[6] + SIZE);
+            });
+            time[7] += timing([&]() {
+                quickSelect(method[7], 0, SIZE - 1, k);
             });
             printLn("Finished.");
             // Correctness check
@@ -77,7 +321,7 @@ int main() {
                     break;
                 }
             }
-            if (method[5][k] != method[6][k]) {
+            if (method[6][k] != method[7][k]) {
                 correct = false;
             }
             printLn("Correctness check: ", correct ? "pass" : "fail", "\n");
@@ -89,8 +333,9 @@ int main() {
         printLn("  selection sort: ", time[2] / CASES, " ms");
         printLn("       heap sort: ", time[3] / CASES, " ms");
         printLn("      quick sort: ", time[4] / CASES, " ms");
-        printLn("std::nth_element: ", time[5] / CASES, " ms");
-        printLn("    quick select: ", time[6] / CASES, " ms");
+        printLn("      radix sort: ", time[5] / CASES, " ms");
+        printLn("std::nth_element: ", time[6] / CASES, " ms");
+        printLn("    quick select: ", time[7] / CASES, " ms");
 
         // Free resources
         for (int i = 0; i < METHOD_NUM; ++i) {
@@ -98,6 +343,222 @@ int main() {
             method[i] = nullptr;
         }
     }
+    {
+        const int SIZE = 30000;
+        const int DIST_NUM = 6;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating adversarial inputs of ", SIZE, " elements...");
+        std::vector<std::vector<int>> inputs(DIST_NUM);
+        const std::string names[DIST_NUM] = {
+            "sorted", "reversed", "organ pipe", "few unique", "quickSort killer", "quickSelect killer"
+        };
+        for (int i = 0; i < SIZE; ++i) {
+            inputs[0].push_back(i);
+            inputs[1].push_back(SIZE - i);
+            inputs[2].push_back(i < SIZE / 2 ? i : SIZE - i);
+            inputs[3].push_back(random->nextInt(0, 9));
+        }
+        inputs[4] = Adversary(SIZE).build([&](int *arr, const Adversary::Cmp& cmp) {
+            quickSort(arr, 0, SIZE - 1, cmp);
+        });
+        inputs[5] = Adversary(SIZE).build([&](int *arr, const Adversary::Cmp& cmp) {
+            quickSelect(arr, 0, SIZE - 1, SIZE / 2, cmp);
+        });
+        printLn("Finished.\n");
+
+        printLn("Time of std::sort VS quickSort VS introSort VS pdqSort, "
+                "and std::nth_element VS quickSelect VS introSelect VS pdqSelect:");
+        for (int d = 0; d < DIST_NUM; ++d) {
+            std::vector<std::vector<int>> arr(8, inputs[d]);
+            const std::size_t k = SIZE / 2;
+            double t[8];
+            t[0] = timing([&]() {
+                std::sort(arr[0].begin(), arr[0].end());
+            });
+            t[1] = timing([&]() {
+                quickSort(arr[1].data(), 0, SIZE - 1);
+            });
+            t[2] = timing([&]() {
+                introSort(arr[2].data(), 0, SIZE - 1);
+            });
+            t[3] = timing([&]() {
+                std::nth_element(arr[3].begin(), arr[3].begin() + k, arr[3].end());
+            });
+            t[4] = timing([&]() {
+                quickSelect(arr[4].data(), 0, SIZE - 1, k);
+            });
+            t[5] = timing([&]() {
+                introSelect(arr[5].data(), 0, SIZE - 1, k);
+            });
+            t[6] = timing([&]() {
+                pdqSort(arr[6].data(), 0, SIZE - 1);
+            });
+            t[7] = timing([&]() {
+                pdqSelect(arr[7].data(), 0, SIZE - 1, k);
+            });
+            bool correct = arr[1] == arr[0] && arr[2] == arr[0] && arr[6] == arr[0] &&
+                           arr[4][k] == arr[3][k] && arr[5][k] == arr[3][k] && arr[7][k] == arr[3][k];
+            printLn(names[d], ": ", t[0], " ms / ", t[1], " ms / ", t[2], " ms / ", t[6], " ms, ",
+                    t[3], " ms / ", t[4], " ms / ", t[5], " ms / ", t[7], " ms, correctness check: ",
+                    correct ? "pass" : "fail");
+        }
+        printLn("");
+    }
+    {
+        const int SIZE = 1000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating inputs of ", SIZE, " elements...");
+        std::vector<int> rand, sorted, reversed, organ, few, saw;
+        for (int i = 0; i < SIZE; ++i) {
+            rand.push_back(random->nextInt(0, SIZE));
+            sorted.push_back(i);
+            reversed.push_back(SIZE - i);
+            organ.push_back(i < SIZE / 2 ? i : SIZE - i);
+            few.push_back(random->nextInt(0, 9));
+            saw.push_back(i % 1000);
+        }
+        std::vector<Record> records(SIZE);
+        for (auto &r : records) {
+            r.key = (std::uint64_t)random->nextInt(0, SIZE);
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking pdqSort() and pdqSelect()...");
+        printLn("Time of std::sort VS quickSort VS pdqSort with blocks VS pdqSort with Hoare scans, "
+                "and std::nth_element VS quickSelect VS pdqSelect with blocks:");
+        pdqColumns("random", rand);
+        pdqColumns("sorted", sorted);
+        pdqColumns("reversed", reversed);
+        pdqColumns("organ pipe", organ);
+        pdqColumns("few unique", few);
+        pdqColumns("sawtooth", saw);
+        pdqColumns("64-byte records", records);
+        printLn("Benchmark of pdqSort() and pdqSelect() finished.\n");
+    }
+    {
+        const int SIZE = 10000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", SIZE, " int32 and float keys...");
+        std::vector<std::int32_t> ints(SIZE);
+        std::vector<float> floats(SIZE);
+        for (int i = 0; i < SIZE; ++i) {
+            ints[i] = random->nextInt(INT32_MIN, INT32_MAX);
+            floats[i] = (float)random->nextInt(-SIZE, SIZE) / 7;
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking simdSort()...");
+        printLn("Time of std::sort VS quickSort VS pdqSort VS simdSort:");
+        simdColumns("int32_t", ints);
+        simdColumns("float", floats);
+        printLn("Benchmark of simdSort() finished.\n");
+    }
+    {
+        const int SIZE = 1000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating inputs of ", SIZE, " elements...");
+        std::vector<int> rand, sorted, reversed, saw, few, appended;
+        for (int i = 0; i < SIZE; ++i) {
+            rand.push_back(random->nextInt(0, SIZE));
+            sorted.push_back(i);
+            reversed.push_back(SIZE - i);
+            saw.push_back(i % 1000);
+            few.push_back(random->nextInt(0, 9));
+            appended.push_back(i < SIZE - SIZE / 100 ? i : random->nextInt(0, SIZE));
+        }
+        std::vector<Record> records(SIZE);
+        for (auto &r : records) {
+            r.key = (std::uint64_t)random->nextInt(0, SIZE);
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking timSort()...");
+        printLn("Time of std::sort VS std::stable_sort VS timSort VS timSort with a bounded buffer:");
+        timColumns("random", rand);
+        timColumns("sorted", sorted);
+        timColumns("reversed", reversed);
+        timColumns("sawtooth", saw);
+        timColumns("few unique", few);
+        timColumns("sorted with 1% appended", appended);
+        timColumns("64-byte records", records);
+        printLn("Benchmark of timSort() finished.\n");
+    }
+    {
+        const int SIZE = 10000000;
+        const int STR_SIZE = 1000000;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", SIZE, " keys of each type and ", STR_SIZE, " strings...");
+        std::vector<std::uint32_t> u32(SIZE);
+        std::vector<std::uint64_t> u64(SIZE);
+        std::vector<int> i32(SIZE);
+        std::vector<float> f32(SIZE);
+        std::vector<double> f64(SIZE);
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> pairs(SIZE);
+        for (int i = 0; i < SIZE; ++i) {
+            u32[i] = (std::uint32_t)random->nextInt(0, INT32_MAX);
+            u64[i] = (std::uint64_t)u32[i] << 32 | (std::uint32_t)random->nextInt(0, INT32_MAX);
+            i32[i] = random->nextInt(-SIZE, SIZE);
+            f32[i] = (float)i32[i] / 3;
+            f64[i] = (double)i32[i] / 7;
+            pairs[i] = std::make_pair(u64[i], (std::uint64_t)i);
+        }
+        std::vector<std::string> strs(STR_SIZE);
+        for (auto &str : strs) {
+            str.resize(random->nextInt(8, 32));
+            for (auto &c : str) {
+                c = (char)random->nextInt('a', 'z');
+            }
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking radixSort()...");
+        printLn("Time of std::sort VS introSort VS radixSort:");
+        radixColumns("uint32_t", u32, Self());
+        radixColumns("uint64_t", u64, Self());
+        radixColumns("int", i32, Self());
+        radixColumns("float", f32, Self());
+        radixColumns("double", f64, Self());
+        radixColumns("uint64_t key / payload", pairs, [](const std::pair<std::uint64_t, std::uint64_t>& p) {
+            return p.first;
+        });
+        radixColumns("std::string", strs, [](const std::string& str) -> const std::string& {
+            return str;
+        });
+        printLn("Benchmark of radixSort() finished.\n");
+    }
+    {
+        const int INT_SIZE = 100000000;
+        const int RECORD_SIZE = 10000000;
+        const std::size_t MAX_THREADS = 8;
+
+        Random *random = Random::getInstance();
+
+        printLn("Generating ", INT_SIZE, " integers and ", RECORD_SIZE, " 64-byte records...");
+        std::vector<int> ints(INT_SIZE);
+        for (auto &x : ints) {
+            x = random->nextInt(0, INT_SIZE);
+        }
+        std::vector<Record> records(RECORD_SIZE);
+        for (auto &r : records) {
+            r.key = (std::uint64_t)random->nextInt(0, RECORD_SIZE);
+        }
+        printLn("Finished.\n");
+
+        printLn("Benchmarking parallelSort() and parallelQuickSelect()...");
+        scaling("Integers", ints, MAX_THREADS);
+        scaling("Records", records, MAX_THREADS);
+        printLn("Benchmark of parallelSort() and parallelQuickSelect() finished.\n");
+    }
     printLn("Benchmark of Sort finished.");
     checkMemoryLeaks();
     return 0;
@@ -0,0 +1,92 @@
+#include "tastylib/util/io.h"
+#include "tastylib/util/timer.h"
+#include "tastylib/BinaryHeap.h"
+#include "tastylib/TopK.h"
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+using tastylib::printLn;
+using tastylib::timing;
+using tastylib::BinaryHeap;
+using tastylib::TopK;
+
+// A stream of pseudo-random integers that is not stored anywhere
+class Stream {
+public:
+    explicit Stream(const std::uint32_t seed) : state(seed) {}
+
+    int next() {
+        state = state * 1664525U + 1013904223U;
+        return (int)(state >> 1);
+    }
+
+private:
+    std::uint32_t state;
+};
+
+int main() {
+    printLn("Benchmark of TopK running...\n");
+    {
+        const int SIZE = 20000000;
+        const int KS[2] = {100, 10000};
+        const std::uint32_t SEED = 20161018;
+
+        for (const auto &k : KS) {
+            printLn("Selecting the ", k, " largest of ", SIZE, " streamed integers...");
+            long long sum[3] = {0, 0, 0};
+            double mem[3];
+
+            double topkTime = timing([&]() {
+                Stream stream(SEED);
+                TopK<int> topk(k);
+                for (int i = 0; i < SIZE; ++i) {
+                    topk.push(stream.next());
+                }
+                mem[0] = (double)topk.getCapacity() * sizeof(int);
+                for (const auto &x : topk.takeSorted()) {
+                    sum[0] += x;
+                }
+            });
+
+            double heapTime = timing([&]() {
+                Stream stream(SEED);
+                BinaryHeap<int, std::greater<int>> heap;
+                for (int i = 0; i < SIZE; ++i) {
+                    heap.push(stream.next());
+                }
+                mem[1] = (double)heap.getCapacity() * sizeof(int);
+                for (int i = 0; i < k; ++i) {
+                    sum[1] += heap.popValue();
+                }
+            });
+
+            double nthTime = timing([&]() {
+                Stream stream(SEED);
+                std::vector<int> vals;
+                for (int i = 0; i < SIZE; ++i) {
+                    vals.push_back(stream.next());
+                }
+                mem[2] = (double)vals.capacity() * sizeof(int);
+                std::nth_element(vals.begin(), vals.begin() + k - 1, vals.end(), std::greater<int>());
+                for (int i = 0; i < k; ++i) {
+                    sum[2] += vals[i];
+                }
+            });
+
+            if (sum[0] != sum[1] || sum[0] != sum[2]) {
+                printLn("Error: the selectors disagree.");
+                return 1;
+            }
+            printLn("Time of TopK VS BinaryHeap + ", k, " pops VS std::nth_element: ",
+                    topkTime, " ms / ", heapTime, " ms / ", nthTime, " ms");
+            printLn("Memory of the kept values: ", mem[0] / 1024, " KB / ", mem[1] / 1024, " KB / ",
+                    mem[2] / 1024, " KB");
+            printLn("Finished.\n");
+        }
+    }
+    printLn("Benchmark of TopK finished.");
+    checkMemoryLeaks();
+    return 0;
+}
@@ -1,9 +1,14 @@
 #include "gtest/gtest.h"
 #include "tastylib/util/random.h"
 #include "tastylib/BinaryHeap.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
 
 using tastylib::Random;
 using tastylib::BinaryHeap;
+using tastylib::IndexedBinaryHeap;
 
 typedef BinaryHeap<int>::SizeType SizeType;
 
@@ -56,3 +61,196 @@ TEST(BinaryHeapTest, MaxRoot) {
     }
     EXPECT_TRUE(heap.isEmpty());
 }
+
+TEST(BinaryHeapTest, ParallelBuild) {
+    const int SIZE = 300000;
+    Random *random = Random::getInstance();
+    std::vector<int> vals;
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(random->nextInt(0, SIZE));
+    }
+    for (SizeType threads = 1; threads <= 8; threads <<= 1) {
+        BinaryHeap<int, std::greater<int>> heap(vals, std::greater<int>(), threads);
+        std::vector<int> ans(vals);
+        std::sort(ans.begin(), ans.end(), std::greater<int>());
+        for (const auto &x : ans) {
+            EXPECT_EQ(heap.popValue(), x);
+        }
+        EXPECT_TRUE(heap.isEmpty());
+    }
+    // Small heaps are built on one thread
+    BinaryHeap<int> small(std::vector<int>{3, 1, 2}, std::less<int>(), 4);
+    EXPECT_EQ(small.popValue(), 1);
+    EXPECT_EQ(small.popValue(), 2);
+    EXPECT_EQ(small.popValue(), 3);
+}
+
+TEST(BinaryHeapTest, PushBatch) {
+    const int SIZE = 1000;
+    Random *random = Random::getInstance();
+    BinaryHeap<int> heap;
+    std::vector<int> ans;
+    // Batches of various sizes, from smaller than the height of the heap
+    // to larger than the heap
+    for (int n = 1; n <= SIZE; n *= 3) {
+        std::vector<int> batch;
+        for (int i = 0; i < n; ++i) {
+            batch.push_back(random->nextInt(0, SIZE));
+        }
+        ans.insert(ans.end(), batch.begin(), batch.end());
+        if (n % 2) {
+            heap.pushBatch(batch);
+        } else {
+            heap.pushBatch(std::move(batch));
+        }
+        EXPECT_EQ(heap.getSize(), ans.size());
+        EXPECT_EQ(heap.top(), *std::min_element(ans.begin(), ans.end()));
+    }
+    heap.pushBatch(std::vector<int>());
+    std::sort(ans.begin(), ans.end());
+    for (const auto &x : ans) {
+        EXPECT_EQ(heap.popValue(), x);
+    }
+    EXPECT_TRUE(heap.isEmpty());
+
+    BinaryHeap<std::unique_ptr<int>, std::function<bool(const std::unique_ptr<int>&,
+                                                        const std::unique_ptr<int>&)>> ptrs(
+        [](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) {
+            return *a < *b;
+        });
+    std::vector<std::unique_ptr<int>> batch;
+    for (int i = 100; i > 0; --i) {
+        batch.push_back(std::unique_ptr<int>(new int(i)));
+    }
+    ptrs.pushBatch(std::move(batch));
+    for (int i = 1; i <= 100; ++i) {
+        EXPECT_EQ(*ptrs.popValue(), i);
+    }
+}
+
+TEST(BinaryHeapTest, Capacity) {
+    BinaryHeap<int> heap;
+    heap.reserve(100);
+    EXPECT_GE(heap.getCapacity(), (SizeType)100);
+    for (int i = 0; i < 1000; ++i) {
+        heap.push(i);
+    }
+    while (heap.getSize() > 10) {
+        heap.pop();
+    }
+    heap.shrinkToFit();
+    EXPECT_EQ(heap.getCapacity(), (SizeType)10);
+    heap.replaceTop(2000);
+    EXPECT_EQ(heap.top(), 991);
+    for (int i = 991; i < 1000; ++i) {
+        EXPECT_EQ(heap.popValue(), i);
+    }
+    EXPECT_EQ(heap.popValue(), 2000);
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(BinaryHeapTest, Indexed) {
+    IndexedBinaryHeap<int> heap;
+    EXPECT_TRUE(heap.isEmpty());
+    auto h50 = heap.push(50);
+    auto h20 = heap.push(20);
+    auto h30 = heap.push(30);
+    auto h40 = heap.push(40);
+    EXPECT_EQ(heap.getSize(), (SizeType)4);
+    EXPECT_TRUE(heap.contains(h50));
+    EXPECT_FALSE(heap.contains(100));
+    EXPECT_EQ(heap.get(h30), 30);
+    EXPECT_EQ(heap.top(), 20);
+    EXPECT_EQ(heap.topHandle(), h20);
+
+    heap.decreaseKey(h50, 10);
+    EXPECT_EQ(heap.top(), 10);
+    EXPECT_EQ(heap.topHandle(), h50);
+
+    heap.erase(h30);
+    EXPECT_FALSE(heap.contains(h30));
+    EXPECT_EQ(heap.getSize(), (SizeType)3);
+
+    heap.pop();
+    EXPECT_FALSE(heap.contains(h50));
+    EXPECT_EQ(heap.top(), 20);
+    heap.pop();
+    EXPECT_EQ(heap.topHandle(), h40);
+    heap.pop();
+    EXPECT_TRUE(heap.isEmpty());
+
+    // Handles of removed elements are reused
+    auto h = heap.push(1);
+    EXPECT_TRUE(h == h20 || h == h30 || h == h40 || h == h50);
+    heap.clear();
+    EXPECT_FALSE(heap.contains(h));
+}
+
+TEST(BinaryHeapTest, IndexedRandom) {
+    const int SIZE = 1000;
+    Random *random = Random::getInstance();
+    IndexedBinaryHeap<int> heap;
+    std::vector<IndexedBinaryHeap<int>::Handle> handles;
+    std::vector<int> vals;
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(random->nextInt(0, SIZE));
+        handles.push_back(heap.push(vals[i]));
+    }
+    // Decrease a third of the values and erase another third
+    std::vector<bool> erased(SIZE, false);
+    for (int i = 0; i < SIZE; ++i) {
+        if (i % 3 == 0) {
+            vals[i] -= random->nextInt(0, SIZE);
+            heap.decreaseKey(handles[i], vals[i]);
+        } else if (i % 3 == 1) {
+            heap.erase(handles[i]);
+            erased[i] = true;
+        }
+    }
+    std::vector<int> ans;
+    for (int i = 0; i < SIZE; ++i) {
+        if (!erased[i]) {
+            EXPECT_EQ(heap.get(handles[i]), vals[i]);
+            ans.push_back(vals[i]);
+        }
+    }
+    std::sort(ans.begin(), ans.end());
+    EXPECT_EQ(heap.getSize(), ans.size());
+    for (const auto &x : ans) {
+        EXPECT_EQ(heap.top(), x);
+        heap.pop();
+    }
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(BinaryHeapTest, Move) {
+    struct PtrLess {
+        bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const {
+            return *a < *b;
+        }
+    };
+    BinaryHeap<std::unique_ptr<int>, PtrLess> heap;
+    for (int i = 0; i < 30; ++i) {
+        heap.push(std::unique_ptr<int>(new int((i * 7) % 30)));
+    }
+    heap.emplace(new int(-1));
+    EXPECT_EQ(heap.getSize(), (SizeType)31);
+    EXPECT_EQ(*heap.top(), -1);
+    for (int i = -1; i < 30; ++i) {
+        auto p = heap.popValue();
+        EXPECT_EQ(*p, i);
+    }
+    EXPECT_TRUE(heap.isEmpty());
+
+    std::vector<std::string> vals = {"Bob", "Alice", "Darth"};
+    BinaryHeap<std::string> strHeap(std::move(vals));
+    EXPECT_EQ(strHeap.getSize(), (SizeType)3);
+    EXPECT_EQ(strHeap.popValue(), "Alice");
+    EXPECT_EQ(strHeap.popValue(), "Bob");
+    EXPECT_EQ(strHeap.top(), "Darth");
+
+    BinaryHeap<std::string> emptyHeap((std::vector<std::string>()));
+    EXPECT_TRUE(emptyHeap.isEmpty());
+    emptyHeap.emplace(3, 'x');
+    EXPECT_EQ(emptyHeap.top(), "xxx");
+}
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "tastylib/BloomFilter.h"
+#include "tastylib/HashTable.h"
+#include "tastylib/AVLTree.h"
+#include <string>
+#include <utility>
+
+using tastylib::BloomFilter;
+using tastylib::BloomFilteredTable;
+using tastylib::HashTable;
+using tastylib::AVLTree;
+
+typedef BloomFilter<int>::SizeType SizeType;
+
+TEST(BloomFilterTest, Basic) {
+    BloomFilter<std::string> filter(100);
+    EXPECT_EQ(filter.getBlockCount(), (SizeType)4);
+    EXPECT_EQ(filter.getBitCount(), (SizeType)1024);
+    EXPECT_FALSE(filter.mayHave("Alice"));
+    filter.insert("Alice");
+    filter.insert("Darth");
+    EXPECT_TRUE(filter.mayHave("Alice"));
+    EXPECT_TRUE(filter.mayHave("Darth"));
+    filter.clear();
+    EXPECT_FALSE(filter.mayHave("Alice"));
+
+    BloomFilter<int> empty;
+    EXPECT_EQ(empty.getBlockCount(), (SizeType)1);
+    EXPECT_FALSE(empty.mayHave(0));
+}
+
+TEST(BloomFilterTest, Move) {
+    BloomFilter<int> a(1000);
+    a.insert(1);
+    BloomFilter<int> b(std::move(a));
+    EXPECT_EQ(a.getBlockCount(), (SizeType)0);
+    EXPECT_EQ(b.getBlockCount(), (SizeType)40);
+    EXPECT_TRUE(b.mayHave(1));
+    // The moved-from filter no longer refers to the blocks of 'b'
+    a.clear();
+    EXPECT_TRUE(b.mayHave(1));
+
+    BloomFilter<int> c;
+    c.insert(2);
+    c = std::move(b);
+    EXPECT_EQ(b.getBlockCount(), (SizeType)0);
+    EXPECT_TRUE(c.mayHave(1));
+    b = BloomFilter<int>(100);
+    b.insert(3);
+    EXPECT_TRUE(b.mayHave(3));
+}
+
+TEST(BloomFilterTest, FalsePositiveRate) {
+    const int n = 100000;
+    BloomFilter<int> filter(n, 10);
+    for (int i = 0; i < n; ++i) {
+        filter.insert(i * 2);
+    }
+    int falsePositives = 0;
+    for (int i = 0; i < n; ++i) {
+        EXPECT_TRUE(filter.mayHave(i * 2));
+        falsePositives += filter.mayHave(i * 2 + 1);
+    }
+    // About 1% with 10 bits per key
+    EXPECT_LT(falsePositives, n / 50);
+}
+
+TEST(BloomFilterTest, FilteredTable) {
+    BloomFilteredTable<HashTable<int>, int> table(1000);
+    BloomFilteredTable<AVLTree<int>, int> tree(1000);
+    for (int i = 0; i < 1000; ++i) {
+        table.insert(i * 2);
+        tree.insert(i * 2);
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)1000);
+    EXPECT_EQ(tree.getSize(), (SizeType)1000);
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_EQ(table.has(i), i % 2 == 0);
+        EXPECT_EQ(tree.has(i), i % 2 == 0);
+    }
+    EXPECT_EQ(table.getRejectedCount() + table.getFalsePositiveCount(), (SizeType)1000);
+    EXPECT_LT(table.getFalsePositiveRate(), 0.05);
+    EXPECT_EQ(table.getFalsePositiveRate(), tree.getFalsePositiveRate());
+
+    // Removed values are still rejected by the table
+    const SizeType falsePositives = table.getFalsePositiveCount();
+    table.remove(0);
+    EXPECT_FALSE(table.has(0));
+    EXPECT_EQ(table.getFalsePositiveCount(), falsePositives + 1);
+    table.resetCounters();
+    EXPECT_EQ(table.getRejectedCount(), (SizeType)0);
+    table.clear();
+    EXPECT_TRUE(table.isEmpty());
+    EXPECT_FALSE(table.has(2));
+    EXPECT_EQ(table.getRejectedCount(), (SizeType)1);
+}
@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+#include "tastylib/ConcurrentHashTable.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using tastylib::ConcurrentHashTable;
+
+typedef ConcurrentHashTable<std::string>::SizeType SizeType;
+
+TEST(ConcurrentHashTableTest, Basic) {
+    ConcurrentHashTable<std::string> table;
+    EXPECT_EQ(table.getShardCount(), (SizeType)64);
+    EXPECT_TRUE(table.isEmpty());
+    table.insert("Alice");
+    table.insert("Alice");
+    table.insert("Darth");
+    EXPECT_EQ(table.getSize(), (SizeType)2);
+    EXPECT_TRUE(table.has("Alice"));
+    EXPECT_TRUE(table.has("Darth"));
+    table.remove("Darth");
+    table.remove("Bob");
+    EXPECT_TRUE(table.has("Alice"));
+    EXPECT_FALSE(table.has("Darth"));
+    EXPECT_EQ(table.getSize(), (SizeType)1);
+    table.clear();
+    EXPECT_EQ(table.getSize(), (SizeType)0);
+    EXPECT_FALSE(table.has("Alice"));
+}
+
+TEST(ConcurrentHashTableTest, Growth) {
+    ConcurrentHashTable<int> table(0, 3);
+    EXPECT_EQ(table.getShardCount(), (SizeType)4);
+    for (int i = 0; i < 10000; ++i) {
+        table.insert(i);
+    }
+    for (int i = 0; i < 10000; i += 2) {
+        table.remove(i);
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)5000);
+    bool res = true;
+    for (int i = 0; i < 20000; ++i) {
+        if (table.has(i) != (i < 10000 && i % 2 == 1)) {
+            res = false;
+            break;
+        }
+    }
+    EXPECT_TRUE(res);
+}
+
+TEST(ConcurrentHashTableTest, ConcurrentInsert) {
+    const int THREADS = 8, PER_THREAD = 5000;
+    ConcurrentHashTable<int> table(0, 4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.push_back(std::thread([&table, t]() {
+            // Every value is inserted by two threads
+            for (int i = 0; i < PER_THREAD; ++i) {
+                table.insert((t / 2) * PER_THREAD + i);
+            }
+        }));
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)(THREADS / 2 * PER_THREAD));
+    for (int i = 0; i < THREADS / 2 * PER_THREAD; ++i) {
+        EXPECT_TRUE(table.has(i));
+    }
+}
+
+TEST(ConcurrentHashTableTest, ReadWhileWrite) {
+    const int SIZE = 20000;
+    ConcurrentHashTable<int> table(0, 2);
+    for (int i = 0; i < SIZE; ++i) {
+        table.insert(i);
+    }
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.push_back(std::thread([&]() {
+            while (!done.load()) {
+                for (int i = 0; i < SIZE; i += 7) {
+                    // Present values must stay visible while the shards grow
+                    if (!table.has(i) || table.has(-i - 1)) {
+                        ++errors;
+                    }
+                }
+            }
+        }));
+    }
+    for (int i = SIZE; i < 10 * SIZE; ++i) {
+        table.insert(i);
+        table.remove(i - SIZE / 2 > SIZE ? i - SIZE / 2 : SIZE);
+    }
+    done.store(true);
+    for (auto &th : readers) {
+        th.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+}
+
+TEST(ConcurrentHashTableTest, LockedRead) {
+    ConcurrentHashTable<std::string> table(0, 2);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&table, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                table.insert(std::to_string(t * 1000 + i));
+                table.has(std::to_string(i));
+            }
+        }));
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)4000);
+    EXPECT_TRUE(table.has("3999"));
+}
+
+TEST(ConcurrentHashTableTest, Churn) {
+    const int SIZE = 1000, ROUNDS = 200;
+    ConcurrentHashTable<int> table(0, 2);
+    for (int i = 0; i < SIZE; ++i) {
+        table.insert(i);
+    }
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    std::thread reader([&]() {
+        // The even values are never removed
+        while (!done.load()) {
+            for (int i = 0; i < SIZE; i += 2) {
+                if (!table.has(i)) {
+                    ++errors;
+                }
+            }
+        }
+    });
+    // Replace the odd values over and over, so the shards are full of tombstones
+    for (int r = 1; r <= ROUNDS; ++r) {
+        for (int i = 1; i < SIZE; i += 2) {
+            table.remove((r - 1) * SIZE + i);
+            table.insert(r * SIZE + i);
+        }
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(table.getSize(), (SizeType)SIZE);
+    bool res = true;
+    for (int i = 0; i < SIZE; ++i) {
+        res = res && table.has(i % 2 ? ROUNDS * SIZE + i : i);
+        res = res && !table.has((ROUNDS - 1) * SIZE + i + (i % 2 ? 0 : SIZE));
+    }
+    EXPECT_TRUE(res);
+    // Only growing replaces arrays, and the table never grew past its size
+    EXPECT_LE(table.getBucketCount(), (SizeType)(8 * SIZE));
+    EXPECT_LT(table.getRetiredBucketCount(), table.getBucketCount());
+
+    ConcurrentHashTable<std::string> strs(0, 1);
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (int i = 0; i < 100; ++i) {
+            strs.insert(std::to_string(r * 100 + i));
+        }
+        for (int i = 0; i < 100; ++i) {
+            strs.remove(std::to_string(r * 100 + i));
+        }
+        strs.insert(std::to_string(r));
+    }
+    EXPECT_EQ(strs.getSize(), (SizeType)ROUNDS);
+    res = true;
+    for (int r = 0; r < ROUNDS; ++r) {
+        res = res && strs.has(std::to_string(r));
+    }
+    EXPECT_TRUE(res);
+    EXPECT_LE(strs.getBucketCount(), (SizeType)1024);
+}
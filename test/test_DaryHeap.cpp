@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "tastylib/util/random.h"
+#include "tastylib/DaryHeap.h"
+#include <algorithm>
+#include <string>
+#include <cstdint>
+
+using tastylib::Random;
+using tastylib::DaryHeap;
+using tastylib::AlignedAllocator;
+
+typedef DaryHeap<int>::SizeType SizeType;
+
+namespace {
+
+/*
+Push random values to a heap, build another one from the same values,
+and check that both pop the values in order.
+*/
+template<std::size_t D>
+void checkOrder(const int size) {
+    std::vector<int> vals;
+    for (int i = 0; i < size; ++i) {
+        vals.push_back(Random::getInstance()->nextInt(0, size));
+    }
+    DaryHeap<int, std::less<int>, D> pushed;
+    for (const auto &x : vals) {
+        pushed.push(x);
+    }
+    DaryHeap<int, std::less<int>, D> built(vals);
+    EXPECT_EQ(pushed.getSize(), (SizeType)size);
+    EXPECT_EQ(built.getSize(), (SizeType)size);
+    std::sort(vals.begin(), vals.end());
+    for (const auto &x : vals) {
+        EXPECT_EQ(pushed.top(), x);
+        EXPECT_EQ(built.top(), x);
+        pushed.pop();
+        built.pop();
+    }
+    EXPECT_TRUE(pushed.isEmpty());
+    EXPECT_TRUE(built.isEmpty());
+}
+
+}
+
+TEST(DaryHeapTest, Basic) {
+    DaryHeap<int> heap;
+    EXPECT_TRUE(heap.isEmpty());
+    EXPECT_EQ(heap.getSize(), (SizeType)0);
+    heap.push(50);
+    heap.push(20);
+    heap.push(30);
+    EXPECT_FALSE(heap.isEmpty());
+    EXPECT_EQ(heap.getSize(), (SizeType)3);
+    EXPECT_EQ(heap.top(), 20);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 30);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 50);
+    EXPECT_EQ(heap.getSize(), (SizeType)1);
+    heap.pop();
+    EXPECT_TRUE(heap.isEmpty());
+    heap.push(10);
+    heap.clear();
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(DaryHeapTest, Arity) {
+    for (int size = 0; size < 40; ++size) {
+        checkOrder<2>(size);
+        checkOrder<3>(size);
+        checkOrder<4>(size);
+        checkOrder<8>(size);
+    }
+    checkOrder<4>(1000);
+    checkOrder<16>(1000);
+}
+
+TEST(DaryHeapTest, MaxRoot) {
+    std::vector<std::string> vals = {"Bob", "Alice", "Darth", "Eve", "Carol"};
+    DaryHeap<std::string, std::greater<std::string>, 4> heap(vals);
+    std::sort(vals.begin(), vals.end(), std::greater<std::string>());
+    for (const auto &x : vals) {
+        EXPECT_EQ(heap.top(), x);
+        heap.pop();
+    }
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(DaryHeapTest, Aligned) {
+    for (int n = 1; n < 100; ++n) {
+        std::vector<int, AlignedAllocator<int>> vec(n);
+        EXPECT_EQ((std::uintptr_t)vec.data() % 64, (std::uintptr_t)0);
+    }
+}
@@ -4,6 +4,9 @@
 
 using tastylib::DijkGraph;
 using tastylib::dijkstra;
+using tastylib::DijkQueue;
+using tastylib::DIJK_BINARY_HEAP;
+using tastylib::DIJK_RADIX_HEAP;
 
 typedef DijkGraph<std::string> G;
 typedef G::NumType NumType;
@@ -31,7 +34,10 @@ TEST(DijkstraTest, Simple) {
     EXPECT_TRUE(graph[2].val == "Bob");
 }
 
-TEST(DijkstraTest, Complex) {
+namespace {
+
+// Run Dijkstra's algorithm on a graph of 8 vertices with a given queue
+void checkComplex(const DijkQueue queue) {
     G graph(8, G::MATRIX);
     graph.setWeight(1, 0, 1);
     graph.setWeight(1, 2, 2);
@@ -48,7 +54,7 @@ TEST(DijkstraTest, Complex) {
     graph.setWeight(7, 6, 1);
 
     {
-        dijkstra(graph, 1);
+        dijkstra(graph, 1, queue);
         std::vector<WeightType> expectDist = {1, 0, 2, 3, 1, 3, 6, 5};
         for (NumType i = 0; i < graph.getSize(); ++i) {
             EXPECT_EQ(graph[i].dist, expectDist[i]);
@@ -60,7 +66,7 @@ TEST(DijkstraTest, Complex) {
     }
 
     {
-        dijkstra(graph, 2);
+        dijkstra(graph, 2, queue);
         std::vector<WeightType> expectDist = {10, 9, 0, 5, 3, 5, 8, 7};
         for (NumType i = 0; i < graph.getSize(); ++i) {
             EXPECT_EQ(graph[i].dist, expectDist[i]);
@@ -71,3 +77,13 @@ TEST(DijkstraTest, Complex) {
         }
     }
 }
+
+}
+
+TEST(DijkstraTest, Complex) {
+    checkComplex(DIJK_BINARY_HEAP);
+}
+
+TEST(DijkstraTest, RadixHeap) {
+    checkComplex(DIJK_RADIX_HEAP);
+}
@@ -1,7 +1,9 @@
 #include "gtest/gtest.h"
 #include "tastylib/DoublyLinkedList.h"
+#include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 using tastylib::DoublyLinkedList;
 
@@ -146,6 +148,32 @@ TEST(DoublyLinkedListTest, Find) {
     EXPECT_EQ(p, 2);
     p = list.find(3);
     EXPECT_EQ(p, -1);
+    p = list.findIf([](const int val) { return val > 0; });
+    EXPECT_EQ(p, 1);
+    p = list.findIf([](const int val) { return val > 2; });
+    EXPECT_EQ(p, -1);
+}
+
+TEST(DoublyLinkedListTest, Splice) {
+    DoublyLinkedList<int> list1, list2;
+    list1.spliceFrontTo(list2);
+    EXPECT_TRUE(list2.isEmpty());
+    for (int i = 0; i < 3; ++i) {
+        list1.insertBack(i);
+    }
+    list2.insertBack(9);
+    EXPECT_EQ(list1.front(), 0);
+    list1.spliceFrontTo(list2);
+    EXPECT_EQ(getListContent(list1), "12");
+    EXPECT_EQ(getListContent(list2), "90");
+    list1.spliceFrontTo(list2);
+    list1.spliceFrontTo(list2);
+    EXPECT_TRUE(list1.isEmpty());
+    EXPECT_EQ(getListContent(list2), "9012");
+    list2.removeBack();
+    list1.insertBack(5);
+    EXPECT_EQ(getListContent(list1), "5");
+    EXPECT_EQ(getListContent(list2), "901");
 }
 
 TEST(DoublyLinkedListTest, Sort) {
@@ -172,3 +200,38 @@ TEST(DoublyLinkedListTest, Sort) {
     list.sort();
     EXPECT_EQ(getListContent(list), "0112234");
 }
+
+TEST(DoublyLinkedListTest, SortStable) {
+    // Long sorted stretches make the merge gallop
+    typedef std::pair<int, int> Pair;
+    DoublyLinkedList<Pair> list;
+    std::vector<Pair> ans;
+    const int n = 1000;
+    for (int i = 0; i < n; ++i) {
+        ans.push_back(Pair(i < n / 2 ? i : i - n / 2, i));
+        list.insertBack(ans.back());
+    }
+    ans.push_back(Pair(-1, n));
+    list.insertBack(ans.back());
+    auto cmp = [](const Pair& a, const Pair& b) {
+        return a.first < b.first;
+    };
+    list.sort(cmp);
+    std::stable_sort(ans.begin(), ans.end(), cmp);
+    auto check = [&]() {
+        ASSERT_EQ(list.getSize(), ans.size());
+        list.traverse([&](const SizeType pos, const Pair& p) {
+            EXPECT_EQ(p, ans[pos]);
+        });
+    };
+    check();
+    // Removing near the back walks the prev pointers from the tail
+    while (ans.size() > 2) {
+        const SizeType pos = ans.size() - 2;
+        list.remove(pos);
+        ans.erase(ans.begin() + pos);
+        list.removeBack();
+        ans.pop_back();
+    }
+    check();
+}
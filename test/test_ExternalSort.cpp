@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include "tastylib/ExternalSort.h"
+#include "tastylib/util/random.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using tastylib::Random;
+using tastylib::ExternalSortStats;
+using tastylib::externalSort;
+using tastylib::externalRadixSort;
+
+namespace {
+
+// A 32-byte record sorted by its key
+struct Record {
+    std::uint64_t key;
+    std::uint64_t id;
+    char data[16];
+
+    bool operator<(const Record& other) const noexcept {
+        return key < other.key;
+    }
+};
+
+template<typename Value>
+void writeFile(const std::string& path, const std::vector<Value>& vals) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char*)vals.data(), vals.size() * sizeof(Value));
+}
+
+template<typename Value>
+std::vector<Value> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    std::vector<Value> vals((std::size_t)in.tellg() / sizeof(Value));
+    in.seekg(0);
+    in.read((char*)vals.data(), vals.size() * sizeof(Value));
+    return vals;
+}
+
+bool fileExists(const std::string& path) {
+    return (bool)std::ifstream(path);
+}
+
+const char *const IN_PATH = "test_ExternalSort_in.bin";
+const char *const OUT_PATH = "test_ExternalSort_out.bin";
+
+}
+
+TEST(ExternalSortTest, Ints) {
+    Random *random = Random::getInstance();
+    std::vector<int> vals;
+    for (int i = 0; i < 100000; ++i) {
+        vals.push_back(random->nextInt(-1000000, 1000000));
+    }
+    writeFile(IN_PATH, vals);
+    auto ans = vals;
+    std::sort(ans.begin(), ans.end());
+
+    // The input fits in memory
+    ExternalSortStats stats = externalSort<int>(IN_PATH, OUT_PATH, 1 << 20);
+    EXPECT_EQ(readFile<int>(OUT_PATH), ans);
+    EXPECT_EQ(stats.records, vals.size());
+    EXPECT_EQ(stats.runs, (std::size_t)1);
+    EXPECT_EQ(stats.merges, (std::size_t)0);
+    EXPECT_EQ(stats.passes, 1.0);
+
+    // 100 runs of 1000 elements
+    for (std::size_t fanIn : {2, 3, 10, 16, 100, 1000}) {
+        stats = externalSort<int>(IN_PATH, OUT_PATH, 8000, fanIn);
+        EXPECT_EQ(readFile<int>(OUT_PATH), ans);
+        EXPECT_EQ(stats.runs, (std::size_t)100);
+        EXPECT_EQ(stats.bytesRead, stats.bytesWritten);
+        EXPECT_FALSE(fileExists(std::string(OUT_PATH) + ".run0"));
+        EXPECT_FALSE(fileExists(std::string(OUT_PATH) + ".merge0"));
+    }
+    // 10 merges of 10 runs, then the final one
+    stats = externalSort<int>(IN_PATH, OUT_PATH, 8000, 10);
+    EXPECT_EQ(stats.merges, (std::size_t)11);
+    EXPECT_EQ(stats.passes, 3.0);
+    // The first merge takes 4 runs, then 97 runs are left
+    stats = externalSort<int>(IN_PATH, OUT_PATH, 8000, 97);
+    EXPECT_EQ(stats.merges, (std::size_t)2);
+    EXPECT_DOUBLE_EQ(stats.passes, 2.04);
+
+    // Sort in descending order on several threads
+    stats = externalSort<int>(IN_PATH, OUT_PATH, 8000, 4, std::greater<int>(), 4);
+    std::reverse(ans.begin(), ans.end());
+    EXPECT_EQ(readFile<int>(OUT_PATH), ans);
+
+    // Sort a file in place
+    externalSort<int>(IN_PATH, IN_PATH, 40000, 2);
+    std::reverse(ans.begin(), ans.end());
+    EXPECT_EQ(readFile<int>(IN_PATH), ans);
+
+    std::remove(IN_PATH);
+    std::remove(OUT_PATH);
+}
+
+TEST(ExternalSortTest, Records) {
+    Random *random = Random::getInstance();
+    std::vector<Record> records(5000);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        records[i].key = (std::uint64_t)random->nextInt(0, 1000);
+        records[i].id = i;
+        std::fill(records[i].data, records[i].data + 16, (char)i);
+    }
+    writeFile(IN_PATH, records);
+    auto check = [&](const std::vector<Record>& res) {
+        ASSERT_EQ(res.size(), records.size());
+        std::vector<bool> seen(records.size(), false);
+        for (std::size_t i = 0; i < res.size(); ++i) {
+            if (i > 0) {
+                EXPECT_LE(res[i - 1].key, res[i].key);
+            }
+            ASSERT_LT(res[i].id, records.size());
+            EXPECT_FALSE(seen[res[i].id]);
+            seen[res[i].id] = true;
+            EXPECT_EQ(res[i].key, records[res[i].id].key);
+            EXPECT_EQ(res[i].data[15], (char)res[i].id);
+        }
+    };
+
+    // A budget smaller than the blocks of a merge still works
+    for (std::size_t memory : {1, 100, 4096, 100000}) {
+        externalSort<Record>(IN_PATH, OUT_PATH, memory, 8);
+        check(readFile<Record>(OUT_PATH));
+    }
+    ExternalSortStats stats = externalRadixSort<Record>(IN_PATH, OUT_PATH, [](const Record& r) {
+        return r.key;
+    }, 96000, 4);
+    check(readFile<Record>(OUT_PATH));
+    EXPECT_EQ(stats.runs, (std::size_t)5);  // Runs of 96000 / 3 bytes
+
+    std::remove(IN_PATH);
+    std::remove(OUT_PATH);
+}
+
+TEST(ExternalSortTest, Errors) {
+    writeFile(IN_PATH, std::vector<int>());
+    ExternalSortStats stats = externalSort<int>(IN_PATH, OUT_PATH, 1024);
+    EXPECT_EQ(stats.records, (std::size_t)0);
+    EXPECT_TRUE(fileExists(OUT_PATH));
+    EXPECT_TRUE(readFile<int>(OUT_PATH).empty());
+
+    writeFile(IN_PATH, std::vector<char>(7, 'a'));
+    EXPECT_THROW(externalSort<int>(IN_PATH, OUT_PATH, 1024), std::runtime_error);
+    std::remove(IN_PATH);
+    std::remove(OUT_PATH);
+    EXPECT_THROW(externalSort<int>(IN_PATH, OUT_PATH, 1024), std::runtime_error);
+
+    writeFile(IN_PATH, std::vector<int>(1000, 1));
+    EXPECT_THROW(externalSort<int>(IN_PATH, "no_such_dir/out.bin", 1024), std::runtime_error);
+    EXPECT_THROW(externalSort<int>(IN_PATH, "no_such_dir/out.bin", 1 << 20), std::runtime_error);
+    std::remove(IN_PATH);
+}
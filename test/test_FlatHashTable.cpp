@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "tastylib/FlatHashTable.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+
+using tastylib::FlatHashTable;
+
+typedef FlatHashTable<std::string>::SizeType SizeType;
+
+namespace {
+
+// A bad hash function that puts every value into the same probing sequence
+struct ConstHash {
+    SizeType operator()(const int &val) const noexcept {
+        UNUSED(val);
+        return 0;
+    }
+};
+
+}
+
+TEST(FlatHashTableTest, Basic) {
+    FlatHashTable<std::string> table;
+    table.clear();
+    EXPECT_TRUE(table.isEmpty());
+    table.insert("Alice");
+    table.insert("Alice");
+    table.insert("Darth");
+    EXPECT_EQ(table.getSize(), (SizeType)2);
+    EXPECT_TRUE(table.has("Alice"));
+    EXPECT_TRUE(table.has("Darth"));
+    table.remove("Darth");
+    table.remove("Bob");
+    EXPECT_TRUE(table.has("Alice"));
+    EXPECT_FALSE(table.has("Darth"));
+    EXPECT_EQ(table.getSize(), (SizeType)1);
+    table.clear();
+    EXPECT_EQ(table.getSize(), (SizeType)0);
+    EXPECT_FALSE(table.has("Alice"));
+}
+
+TEST(FlatHashTableTest, Rehash) {
+    FlatHashTable<std::string> table(100);
+    for (int i = 0; i < 100; ++i) {
+        table.insert(std::to_string(i));
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)100);
+
+    for (SizeType n : {300, 500, 0}) {
+        table.rehash(n);
+        EXPECT_EQ(table.getSize(), (SizeType)100);
+        bool res = true;
+        for (int i = 0; i < 100; ++i) {
+            if (!table.has(std::to_string(i))) {
+                res = false;
+                break;
+            }
+        }
+        EXPECT_TRUE(res);
+    }
+}
+
+TEST(FlatHashTableTest, Growth) {
+    FlatHashTable<int> table;
+    for (int i = 0; i < 10000; ++i) {
+        table.insert(i);
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)10000);
+    bool res = true;
+    for (int i = 0; i < 20000; ++i) {
+        if (table.has(i) != (i < 10000)) {
+            res = false;
+            break;
+        }
+    }
+    EXPECT_TRUE(res);
+}
+
+TEST(FlatHashTableTest, RemoveAndReinsert) {
+    FlatHashTable<int> table(16);
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            table.insert(round * 10 + i);
+        }
+        for (int i = 0; i < 10; ++i) {
+            table.remove(round * 10 + i);
+        }
+    }
+    EXPECT_TRUE(table.isEmpty());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_FALSE(table.has(i));
+    }
+}
+
+TEST(FlatHashTableTest, Collision) {
+    FlatHashTable<int, std::equal_to<int>, ConstHash> table;
+    for (int i = 0; i < 200; ++i) {
+        table.insert(i);
+    }
+    for (int i = 0; i < 200; i += 2) {
+        table.remove(i);
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)100);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(table.has(i), i % 2 == 1);
+    }
+}
+
+TEST(FlatHashTableTest, Move) {
+    FlatHashTable<std::string> table1;
+    table1.insert("Alice");
+    std::string darth("Darth");
+    table1.insert(std::move(darth));
+
+    FlatHashTable<std::string> table2(std::move(table1));
+    EXPECT_TRUE(table1.isEmpty());
+    EXPECT_FALSE(table1.has("Alice"));
+    EXPECT_TRUE(table2.has("Alice"));
+    EXPECT_TRUE(table2.has("Darth"));
+
+    table1 = std::move(table2);
+    EXPECT_TRUE(table2.isEmpty());
+    EXPECT_TRUE(table1.has("Darth"));
+
+    // A moved-from table is still usable
+    table2.insert("Bob");
+    EXPECT_TRUE(table2.has("Bob"));
+    EXPECT_EQ(table2.getSize(), (SizeType)1);
+}
+
+TEST(FlatHashTableTest, Batch) {
+    std::vector<int> vals;
+    for (int i = 0; i < 1000; ++i) {
+        vals.push_back(i * 2);
+    }
+    vals.push_back(0);  // Duplicated in the same batch
+
+    FlatHashTable<int> table;
+    table.insertBatch(vals.data(), vals.size());
+    EXPECT_EQ(table.getSize(), (SizeType)1000);
+
+    std::vector<int> queries;
+    for (int i = 0; i < 2003; ++i) {
+        queries.push_back(i);
+    }
+    std::unique_ptr<bool[]> res(new bool[queries.size()]);
+    table.hasBatch(queries.data(), queries.size(), res.get());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(res[i], table.has(queries[i]));
+        EXPECT_EQ(res[i], queries[i] < 2000 && queries[i] % 2 == 0);
+    }
+    table.hasBatch(queries.data(), 0, res.get());
+}
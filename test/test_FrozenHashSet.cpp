@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+#include "tastylib/FrozenHashSet.h"
+#include "tastylib/HashTable.h"
+#include "tastylib/FlatHashTable.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+
+using tastylib::FrozenHashSet;
+using tastylib::HashTable;
+using tastylib::FlatHashTable;
+
+typedef FrozenHashSet<std::string>::SizeType SizeType;
+
+namespace {
+
+// A bad hash function that maps every value to the same hash value
+struct ConstHash {
+    SizeType operator()(const int &val) const noexcept {
+        UNUSED(val);
+        return 0;
+    }
+};
+
+// Overwrite a 64-bit field of the header of a snapshot
+void patchHeader(const char *const path, const std::streamoff offset, const std::uint64_t val) {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(offset);
+    f.write((const char*)&val, sizeof(val));
+}
+
+// Offsets of the fields in the header of a snapshot
+const std::streamoff SIZE_OFFSET = 24, SLOT_OFFSET = 32, BUCKET_OFFSET = 40;
+
+}
+
+TEST(FrozenHashSetTest, Basic) {
+    std::string names[] = {"Alice", "Darth", "Alice", "Bob"};
+    FrozenHashSet<std::string> set(names, 4);
+    EXPECT_EQ(set.getSize(), (SizeType)3);
+    EXPECT_TRUE(set.has("Alice"));
+    EXPECT_TRUE(set.has("Darth"));
+    EXPECT_TRUE(set.has("Bob"));
+    EXPECT_FALSE(set.has("Carol"));
+    EXPECT_FALSE(set.has(""));
+
+    std::vector<std::string> vals;
+    set.traverse([&](const std::string& s) {
+        vals.push_back(s);
+    });
+    EXPECT_EQ(vals.size(), (SizeType)3);
+
+    FrozenHashSet<std::string> empty(names, 0);
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_FALSE(empty.has("Alice"));
+}
+
+TEST(FrozenHashSetTest, FromTable) {
+    HashTable<int> table;
+    FlatHashTable<int> flat;
+    for (int i = 0; i < 100000; ++i) {
+        table.insert(i * 3);
+        flat.insert(i * 3);
+    }
+    FrozenHashSet<int> set1(table), set2(flat);
+    EXPECT_EQ(set1.getSize(), (SizeType)100000);
+    EXPECT_EQ(set2.getSize(), (SizeType)100000);
+    for (int i = 0; i < 300000; ++i) {
+        if (set1.has(i) != (i % 3 == 0) || set2.has(i) != (i % 3 == 0)) {
+            FAIL() << "wrong result of has(" << i << ")";
+        }
+    }
+
+    // About 1 byte of overhead per key
+    EXPECT_LE(set1.getSlotCount(), (SizeType)103000);
+    EXPECT_LE(set1.getBucketCount(), (SizeType)25001);
+
+    SizeType cnt = 0;
+    set1.traverse([&](const int val) {
+        EXPECT_EQ(val % 3, 0);
+        ++cnt;
+    });
+    EXPECT_EQ(cnt, (SizeType)100000);
+}
+
+TEST(FrozenHashSetTest, Collision) {
+    int vals[] = {1, 2};
+    EXPECT_THROW((FrozenHashSet<int, std::equal_to<int>, ConstHash>(vals, 2)), std::runtime_error);
+    // Equal values are merged even under a bad hash function
+    int same[] = {1, 1, 1};
+    FrozenHashSet<int, std::equal_to<int>, ConstHash> set(same, 3);
+    EXPECT_EQ(set.getSize(), (SizeType)1);
+    EXPECT_TRUE(set.has(1));
+    EXPECT_FALSE(set.has(2));
+}
+
+TEST(FrozenHashSetTest, Snapshot) {
+    std::vector<int> vals;
+    for (int i = 0; i < 10000; ++i) {
+        vals.push_back(i * 3);
+    }
+    FrozenHashSet<int> set(vals.data(), vals.size());
+    set.save("test_FrozenHashSet_int.snap");
+    {
+        FrozenHashSet<int> loaded = FrozenHashSet<int>::load("test_FrozenHashSet_int.snap");
+#ifdef TASTYLIB_HAS_MMAP
+        EXPECT_TRUE(loaded.isMapped());
+#endif
+        EXPECT_EQ(loaded.getSize(), (SizeType)10000);
+        for (int i = 0; i < 30000; ++i) {
+            if (loaded.has(i) != (i % 3 == 0)) {
+                FAIL() << "wrong result of has(" << i << ")";
+            }
+        }
+        // The mapping moves with the set
+        FrozenHashSet<int> moved(std::move(loaded));
+        EXPECT_TRUE(loaded.isEmpty());
+        EXPECT_FALSE(loaded.has(3));
+        EXPECT_TRUE(moved.has(3));
+    }
+    // A snapshot can't be loaded as another value type
+    EXPECT_THROW(FrozenHashSet<long long>::load("test_FrozenHashSet_int.snap"), std::runtime_error);
+    EXPECT_THROW(FrozenHashSet<std::string>::load("test_FrozenHashSet_int.snap"), std::runtime_error);
+    std::remove("test_FrozenHashSet_int.snap");
+    EXPECT_THROW(FrozenHashSet<int>::load("test_FrozenHashSet_int.snap"), std::runtime_error);
+
+    // Values that are not trivially copyable are copied in
+    std::string names[] = {"Alice", "Darth", ""};
+    FrozenHashSet<std::string> strSet(names, 3);
+    strSet.save("test_FrozenHashSet_str.snap");
+    FrozenHashSet<std::string> strLoaded = FrozenHashSet<std::string>::load("test_FrozenHashSet_str.snap");
+    EXPECT_FALSE(strLoaded.isMapped());
+    EXPECT_EQ(strLoaded.getSize(), (SizeType)3);
+    EXPECT_TRUE(strLoaded.has("Alice"));
+    EXPECT_TRUE(strLoaded.has(""));
+    EXPECT_FALSE(strLoaded.has("Bob"));
+    std::remove("test_FrozenHashSet_str.snap");
+
+    // An empty set
+    FrozenHashSet<int> empty(vals.data(), 0);
+    empty.save("test_FrozenHashSet_empty.snap");
+    EXPECT_FALSE(FrozenHashSet<int>::load("test_FrozenHashSet_empty.snap").has(0));
+    std::remove("test_FrozenHashSet_empty.snap");
+}
+
+TEST(FrozenHashSetTest, CorruptSnapshot) {
+    const char *const INT_PATH = "test_FrozenHashSet_bad_int.snap";
+    const char *const STR_PATH = "test_FrozenHashSet_bad_str.snap";
+    int vals[] = {1, 2, 3};
+    std::string names[] = {"Alice", "Darth", "Bob"};
+    auto reset = [&]() {
+        FrozenHashSet<int>(vals, 3).save(INT_PATH);
+        FrozenHashSet<std::string>(names, 3).save(STR_PATH);
+    };
+    auto expectThrow = [&](const std::streamoff offset, const std::uint64_t val) {
+        reset();
+        patchHeader(INT_PATH, offset, val);
+        patchHeader(STR_PATH, offset, val);
+        EXPECT_THROW(FrozenHashSet<int>::load(INT_PATH), std::runtime_error);
+        EXPECT_THROW(FrozenHashSet<std::string>::load(STR_PATH), std::runtime_error);
+    };
+
+    // One slot would make stepOf() divide by zero
+    reset();
+    patchHeader(INT_PATH, SIZE_OFFSET, 1);
+    patchHeader(INT_PATH, SLOT_OFFSET, 1);
+    patchHeader(INT_PATH, BUCKET_OFFSET, 1);
+    EXPECT_THROW(FrozenHashSet<int>::load(INT_PATH), std::runtime_error);
+    // Amounts whose byte sizes overflow
+    expectThrow(SLOT_OFFSET, (std::uint64_t)1 << 62);
+    expectThrow(SLOT_OFFSET, (std::uint64_t)-1);
+    expectThrow(BUCKET_OFFSET, (std::uint64_t)1 << 63);
+    expectThrow(BUCKET_OFFSET, 1000);
+    // More values than slots
+    expectThrow(SIZE_OFFSET, 1000);
+    // An empty set with slots, which traverse() would scan without buckets
+    reset();
+    patchHeader(INT_PATH, SIZE_OFFSET, 0);
+    patchHeader(INT_PATH, BUCKET_OFFSET, 0);
+    patchHeader(STR_PATH, SIZE_OFFSET, 0);
+    patchHeader(STR_PATH, BUCKET_OFFSET, 0);
+    EXPECT_THROW(FrozenHashSet<int>::load(INT_PATH), std::runtime_error);
+    EXPECT_THROW(FrozenHashSet<std::string>::load(STR_PATH), std::runtime_error);
+
+    // A truncated file
+    reset();
+    std::ifstream in(INT_PATH, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream(INT_PATH, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 1);
+    EXPECT_THROW(FrozenHashSet<int>::load(INT_PATH), std::runtime_error);
+
+    std::remove(INT_PATH);
+    std::remove(STR_PATH);
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "tastylib/HashMap.h"
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+using tastylib::HashMap;
+using tastylib::StringHash;
+using tastylib::StringEqual;
+
+typedef HashMap<std::string, int>::SizeType SizeType;
+
+namespace {
+
+// A key type that counts how many times it is constructed
+struct Name {
+    static int count;
+    std::string str;
+
+    Name(const char *const s) : str(s) { ++count; }
+    Name(const Name& other) : str(other.str) { ++count; }
+    Name(Name&& other) noexcept : str(std::move(other.str)) {}
+};
+
+int Name::count = 0;
+
+struct NameHash {
+    using is_transparent = void;
+    std::size_t operator()(const Name& n) const { return StringHash()(n.str); }
+    std::size_t operator()(const char *const s) const { return StringHash()(s); }
+};
+
+struct NameEqual {
+    using is_transparent = void;
+    bool operator()(const Name& a, const Name& b) const { return a.str == b.str; }
+    bool operator()(const Name& a, const char *const b) const { return a.str == b; }
+};
+
+}
+
+TEST(HashMapTest, Basic) {
+    HashMap<std::string, int> map;
+    EXPECT_TRUE(map.isEmpty());
+    map["Alice"] = 1;
+    map["Darth"] = 2;
+    map["Alice"] += 10;
+    EXPECT_EQ(map.getSize(), (SizeType)2);
+    EXPECT_TRUE(map.has("Alice"));
+    EXPECT_FALSE(map.has("Bob"));
+    EXPECT_EQ(map.at("Alice"), 11);
+    EXPECT_EQ(*map.find("Darth"), 2);
+    EXPECT_EQ(map.find("Bob"), nullptr);
+    EXPECT_THROW(map.at("Bob"), std::out_of_range);
+    map.remove("Darth");
+    map.remove("Bob");
+    EXPECT_FALSE(map.has("Darth"));
+    EXPECT_EQ(map.getSize(), (SizeType)1);
+
+    int sum = 0;
+    map.traverse([&](const std::string& key, int& val) {
+        EXPECT_EQ(key, "Alice");
+        sum += val;
+        val = 0;
+    });
+    EXPECT_EQ(sum, 11);
+    EXPECT_EQ(map.at("Alice"), 0);
+
+    map.clear();
+    EXPECT_TRUE(map.isEmpty());
+}
+
+TEST(HashMapTest, Emplace) {
+    HashMap<std::string, std::string> map;
+    auto r1 = map.emplace("Alice", "Wonderland");
+    EXPECT_TRUE(r1.second);
+    EXPECT_EQ(*r1.first, "Wonderland");
+    auto r2 = map.emplace("Alice", "Elsewhere");
+    EXPECT_FALSE(r2.second);
+    EXPECT_EQ(*r2.first, "Wonderland");
+
+    auto r3 = map.tryEmplace("Darth", 3, 'x');
+    EXPECT_TRUE(r3.second);
+    EXPECT_EQ(*r3.first, "xxx");
+    auto r4 = map.tryEmplace("Darth", 5, 'y');
+    EXPECT_FALSE(r4.second);
+    EXPECT_EQ(*r4.first, "xxx");
+    EXPECT_EQ(map.getSize(), (SizeType)2);
+}
+
+TEST(HashMapTest, Move) {
+    HashMap<std::string, std::unique_ptr<int>> map;
+    std::string key("Alice");
+    std::unique_ptr<int> val(new int(42));
+    map.tryEmplace(std::move(key), std::move(val));
+    EXPECT_EQ(val, nullptr);
+    EXPECT_EQ(*map.at("Alice"), 42);
+
+    // The mapped values survive growing
+    for (int i = 0; i < 1000; ++i) {
+        map.tryEmplace(std::to_string(i), std::unique_ptr<int>(new int(i)));
+    }
+    EXPECT_EQ(map.getSize(), (SizeType)1001);
+    EXPECT_EQ(*map.at("Alice"), 42);
+    EXPECT_EQ(*map.at("999"), 999);
+
+    HashMap<std::string, std::unique_ptr<int>> other(std::move(map));
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(*other.at("500"), 500);
+}
+
+TEST(HashMapTest, Transparent) {
+    HashMap<std::string, int, StringEqual, StringHash> map;
+    map.tryEmplace("Alice", 1);
+    const char *alice = "Alice";
+    EXPECT_TRUE(map.has(alice));
+    EXPECT_TRUE(map.has(std::string("Alice")));
+    EXPECT_EQ(map.at(alice), 1);
+    map.remove(alice);
+    EXPECT_TRUE(map.isEmpty());
+
+    HashMap<Name, int, NameEqual, NameHash> names;
+    names.tryEmplace("Alice", 1);
+    names.tryEmplace("Darth", 2);
+    const int count = Name::count;
+    // Lookups with C strings build no Name
+    EXPECT_TRUE(names.has("Alice"));
+    EXPECT_FALSE(names.has("Bob"));
+    EXPECT_EQ(*names.find("Darth"), 2);
+    names.tryEmplace("Darth", 3);
+    EXPECT_EQ(Name::count, count);
+}
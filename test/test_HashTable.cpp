@@ -1,8 +1,12 @@
 #include "gtest/gtest.h"
 #include "tastylib/HashTable.h"
 #include <string>
+#include <vector>
+#include <memory>
+#include <cctype>
 
 using tastylib::HashTable;
+using tastylib::HashTableStats;
 
 typedef HashTable<std::string>::SizeType SizeType;
 
@@ -58,3 +62,243 @@ TEST(HashTableTest, Rehash) {
         EXPECT_TRUE(res);
     }
 }
+
+TEST(HashTableTest, Growth) {
+    HashTable<int> table;
+    EXPECT_EQ(table.getBucketCount(), (SizeType)8);
+    for (int i = 0; i < 1000; ++i) {
+        table.insert(i);
+    }
+    EXPECT_EQ(table.getSize(), (SizeType)1000);
+    EXPECT_EQ(table.getBucketCount(), (SizeType)1024);
+    EXPECT_LE(table.getLoadFactor(), table.getMaxLoadFactor());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(table.has(i));
+    }
+
+    // Fixed amount of buckets
+    HashTable<int> fixed;
+    fixed.setMaxLoadFactor(0);
+    for (int i = 0; i < 1000; ++i) {
+        fixed.insert(i);
+    }
+    EXPECT_EQ(fixed.getBucketCount(), (SizeType)8);
+    EXPECT_EQ(fixed.getSize(), (SizeType)1000);
+}
+
+TEST(HashTableTest, IncrementalRehash) {
+    HashTable<int> table;
+    table.setMaxLoadFactor(2.0f);
+    table.setIncrementalRehash(true);
+    bool rehashed = false;
+    for (int i = 0; i < 5000; ++i) {
+        table.insert(i);
+        if (table.isRehashing()) {
+            rehashed = true;
+            // Every element is visible in the middle of a rehash
+            bool res = true;
+            for (int j = 0; j <= i; ++j) {
+                if (!table.has(j)) {
+                    res = false;
+                    break;
+                }
+            }
+            EXPECT_TRUE(res);
+            EXPECT_FALSE(table.has(i + 1));
+        }
+    }
+    EXPECT_TRUE(rehashed);
+    EXPECT_EQ(table.getSize(), (SizeType)5000);
+    EXPECT_LE(table.getLoadFactor(), table.getMaxLoadFactor());
+
+    // Remove elements while rehashing
+    for (int i = 5000; table.getSize() < 10000 && !table.isRehashing(); ++i) {
+        table.insert(i);
+    }
+    EXPECT_TRUE(table.isRehashing());
+    for (int i = 0; i < 5000; ++i) {
+        table.remove(i);
+    }
+    EXPECT_FALSE(table.isRehashing());
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_FALSE(table.has(i));
+    }
+
+    // Disabling the mode finishes the rehash
+    while (!table.isRehashing()) {
+        table.insert((int)table.getSize() + 5000);
+    }
+    table.setIncrementalRehash(false);
+    EXPECT_FALSE(table.isRehashing());
+
+    table.clear();
+    EXPECT_TRUE(table.isEmpty());
+    EXPECT_FALSE(table.has(5000));
+}
+
+TEST(HashTableTest, PredCmp) {
+    struct CaseInsensitiveEqual {
+        bool operator()(const std::string& a, const std::string& b) const {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(a[i]) != std::tolower(b[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+    struct CaseInsensitiveHash {
+        std::size_t operator()(const std::string& s) const {
+            std::string lower(s);
+            for (auto &c : lower) {
+                c = (char)std::tolower(c);
+            }
+            return std::hash<std::string>()(lower);
+        }
+    };
+    HashTable<std::string, CaseInsensitiveEqual, CaseInsensitiveHash> table;
+    table.insert("Alice");
+    table.insert("ALICE");
+    EXPECT_EQ(table.getSize(), (SizeType)1);
+    EXPECT_TRUE(table.has("alice"));
+    table.remove("aLiCe");
+    EXPECT_TRUE(table.isEmpty());
+}
+
+TEST(HashTableTest, Batch) {
+    std::vector<int> vals;
+    for (int i = 0; i < 1000; ++i) {
+        vals.push_back(i * 2);
+    }
+    vals.push_back(0);  // Duplicated in the same batch
+
+    HashTable<int> table;
+    table.setIncrementalRehash(true);
+    table.insertBatch(vals.data(), vals.size());
+    EXPECT_EQ(table.getSize(), (SizeType)1000);
+
+    std::vector<int> queries;
+    for (int i = 0; i < 2003; ++i) {
+        queries.push_back(i);
+    }
+    std::unique_ptr<bool[]> res(new bool[queries.size()]);
+    table.hasBatch(queries.data(), queries.size(), res.get());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(res[i], table.has(queries[i]));
+        EXPECT_EQ(res[i], queries[i] < 2000 && queries[i] % 2 == 0);
+    }
+    table.hasBatch(queries.data(), 0, res.get());
+}
+
+TEST(HashTableTest, Stats) {
+    // A hash function that puts the values 0, 8, 16... into the same bucket
+    struct ModHash {
+        std::size_t operator()(const int val) const {
+            return (std::size_t)val;
+        }
+    };
+    HashTable<int, std::equal_to<int>, ModHash, true> table(8);
+    table.setMaxLoadFactor(0);
+    for (int i = 0; i < 4; ++i) {
+        table.insert(i * 8);
+    }
+    table.insert(1);
+
+    HashTableStats stats = table.getStats();
+    EXPECT_EQ(stats.longestChain, (SizeType)4);
+    ASSERT_EQ(stats.histogram.size(), (SizeType)5);
+    EXPECT_EQ(stats.histogram[0], (SizeType)6);
+    EXPECT_EQ(stats.histogram[1], (SizeType)1);
+    EXPECT_EQ(stats.histogram[4], (SizeType)1);
+    EXPECT_EQ(stats.hits, (SizeType)0);
+
+    EXPECT_TRUE(table.has(0));    // 1 probe
+    EXPECT_TRUE(table.has(24));   // 4 probes
+    EXPECT_FALSE(table.has(32));  // 4 probes
+    EXPECT_FALSE(table.has(2));   // 0 probes
+    stats = table.getStats();
+    EXPECT_EQ(stats.hits, (SizeType)2);
+    EXPECT_EQ(stats.misses, (SizeType)2);
+    EXPECT_DOUBLE_EQ(stats.avgProbesHit, 2.5);
+    EXPECT_DOUBLE_EQ(stats.avgProbesMiss, 2.0);
+    EXPECT_EQ(stats.rehashCount, (SizeType)0);
+
+    table.setMaxLoadFactor(1.0f);
+    for (int i = 100; i < 200; ++i) {
+        table.insert(i);
+    }
+    stats = table.getStats();
+    EXPECT_EQ(stats.rehashCount, (SizeType)4);  // 8 -> 128 buckets
+    EXPECT_GE(stats.rehashTime, 0.0);
+    table.resetStats();
+    stats = table.getStats();
+    EXPECT_EQ(stats.hits, (SizeType)0);
+    EXPECT_EQ(stats.rehashCount, (SizeType)0);
+
+    // Tables without counters still report the buckets
+    HashTable<int> plain;
+    plain.insert(1);
+    plain.has(1);
+    stats = plain.getStats();
+    EXPECT_EQ(stats.longestChain, (SizeType)1);
+    EXPECT_EQ(stats.hits, (SizeType)0);
+}
+
+namespace {
+
+int hashCalls = 0;
+int cmpCalls = 0;
+
+struct CountingHash {
+    std::size_t operator()(const int val) const {
+        ++hashCalls;
+        return (std::size_t)val;
+    }
+};
+
+struct CountingEqual {
+    bool operator()(const int a, const int b) const {
+        ++cmpCalls;
+        return a == b;
+    }
+};
+
+}
+
+TEST(HashTableTest, CacheHash) {
+    HashTable<int, CountingEqual, CountingHash, false, true> cached;
+    HashTable<int, CountingEqual, CountingHash> plain;
+
+    // Rehashing reuses the cached hash values
+    hashCalls = 0;
+    for (int i = 0; i < 1000; ++i) {
+        cached.insert(i);
+    }
+    EXPECT_EQ(hashCalls, 1000);
+    hashCalls = 0;
+    for (int i = 0; i < 1000; ++i) {
+        plain.insert(i);
+    }
+    EXPECT_GT(hashCalls, 1000);
+    EXPECT_EQ(cached.getBucketCount(), plain.getBucketCount());
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_EQ(cached.has(i), i < 1000);
+    }
+
+    // Lookups skip the elements with other hash values
+    HashTable<int, CountingEqual, CountingHash, false, true> bucket(8);
+    bucket.setMaxLoadFactor(0);
+    for (int i = 0; i < 4; ++i) {
+        bucket.insert(i * 8);  // All in bucket 0
+    }
+    cmpCalls = 0;
+    EXPECT_TRUE(bucket.has(24));
+    EXPECT_FALSE(bucket.has(32));
+    EXPECT_EQ(cmpCalls, 1);
+    bucket.remove(16);
+    EXPECT_FALSE(bucket.has(16));
+    EXPECT_EQ(bucket.getSize(), (SizeType)3);
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "tastylib/util/random.h"
+#include "tastylib/MultiQueue.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using tastylib::Random;
+using tastylib::MultiQueue;
+
+typedef MultiQueue<int>::SizeType SizeType;
+
+TEST(MultiQueueTest, Basic) {
+    // One heap makes an exact priority queue
+    MultiQueue<int> queue(1, 1);
+    EXPECT_EQ(queue.getHeapCount(), (SizeType)1);
+    EXPECT_TRUE(queue.isEmpty());
+    queue.push(50);
+    queue.push(20);
+    queue.push(30);
+    EXPECT_EQ(queue.getSize(), (SizeType)3);
+    int val = 0;
+    EXPECT_TRUE(queue.tryPop(val));
+    EXPECT_EQ(val, 20);
+    EXPECT_TRUE(queue.tryPop(val));
+    EXPECT_EQ(val, 30);
+    EXPECT_TRUE(queue.tryPop(val));
+    EXPECT_EQ(val, 50);
+    EXPECT_FALSE(queue.tryPop(val));
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(MultiQueueTest, Relaxed) {
+    const int SIZE = 10000;
+    MultiQueue<int, std::greater<int>> queue(4, 2, 4);
+    EXPECT_EQ(queue.getHeapCount(), (SizeType)8);
+    std::vector<int> vals;
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(i);
+    }
+    Random::getInstance()->shuffle(vals.begin(), vals.end());
+    for (const auto &x : vals) {
+        queue.push(x);
+    }
+    // The elements come out roughly from the largest one
+    std::vector<int> popped;
+    int val = 0;
+    while (queue.tryPop(val)) {
+        popped.push_back(val);
+    }
+    EXPECT_EQ(popped.size(), (std::size_t)SIZE);
+    EXPECT_GT(popped.front(), SIZE - 100);
+    EXPECT_LT(popped.back(), 100);
+    std::sort(popped.begin(), popped.end());
+    for (int i = 0; i < SIZE; ++i) {
+        EXPECT_EQ(popped[i], i);
+    }
+}
+
+TEST(MultiQueueTest, Threads) {
+    const int THREADS = 4;
+    const int SIZE = 20000;
+    MultiQueue<int> queue(THREADS);
+    std::vector<std::vector<int>> popped(THREADS);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < THREADS; ++t) {
+        pool.push_back(std::thread([&, t]() {
+            // Each thread pushes its own values and pops as many values
+            for (int i = t; i < SIZE; i += THREADS) {
+                queue.push(i);
+                int val = 0;
+                if (i % 2 && queue.tryPop(val)) {
+                    popped[t].push_back(val);
+                }
+            }
+        }));
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+    std::vector<int> all;
+    for (const auto &p : popped) {
+        all.insert(all.end(), p.begin(), p.end());
+    }
+    int val = 0;
+    while (queue.tryPop(val)) {
+        all.push_back(val);
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(all.size(), (std::size_t)SIZE);
+    for (int i = 0; i < SIZE && i < (int)all.size(); ++i) {
+        EXPECT_EQ(all[i], i);
+    }
+}
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include "tastylib/util/random.h"
+#include "tastylib/PairingHeap.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using tastylib::Random;
+using tastylib::PairingHeap;
+
+typedef PairingHeap<int>::SizeType SizeType;
+
+TEST(PairingHeapTest, Basic) {
+    PairingHeap<int> heap;
+    EXPECT_TRUE(heap.isEmpty());
+    EXPECT_EQ(heap.getSize(), (SizeType)0);
+    heap.push(50);
+    heap.push(20);
+    heap.push(30);
+    EXPECT_FALSE(heap.isEmpty());
+    EXPECT_EQ(heap.getSize(), (SizeType)3);
+    EXPECT_EQ(heap.top(), 20);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 30);
+    heap.pop();
+    EXPECT_EQ(heap.top(), 50);
+    EXPECT_EQ(heap.getSize(), (SizeType)1);
+    heap.pop();
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(PairingHeapTest, MaxRoot) {
+    const int SIZE = 1000;
+    std::vector<int> vals;
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(i);
+    }
+    Random::getInstance()->shuffle(vals.begin(), vals.end());
+    PairingHeap<int, std::greater<int>> heap;
+    for (const auto &x : vals) {
+        heap.push(x);
+    }
+    for (int i = SIZE - 1; i >= 0; --i) {
+        EXPECT_EQ(heap.popValue(), i);
+    }
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(PairingHeapTest, DecreaseKey) {
+    const int SIZE = 1000;
+    Random *random = Random::getInstance();
+    PairingHeap<int> heap;
+    std::vector<PairingHeap<int>::Handle> handles;
+    std::vector<int> vals;
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(random->nextInt(0, SIZE));
+        handles.push_back(heap.push(vals[i]));
+    }
+    // Pop some elements so that the tree has a deep structure
+    std::vector<bool> popped(SIZE, false);
+    for (int i = 0; i < SIZE / 10; ++i) {
+        // The values may repeat, so find the popped handle by the address of the top
+        int h = 0;
+        while (popped[h] || &heap.get(handles[h]) != &heap.top()) {
+            ++h;
+        }
+        EXPECT_EQ(heap.top(), *std::min_element(vals.begin(), vals.end()));
+        EXPECT_EQ(heap.top(), vals[h]);
+        heap.pop();
+        popped[h] = true;
+        vals[h] = SIZE * 2;
+    }
+    for (int i = 0; i < SIZE; ++i) {
+        if (!popped[i] && i % 2 == 0) {
+            vals[i] -= random->nextInt(0, SIZE);
+            heap.decreaseKey(handles[i], vals[i]);
+            EXPECT_EQ(heap.get(handles[i]), vals[i]);
+        }
+    }
+    std::vector<int> ans;
+    for (int i = 0; i < SIZE; ++i) {
+        if (!popped[i]) {
+            ans.push_back(vals[i]);
+        }
+    }
+    std::sort(ans.begin(), ans.end());
+    EXPECT_EQ(heap.getSize(), ans.size());
+    for (const auto &x : ans) {
+        EXPECT_EQ(heap.popValue(), x);
+    }
+    EXPECT_TRUE(heap.isEmpty());
+}
+
+TEST(PairingHeapTest, Meld) {
+    const int HEAPS = 8, SIZE = 1000;
+    Random *random = Random::getInstance();
+    std::vector<PairingHeap<int>> heaps(HEAPS);
+    std::vector<int> ans;
+    std::vector<PairingHeap<int>::Handle> handles;
+    for (int i = 0; i < HEAPS * SIZE; ++i) {
+        ans.push_back(random->nextInt(0, HEAPS * SIZE));
+        handles.push_back(heaps[i % HEAPS].push(ans[i]));
+    }
+    for (int i = 1; i < HEAPS; ++i) {
+        heaps[0].meld(heaps[i]);
+        EXPECT_TRUE(heaps[i].isEmpty());
+    }
+    heaps[0].meld(heaps[0]);
+    EXPECT_EQ(heaps[0].getSize(), (SizeType)(HEAPS * SIZE));
+    // The handles of the melded heaps refer to the elements in heap 0
+    heaps[0].decreaseKey(handles.back(), -1);
+    ans.back() = -1;
+    // The melded heaps can be used again
+    heaps[1].push(5);
+    EXPECT_EQ(heaps[1].popValue(), 5);
+    std::sort(ans.begin(), ans.end());
+    for (const auto &x : ans) {
+        EXPECT_EQ(heaps[0].popValue(), x);
+    }
+    EXPECT_TRUE(heaps[0].isEmpty());
+}
+
+TEST(PairingHeapTest, Move) {
+    struct Less {
+        bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const {
+            return *a < *b;
+        }
+    };
+    PairingHeap<std::unique_ptr<int>, Less> heap;
+    for (int i = 9; i >= 0; --i) {
+        heap.push(std::unique_ptr<int>(new int(i)));
+    }
+    PairingHeap<std::unique_ptr<int>, Less> other(std::move(heap));
+    EXPECT_TRUE(heap.isEmpty());
+    EXPECT_EQ(*other.popValue(), 0);
+    heap = std::move(other);
+    EXPECT_EQ(*heap.top(), 1);
+    EXPECT_EQ(heap.getSize(), (SizeType)9);
+    // The dtor releases the remaining elements
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "tastylib/util/random.h"
+#include "tastylib/RadixHeap.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+
+using tastylib::Random;
+using tastylib::RadixHeap;
+
+typedef RadixHeap<unsigned, std::string>::SizeType SizeType;
+
+TEST(RadixHeapTest, Basic) {
+    RadixHeap<unsigned, std::string> heap;
+    EXPECT_TRUE(heap.isEmpty());
+    heap.push(50, "Darth");
+    heap.push(20, "Alice");
+    heap.push(30, "Bob");
+    EXPECT_EQ(heap.getSize(), (SizeType)3);
+    EXPECT_EQ(heap.top().first, 20u);
+    EXPECT_EQ(heap.top().second, "Alice");
+    heap.pop();
+    EXPECT_EQ(heap.getLastKey(), 20u);
+
+    // Keys less than the last removed key are rejected
+    EXPECT_THROW(heap.push(10, "Eve"), std::out_of_range);
+    heap.push(20, "Carol");
+    EXPECT_EQ(heap.top().second, "Carol");
+    heap.pop();
+    EXPECT_EQ(heap.top().second, "Bob");
+    heap.pop();
+    EXPECT_EQ(heap.top().second, "Darth");
+    heap.pop();
+    EXPECT_TRUE(heap.isEmpty());
+
+    heap.clear();
+    heap.push(0, "Zero");
+    EXPECT_EQ(heap.top().first, 0u);
+}
+
+TEST(RadixHeapTest, Signed) {
+    RadixHeap<int, int> heap;
+    EXPECT_THROW(heap.push(-1, 0), std::out_of_range);
+    heap.push(INT32_MAX, 1);
+    heap.push(0, 2);
+    EXPECT_EQ(heap.top().second, 2);
+    heap.pop();
+    EXPECT_EQ(heap.top().first, INT32_MAX);
+}
+
+TEST(RadixHeapTest, Monotone) {
+    Random *random = Random::getInstance();
+    RadixHeap<std::uint64_t, int> heap;
+    std::vector<std::uint64_t> popped;
+    std::vector<std::uint64_t> pushed;
+    std::uint64_t last = 0;
+    // Mix pushes of keys above the last removed key with pops
+    for (int i = 0; i < 10000; ++i) {
+        if (heap.isEmpty() || random->nextInt(0, 2) != 0) {
+            std::uint64_t key = last + (std::uint64_t)random->nextInt(0, 1 << 20);
+            if (random->nextInt(0, 99) == 0) {
+                key += (std::uint64_t)1 << 40;
+            }
+            heap.push(key, i);
+            pushed.push_back(key);
+        } else {
+            last = heap.top().first;
+            popped.push_back(last);
+            heap.pop();
+        }
+    }
+    while (!heap.isEmpty()) {
+        popped.push_back(heap.top().first);
+        heap.pop();
+    }
+    EXPECT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+    std::sort(pushed.begin(), pushed.end());
+    EXPECT_EQ(popped, pushed);
+}
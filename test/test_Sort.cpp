@@ -2,6 +2,13 @@
 #include "tastylib/Sort.h"
 #include "tastylib/util/random.h"
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
 
 using tastylib::Random;
 using tastylib::insertionSort;
@@ -9,6 +16,83 @@ using tastylib::selectionSort;
 using tastylib::heapSort;
 using tastylib::quickSort;
 using tastylib::quickSelect;
+using tastylib::introSort;
+using tastylib::introSelect;
+using tastylib::pdqSort;
+using tastylib::pdqSelect;
+using tastylib::medianOfMediansSelect;
+using tastylib::parallelSort;
+using tastylib::parallelQuickSelect;
+using tastylib::parallelPartition;
+using tastylib::radixSort;
+using tastylib::simdSort;
+using tastylib::timSort;
+using tastylib::gallopUpper;
+using tastylib::gallopLower;
+
+/*
+Build an input that makes a quicksort or quickselect take quadratic time
+with McIlroy's adversary. The adversary decides the order of the elements
+lazily while the algorithm sorts their indices, and counts comparisons.
+*/
+class Adversary {
+public:
+    explicit Adversary(const int n) : val(n, n), gas(n), solid(0), candidate(0), count(0) {}
+
+    // Run an algorithm on the indices 0 to n - 1 and return the input built
+    template<typename Func>
+    std::vector<int> build(const Func& run) {
+        std::vector<int> idx;
+        for (int i = 0; i < (int)val.size(); ++i) {
+            idx.push_back(i);
+        }
+        run(idx.data(), Cmp(this));
+        return val;
+    }
+
+    struct Cmp {
+        Adversary *adv;
+
+        explicit Cmp(Adversary *a) : adv(a) {}
+
+        bool operator()(const int x, const int y) const {
+            return adv->less(x, y);
+        }
+    };
+
+private:
+    bool less(const int x, const int y) {
+        ++count;
+        if (val[x] == gas && val[y] == gas) {
+            val[x == candidate ? x : y] = solid++;
+        }
+        if (val[x] == gas) {
+            candidate = x;
+        } else if (val[y] == gas) {
+            candidate = y;
+        }
+        return val[x] < val[y];
+    }
+
+    std::vector<int> val;
+    int gas;
+    int solid;
+    int candidate;
+
+public:
+    long long count;
+};
+
+// Count the comparisons of an algorithm on an array
+template<typename Func>
+long long countCmp(std::vector<int> arr, const Func& run) {
+    long long count = 0;
+    run(arr.data(), [&count](const int a, const int b) {
+        ++count;
+        return a < b;
+    });
+    return count;
+}
 
 TEST(SortTest, InsertionSort) {
     Random *random = Random::getInstance();
@@ -88,3 +172,536 @@ TEST(SortTest, QuickSelect) {
         EXPECT_EQ(arr1[k], arr2[k]);
     }
 }
+
+TEST(SortTest, IntroSort) {
+    Random *random = Random::getInstance();
+    const int n = 3000;
+    int arr1[n], arr2[n];
+    for (int i = 0; i < n; ++i) {
+        arr1[i] = arr2[i] = random->nextInt(1, 10000);
+    }
+    std::sort(arr1, arr1 + n, std::greater<int>());
+    introSort<int, std::greater<int>>(arr2, 0, n - 1);
+    EXPECT_TRUE(std::is_sorted(arr2, arr2 + n, std::greater<int>()));
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(arr1[i], arr2[i]);
+    }
+    // Sorted, reversed and equal elements
+    for (int i = 0; i < n; ++i) {
+        arr1[i] = i;
+        arr2[i] = 7;
+    }
+    introSort(arr1, 0, n - 1);
+    EXPECT_TRUE(std::is_sorted(arr1, arr1 + n));
+    introSort<int, std::greater<int>>(arr1, 0, n - 1);
+    EXPECT_TRUE(std::is_sorted(arr1, arr1 + n, std::greater<int>()));
+    introSort(arr2, 0, n - 1);
+    EXPECT_EQ(arr2[0], 7);
+    EXPECT_EQ(arr2[n - 1], 7);
+}
+
+TEST(SortTest, IntroSelect) {
+    Random *random = Random::getInstance();
+    const int n = 3000;
+    for (int i = 0; i < 5; ++i) {
+        int arr1[n], arr2[n], arr3[n];
+        for (int j = 0; j < n; ++j) {
+            arr1[j] = arr2[j] = arr3[j] = random->nextInt(1, 100);
+        }
+        unsigned k = random->nextInt(0, n - 1);
+        std::nth_element(arr1, arr1 + k, arr1 + n, std::greater<int>());
+        introSelect<int, std::greater<int>>(arr2, 0, n - 1, k);
+        medianOfMediansSelect<int, std::greater<int>>(arr3, 0, n - 1, k);
+        EXPECT_EQ(arr1[k], arr2[k]);
+        EXPECT_EQ(arr1[k], arr3[k]);
+        for (unsigned j = 0; j < k; ++j) {
+            EXPECT_GE(arr3[j], arr3[k]);
+        }
+        for (unsigned j = k + 1; j < (unsigned)n; ++j) {
+            EXPECT_LE(arr3[j], arr3[k]);
+        }
+    }
+}
+
+TEST(SortTest, Adversary) {
+    const int n = 4000;
+    // An input that drives quickSort() to quadratic time
+    Adversary sortAdv(n);
+    auto killer = sortAdv.build([](int *arr, const Adversary::Cmp& cmp) {
+        quickSort(arr, 0, n - 1, cmp);
+    });
+    EXPECT_GT(sortAdv.count, (long long)n * n / 8);
+    EXPECT_EQ(countCmp(killer, [](int *arr, const std::function<bool(int, int)>& cmp) {
+        quickSort(arr, 0, n - 1, cmp);
+    }), sortAdv.count);
+    // introSort() stays within O(nlogn) comparisons on it
+    auto introCount = countCmp(killer, [](int *arr, const std::function<bool(int, int)>& cmp) {
+        introSort(arr, 0, n - 1, cmp);
+    });
+    EXPECT_LT(introCount, (long long)n * 12 * 4);
+    introSort(killer.data(), 0, n - 1);
+    EXPECT_TRUE(std::is_sorted(killer.begin(), killer.end()));
+
+    // The same for quickSelect() and introSelect()
+    Adversary selectAdv(n);
+    auto selectKiller = selectAdv.build([](int *arr, const Adversary::Cmp& cmp) {
+        quickSelect(arr, 0, n - 1, n / 2, cmp);
+    });
+    EXPECT_GT(selectAdv.count, (long long)n * n / 16);
+    auto selectCount = countCmp(selectKiller, [](int *arr, const std::function<bool(int, int)>& cmp) {
+        introSelect(arr, 0, n - 1, n / 2, cmp);
+    });
+    EXPECT_LT(selectCount, (long long)n * 50);
+    std::vector<int> ans(selectKiller);
+    std::nth_element(ans.begin(), ans.begin() + n / 2, ans.end());
+    introSelect(selectKiller.data(), 0, n - 1, n / 2);
+    EXPECT_EQ(selectKiller[n / 2], ans[n / 2]);
+}
+
+// Sort an input with pdqSort() with and without the block partition
+template<typename Value, typename PredCmp>
+void checkPdq(const std::vector<Value>& input, const PredCmp& cmp) {
+    std::vector<Value> ans(input), arr1(input), arr2(input);
+    std::sort(ans.begin(), ans.end(), cmp);
+    const std::size_t n = input.size();
+    pdqSort<Value, PredCmp, true>(arr1.data(), 0, n - 1, cmp);
+    pdqSort<Value, PredCmp, false>(arr2.data(), 0, n - 1, cmp);
+    EXPECT_EQ(arr1, ans);
+    EXPECT_EQ(arr2, ans);
+}
+
+TEST(SortTest, PdqSort) {
+    Random *random = Random::getInstance();
+    for (int n : {0, 1, 2, 23, 24, 25, 100, 129, 3000, 100000}) {
+        std::vector<int> rand, sorted, reversed, organ, few, saw;
+        for (int i = 0; i < n; ++i) {
+            rand.push_back(random->nextInt(1, 1000000));
+            sorted.push_back(i);
+            reversed.push_back(n - i);
+            organ.push_back(i < n / 2 ? i : n - i);
+            few.push_back(random->nextInt(1, 10));
+            saw.push_back(i % 1000);
+        }
+        for (const auto& input : {rand, sorted, reversed, organ, few, saw}) {
+            checkPdq(input, std::less<int>());
+            checkPdq(input, std::greater<int>());
+        }
+    }
+    // Non-arithmetic values use the Hoare partition by default
+    std::vector<std::string> strs;
+    for (int i = 0; i < 3000; ++i) {
+        strs.push_back(std::to_string(random->nextInt(1, 500)));
+    }
+    checkPdq(strs, std::less<std::string>());
+    auto ans = strs;
+    std::sort(ans.begin(), ans.end());
+    pdqSort(strs.data(), 0, strs.size() - 1);
+    EXPECT_EQ(strs, ans);
+    // Sort a subarray only
+    std::vector<int> arr{9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    pdqSort(arr.data(), 2, 6);
+    EXPECT_EQ(arr, std::vector<int>({9, 8, 3, 4, 5, 6, 7, 2, 1, 0}));
+}
+
+TEST(SortTest, PdqSelect) {
+    Random *random = Random::getInstance();
+    for (int n : {1, 23, 24, 200, 3000, 100000}) {
+        for (int range : {3, 1000000}) {
+            std::vector<int> arr1, arr2, arr3;
+            for (int i = 0; i < n; ++i) {
+                arr1.push_back(random->nextInt(1, range));
+            }
+            arr2 = arr3 = arr1;
+            const std::size_t k = random->nextInt(0, n - 1);
+            std::nth_element(arr1.begin(), arr1.begin() + k, arr1.end(), std::greater<int>());
+            pdqSelect<int, std::greater<int>, true>(arr2.data(), 0, n - 1, k);
+            pdqSelect<int, std::greater<int>, false>(arr3.data(), 0, n - 1, k);
+            EXPECT_EQ(arr1[k], arr2[k]);
+            EXPECT_EQ(arr1[k], arr3[k]);
+            for (std::size_t i = 0; i < (std::size_t)n; ++i) {
+                EXPECT_TRUE(i < k ? arr2[i] >= arr2[k] : arr2[i] <= arr2[k]);
+                EXPECT_TRUE(i < k ? arr3[i] >= arr3[k] : arr3[i] <= arr3[k]);
+            }
+        }
+    }
+}
+
+TEST(SortTest, PdqAdversary) {
+    const int n = 4000;
+    // The quickSort() killer costs pdqSort() O(nlogn) comparisons
+    Adversary sortAdv(n);
+    auto killer = sortAdv.build([](int *arr, const Adversary::Cmp& cmp) {
+        quickSort(arr, 0, n - 1, cmp);
+    });
+    EXPECT_LT(countCmp(killer, [](int *arr, const std::function<bool(int, int)>& cmp) {
+        pdqSort(arr, 0, n - 1, cmp);
+    }), (long long)n * 12 * 4);
+    // So does an adversary against pdqSort() itself, thanks to the shuffles
+    // and the heapsort fallback
+    Adversary pdqAdv(n);
+    auto pdqKiller = pdqAdv.build([](int *arr, const Adversary::Cmp& cmp) {
+        pdqSort(arr, 0, n - 1, cmp);
+    });
+    EXPECT_LT(pdqAdv.count, (long long)n * 12 * 4);
+    pdqSort(pdqKiller.data(), 0, n - 1);
+    EXPECT_TRUE(std::is_sorted(pdqKiller.begin(), pdqKiller.end()));
+
+    Adversary selectAdv(n);
+    selectAdv.build([](int *arr, const Adversary::Cmp& cmp) {
+        pdqSelect(arr, 0, n - 1, n / 2, cmp);
+    });
+    EXPECT_LT(selectAdv.count, (long long)n * 50);
+}
+
+TEST(SortTest, ParallelSort) {
+    Random *random = Random::getInstance();
+    const int n = 200000;
+    for (std::size_t threads = 1; threads <= 8; threads <<= 1) {
+        std::vector<int> arr1, arr2;
+        for (int i = 0; i < n; ++i) {
+            arr1.push_back(random->nextInt(1, threads < 4 ? 1000000 : 10));
+        }
+        arr2 = arr1;
+        std::sort(arr1.begin(), arr1.end(), std::greater<int>());
+        parallelSort(arr2.data(), n, std::greater<int>(), threads);
+        EXPECT_EQ(arr1, arr2);
+    }
+    // Adversarial inputs fall back to introSort()
+    std::vector<int> arr;
+    for (int i = 0; i < n; ++i) {
+        arr.push_back(i < n / 2 ? i : n - i);
+    }
+    parallelSort(arr.data(), n, std::less<int>(), 4);
+    EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+    parallelSort(arr.data(), 1);
+    parallelSort(arr.data(), 0);
+}
+
+TEST(SortTest, ParallelPartition) {
+    Random *random = Random::getInstance();
+    for (std::size_t threads = 1; threads <= 7; ++threads) {
+        const std::size_t n = random->nextInt(0, 1000);
+        std::vector<int> arr;
+        for (std::size_t i = 0; i < n; ++i) {
+            arr.push_back(random->nextInt(0, 99));
+        }
+        std::vector<int> sorted(arr);
+        std::sort(sorted.begin(), sorted.end());
+        auto isSmall = [](const int x) {
+            return x < 30;
+        };
+        std::size_t cnt = parallelPartition(arr.data(), n, isSmall, threads);
+        EXPECT_EQ(cnt, (std::size_t)std::count_if(arr.begin(), arr.end(), isSmall));
+        EXPECT_TRUE(std::is_partitioned(arr.begin(), arr.end(), isSmall));
+        std::sort(arr.begin(), arr.end());
+        EXPECT_EQ(arr, sorted);
+    }
+}
+
+TEST(SortTest, ParallelQuickSelect) {
+    Random *random = Random::getInstance();
+    const int n = 200000;
+    for (std::size_t threads = 1; threads <= 8; threads <<= 1) {
+        std::vector<int> arr1, arr2;
+        for (int i = 0; i < n; ++i) {
+            arr1.push_back(random->nextInt(1, threads < 4 ? 1000000 : 3));
+        }
+        arr2 = arr1;
+        const std::size_t k = random->nextInt(0, n - 1);
+        std::nth_element(arr1.begin(), arr1.begin() + k, arr1.end(), std::greater<int>());
+        parallelQuickSelect(arr2.data(), n, k, std::greater<int>(), threads);
+        EXPECT_EQ(arr1[k], arr2[k]);
+        for (std::size_t i = 0; i < (std::size_t)n; ++i) {
+            if (i < k) {
+                EXPECT_GE(arr2[i], arr2[k]);
+            } else {
+                EXPECT_LE(arr2[i], arr2[k]);
+            }
+        }
+    }
+}
+
+TEST(SortTest, NetworkSort) {
+    Random *random = Random::getInstance();
+    for (std::size_t n = 0; n <= 32; ++n) {
+        for (int i = 0; i < 20; ++i) {
+            std::vector<std::int32_t> arr;
+            std::vector<float> farr;
+            for (std::size_t j = 0; j < n; ++j) {
+                arr.push_back(random->nextInt(i % 2 ? -3 : -1000000, i % 2 ? 3 : 1000000));
+                farr.push_back((float)arr.back() / 3);
+            }
+            if (n > 0 && i == 0) {
+                arr[0] = std::numeric_limits<std::int32_t>::max();
+                farr[0] = std::numeric_limits<float>::infinity();
+            }
+            auto ans = arr;
+            auto fans = farr;
+            std::sort(ans.begin(), ans.end());
+            std::sort(fans.begin(), fans.end());
+            tastylib::networkSort(arr.data(), n);
+            tastylib::networkSort(farr.data(), n);
+            EXPECT_EQ(arr, ans);
+            EXPECT_EQ(farr, fans);
+        }
+    }
+}
+
+TEST(SortTest, SimdSort) {
+    Random *random = Random::getInstance();
+    for (int n : {0, 1, 31, 32, 33, 64, 100, 1000, 4096, 100003}) {
+        std::vector<std::int32_t> arr;
+        std::vector<float> farr;
+        for (int i = 0; i < n; ++i) {
+            arr.push_back(random->nextInt(std::numeric_limits<std::int32_t>::min(),
+                                          std::numeric_limits<std::int32_t>::max()));
+            farr.push_back((float)random->nextInt(-1000, 1000) / 7);
+        }
+        auto ans = arr;
+        auto fans = farr;
+        std::sort(ans.begin(), ans.end());
+        std::sort(fans.begin(), fans.end());
+        simdSort(arr.data(), n);
+        simdSort(farr.data(), n);
+        EXPECT_EQ(arr, ans);
+        EXPECT_EQ(farr, fans);
+        // Sorted, reversed and few unique keys
+        for (int i = 0; i < n; ++i) {
+            arr[i] = n - i;
+        }
+        simdSort(arr.data(), n);
+        EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+        simdSort(arr.data(), n);
+        EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+        for (int i = 0; i < n; ++i) {
+            arr[i] = i % 3;
+        }
+        simdSort(arr.data(), n);
+        EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+        EXPECT_EQ(std::count(arr.begin(), arr.end(), 1), (n + 1) / 3);
+    }
+    // Keys that compare equal are kept, e.g. -0.0f and 0.0f
+    std::vector<float> zeros;
+    for (int i = 0; i < 1000; ++i) {
+        zeros.push_back(i % 2 ? -0.0f : 0.0f);
+    }
+    simdSort(zeros.data(), zeros.size());
+    EXPECT_EQ(std::count_if(zeros.begin(), zeros.end(), [](const float x) {
+        return std::signbit(x);
+    }), 500);
+    std::vector<float> fsmall(zeros.begin(), zeros.begin() + 20);
+    quickSort(fsmall.data(), 0, fsmall.size() - 1);
+    EXPECT_EQ(std::count_if(fsmall.begin(), fsmall.end(), [](const float x) {
+        return std::signbit(x);
+    }), 10);
+}
+
+TEST(SortTest, QuickSortNetwork) {
+    Random *random = Random::getInstance();
+    for (int n : {1, 10, 11, 32, 33, 3000}) {
+        std::vector<float> farr, fans;
+        std::vector<int> arr, ans;
+        for (int i = 0; i < n; ++i) {
+            arr.push_back(random->nextInt(-1000, 1000));
+            farr.push_back((float)arr.back() / 7);
+        }
+        fans = farr;
+        ans = arr;
+        std::sort(fans.begin(), fans.end());
+        std::sort(ans.begin(), ans.end(), std::greater<int>());
+        quickSort(farr.data(), 0, n - 1);
+        quickSort<int, std::greater<int>>(arr.data(), 0, n - 1);
+        EXPECT_EQ(farr, fans);
+        EXPECT_EQ(arr, ans);
+    }
+}
+
+// Sort a copy of an array with std::sort() and radixSort(), and compare them
+template<typename Value>
+void checkRadix(std::vector<Value> arr) {
+    std::vector<Value> ans(arr);
+    std::sort(ans.begin(), ans.end());
+    radixSort(arr.data(), arr.size());
+    EXPECT_EQ(arr, ans);
+}
+
+TEST(SortTest, RadixSortNumbers) {
+    Random *random = Random::getInstance();
+    for (int n : {0, 1, 50, 3000}) {
+        std::vector<unsigned> u;
+        std::vector<int> i32;
+        std::vector<std::int64_t> i64;
+        std::vector<std::uint8_t> u8;
+        std::vector<short> i16;
+        std::vector<float> f;
+        std::vector<double> d;
+        for (int i = 0; i < n; ++i) {
+            u.push_back((unsigned)random->nextInt(0, 1 << 30) * 3);
+            i32.push_back(random->nextInt(-100000, 100000));
+            i64.push_back((std::int64_t)random->nextInt(-1000, 1000) * ((std::int64_t)1 << 40) + random->nextInt(0, 100));
+            u8.push_back((std::uint8_t)random->nextInt(0, 255));
+            i16.push_back((short)random->nextInt(-30000, 30000));
+            f.push_back((float)random->nextInt(-1000, 1000) / 7);
+            d.push_back((double)random->nextInt(-1000000, 1000000) / 13);
+        }
+        checkRadix(u);
+        checkRadix(i32);
+        checkRadix(i64);
+        checkRadix(u8);
+        checkRadix(i16);
+        checkRadix(f);
+        checkRadix(d);
+    }
+    checkRadix(std::vector<int>{std::numeric_limits<int>::max(), -1, 0, std::numeric_limits<int>::min(), 1});
+    checkRadix(std::vector<double>{2.5, -0.5, std::numeric_limits<double>::infinity(), 0.0,
+                                   -std::numeric_limits<double>::infinity(), -3.0, 1e-300});
+    // All keys are the same
+    checkRadix(std::vector<int>(1000, 42));
+}
+
+TEST(SortTest, RadixSortKeyOf) {
+    Random *random = Random::getInstance();
+    const int n = 3000;
+    std::vector<std::pair<int, int>> arr;
+    for (int i = 0; i < n; ++i) {
+        arr.push_back(std::make_pair(random->nextInt(-50, 50), i));
+    }
+    std::vector<std::pair<int, int>> ans(arr);
+    std::stable_sort(ans.begin(), ans.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first < b.first;
+    });
+    // The LSD radix sort is stable
+    radixSort(arr.data(), n, [](const std::pair<int, int>& p) {
+        return p.first;
+    });
+    EXPECT_EQ(arr, ans);
+}
+
+TEST(SortTest, RadixSortStrings) {
+    Random *random = Random::getInstance();
+    const int n = 3000;
+    std::vector<std::string> strs;
+    for (int i = 0; i < n; ++i) {
+        // Short alphabets and common prefixes make many equal characters
+        std::string str = i % 3 ? "prefix/" : "";
+        const int len = random->nextInt(0, 6);
+        for (int j = 0; j < len; ++j) {
+            str.push_back((char)random->nextInt('a', 'c'));
+        }
+        if (i % 100 == 0) {
+            str.push_back((char)200);  // Non-ASCII characters are sorted as unsigned
+        }
+        strs.push_back(str);
+    }
+    checkRadix(strs);
+    checkRadix(std::vector<std::string>(100, "same"));
+
+    // Keys that are prefixes of each other must not recurse once per key
+    std::vector<std::string> nested;
+    for (int i = 0; i < 5000; ++i) {
+        nested.push_back(std::string(i, 'a'));
+    }
+    random->shuffle(nested.begin(), nested.end());
+    checkRadix(nested);
+
+    std::vector<std::pair<std::string, int>> records;
+    for (int i = 0; i < n; ++i) {
+        records.push_back(std::make_pair(strs[i], i));
+    }
+    radixSort(records.data(), n, [](const std::pair<std::string, int>& r) -> const std::string& {
+        return r.first;
+    });
+    std::sort(strs.begin(), strs.end());
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(records[i].first, strs[i]);
+    }
+}
+
+// Sort pairs by their first elements with timSort(), which must be stable.
+// The string payloads would be lost if an element were moved onto itself.
+void checkTim(std::vector<std::pair<int, std::string>> arr, const std::size_t maxBuffer) {
+    auto cmp = [](const std::pair<int, std::string>& a, const std::pair<int, std::string>& b) {
+        return a.first < b.first;
+    };
+    auto ans = arr;
+    std::stable_sort(ans.begin(), ans.end(), cmp);
+    timSort(arr.data(), arr.size(), cmp, maxBuffer);
+    EXPECT_EQ(arr, ans);
+}
+
+TEST(SortTest, TimSort) {
+    Random *random = Random::getInstance();
+    for (int n : {0, 1, 2, 31, 32, 33, 1000, 100000}) {
+        std::vector<std::pair<int, std::string>> rand, sorted, reversed, saw, few, appended;
+        for (int i = 0; i < n; ++i) {
+            rand.push_back(std::make_pair(random->nextInt(1, 1000000), std::to_string(i)));
+            sorted.push_back(std::make_pair(i, std::to_string(i)));
+            reversed.push_back(std::make_pair(n - i, std::to_string(i)));
+            saw.push_back(std::make_pair(i % 1000, std::to_string(i)));
+            few.push_back(std::make_pair(random->nextInt(1, 5), std::to_string(i)));
+            appended.push_back(std::make_pair(i < n - n / 10 ? i : random->nextInt(0, n), std::to_string(i)));
+        }
+        for (const auto& input : {rand, sorted, reversed, saw, few, appended}) {
+            checkTim(input, (std::size_t)-1);
+            checkTim(input, 16);
+            checkTim(input, 0);
+        }
+    }
+    std::vector<std::string> strs;
+    for (int i = 0; i < 3000; ++i) {
+        strs.push_back(std::to_string(random->nextInt(1, 500)));
+    }
+    auto ans = strs;
+    std::sort(ans.begin(), ans.end());
+    timSort(strs.data(), strs.size());
+    EXPECT_EQ(strs, ans);
+    timSort(strs.data(), strs.size(), std::greater<std::string>());
+    std::reverse(ans.begin(), ans.end());
+    EXPECT_EQ(strs, ans);
+}
+
+TEST(SortTest, TimSortAdaptive) {
+    const int n = 100000;
+    std::size_t cnt = 0;
+    auto cmp = [&cnt](const int a, const int b) {
+        ++cnt;
+        return a < b;
+    };
+    std::vector<int> arr;
+    for (int i = 0; i < n; ++i) {
+        arr.push_back(i);
+    }
+    // One run costs a single pass
+    timSort(arr.data(), n, cmp);
+    EXPECT_EQ(cnt, (std::size_t)n - 1);
+    std::reverse(arr.begin(), arr.end());
+    cnt = 0;
+    timSort(arr.data(), n, cmp);
+    EXPECT_EQ(cnt, (std::size_t)n - 1);
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(arr[i], i);
+    }
+    // Two interleaved blocks are merged by galloping
+    std::vector<int> blocks;
+    for (int i = 0; i < n; ++i) {
+        blocks.push_back(i < n / 2 ? (i / 1000) * 2000 + i % 1000
+                                   : ((i - n / 2) / 1000) * 2000 + 1000 + i % 1000);
+    }
+    cnt = 0;
+    timSort(blocks.data(), n, cmp);
+    EXPECT_LT(cnt, (std::size_t)n * 2);
+    EXPECT_TRUE(std::is_sorted(blocks.begin(), blocks.end()));
+}
+
+TEST(SortTest, Gallop) {
+    std::vector<int> arr{1, 2, 2, 2, 3, 5, 5, 8, 9, 9, 9, 9, 10};
+    const std::size_t n = arr.size();
+    for (int key = 0; key <= 11; ++key) {
+        EXPECT_EQ(gallopUpper(arr.begin(), n, key, std::less<int>()),
+                  (std::size_t)(std::upper_bound(arr.begin(), arr.end(), key) - arr.begin()));
+        EXPECT_EQ(gallopLower(arr.begin(), n, key, std::less<int>()),
+                  (std::size_t)(std::lower_bound(arr.begin(), arr.end(), key) - arr.begin()));
+    }
+    EXPECT_EQ(gallopUpper(arr.begin(), 0, 5, std::less<int>()), (std::size_t)0);
+    EXPECT_EQ(gallopLower(arr.begin(), 0, 5, std::less<int>()), (std::size_t)0);
+}
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "tastylib/util/random.h"
+#include "tastylib/TopK.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using tastylib::Random;
+using tastylib::TopK;
+
+typedef TopK<int>::SizeType SizeType;
+
+TEST(TopKTest, Basic) {
+    TopK<int> topk(3);
+    EXPECT_EQ(topk.getCapacity(), (SizeType)3);
+    EXPECT_EQ(topk.getSize(), (SizeType)0);
+    EXPECT_TRUE(topk.push(5));
+    EXPECT_TRUE(topk.push(1));
+    EXPECT_TRUE(topk.push(3));
+    EXPECT_TRUE(topk.isFull());
+    EXPECT_EQ(topk.getThreshold(), 1);
+    EXPECT_FALSE(topk.push(0));
+    EXPECT_FALSE(topk.push(1));  // Not better than the threshold
+    EXPECT_TRUE(topk.push(4));
+    EXPECT_EQ(topk.getThreshold(), 3);
+    EXPECT_EQ(topk.getSize(), (SizeType)3);
+    std::vector<int> ans = {5, 4, 3};
+    EXPECT_EQ(topk.takeSorted(), ans);
+    EXPECT_EQ(topk.getSize(), (SizeType)0);
+
+    TopK<int> none(0);
+    EXPECT_FALSE(none.push(1));
+    EXPECT_EQ(none.getSize(), (SizeType)0);
+}
+
+TEST(TopKTest, Smallest) {
+    const int SIZE = 1000, K = 50;
+    std::vector<int> vals;
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(i);
+    }
+    Random::getInstance()->shuffle(vals.begin(), vals.end());
+    TopK<int, std::less<int>> topk(K);
+    for (const auto &x : vals) {
+        topk.push(x);
+    }
+    EXPECT_EQ(topk.getThreshold(), K - 1);
+    auto res = topk.takeSorted();
+    EXPECT_EQ(res.size(), (std::size_t)K);
+    for (int i = 0; i < K; ++i) {
+        EXPECT_EQ(res[i], i);
+    }
+}
+
+TEST(TopKTest, Move) {
+    struct Greater {
+        bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const {
+            return *a > *b;
+        }
+    };
+    TopK<std::unique_ptr<int>, Greater> topk(2);
+    for (int i = 0; i < 10; ++i) {
+        topk.push(std::unique_ptr<int>(new int(i)));
+    }
+    auto res = topk.takeSorted();
+    EXPECT_EQ(res.size(), (std::size_t)2);
+    EXPECT_EQ(*res[0], 9);
+    EXPECT_EQ(*res[1], 8);
+}
+
+TEST(TopKTest, Merge) {
+    const int THREADS = 4, SIZE = 20000, K = 100;
+    std::vector<int> vals;
+    Random *random = Random::getInstance();
+    for (int i = 0; i < SIZE; ++i) {
+        vals.push_back(random->nextInt(0, SIZE));
+    }
+    // Each thread selects from its own part of the stream
+    std::vector<TopK<int>> parts(THREADS, TopK<int>(K));
+    std::vector<std::thread> pool;
+    for (int t = 0; t < THREADS; ++t) {
+        pool.push_back(std::thread([&, t]() {
+            for (int i = t; i < SIZE; i += THREADS) {
+                parts[t].push(vals[i]);
+            }
+        }));
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+    TopK<int> topk(K);
+    for (const auto &p : parts) {
+        topk.merge(p);
+    }
+    std::sort(vals.begin(), vals.end(), std::greater<int>());
+    vals.resize(K);
+    EXPECT_EQ(topk.takeSorted(), vals);
+}